@@ -3,8 +3,12 @@
 // Orchestrates SMBus polling, extended status, UDP sender, and one-shot EEPROM
 // broadcast with strong bus-safety guarantees:
 //
-// - Each SMBus-using module (poller, smbus_ext, eeprom_min) uses the shared
-//   global lock and its own pacing. We just trigger their .loop() methods.
+// - SMBusSched owns the bus on its own pinned task. The poller and smbus_ext
+//   queue jobs from that task; eeprom_min queues from here. Jobs run under a
+//   global duty budget, inter-op gaps and backoff, so loop() never waits on
+//   the bus (breathers, idle-line spins and Wire timeouts all stay off it).
+// - Temp/fan changes arrive as a task notification + seqlock snapshot; only
+//   then is Cache_Manager updated (which is what UDPStat sends).
 // - Startup "grace" avoids poking the Xbox during boot.
 // - EEPROM broadcast is one-shot, after grace + WiFi + first good poll.
 // - Minimal serial prints to reduce timing noise.
@@ -17,7 +21,12 @@
 #include "led_stat.h"
 #include "smbus_ext.h"
 #include "eeprom_min.h"
-#include <Wire.h>
+#include "smbus_sched.h"
+#include "smbus_virtual.h"
+#include "smbus_sniff.h"
+#include "smbus_health.h"
+#include "udp_mux.h"
+#include "metrics.h"
 
 // ====== Hardware pins (set to your wiring) ======
 #ifndef I2C_SDA_PIN
@@ -27,6 +36,11 @@
 #define I2C_SCL_PIN 6
 #endif
 
+// ====== Bench mode: virtual console on the bus (see smbus_virtual.h) ======
+#ifndef SMBUS_VIRTUAL_PROFILE
+#define SMBUS_VIRTUAL_PROFILE 0   // 0=1.0 Conexant, 1=1.4 Focus, 2=1.6 Xcalibur
+#endif
+
 // ====== Startup grace (don’t touch SMBus during Xbox boot) ======
 #ifndef XBOX_BOOT_GRACE_MS
 #define XBOX_BOOT_GRACE_MS 8000UL  // 8s default; override if you want
@@ -39,6 +53,14 @@ static XboxSMBusStatus g_smbusStatus;
 static bool g_sawFirstGoodPoll = false;  // first successful poll gate for EEPROM
 static bool g_eeSent = false;            // one-shot EEPROM broadcast sent?
 
+// Runs on the SMBus task before every scheduler pass
+static void smbus_producers() {
+  if ((millis() - g_appStartMs) >= XBOX_BOOT_GRACE_MS) {
+    XboxSMBusPoll::tick();
+  }
+  SMBusExt::loop();
+}
+
 void setup() {
   LedStat::begin();
   LedStat::setStatus(LedStatus::Booting);
@@ -47,10 +69,20 @@ void setup() {
   delay(150); // let USB CDC settle a bit
 
   WiFiMgr::begin();
+  Metrics::begin();      // GET /metrics on the port-80 server
   Cache_Manager::begin();
+  XboxEEPROM::begin();   // warm boot: NVS snapshot, broadcast without SMBus reads
 
-  // Initialize SMBus users; they manage Wire/pacing/locks themselves
+#if SMBUS_PASSIVE_SNIFF
+  // Passive: only listen to the console's own traffic (zero bus load)
+  SMBusSniff::begin(I2C_SDA_PIN, I2C_SCL_PIN);
+#else
+  // Initialize SMBus users; the poller brings up SMBusSched (owns Wire)
   XboxSMBusPoll::begin(I2C_SDA_PIN, I2C_SCL_PIN);
+#if SMBUS_VIRTUAL_XBOX
+  SMBusSched::setBackend(SMBusVirtual::backend((SMBusVirtual::Profile)SMBUS_VIRTUAL_PROFILE));
+#endif
+#endif
   SMBusExt::begin();
 
   if (WiFiMgr::isConnected()) {
@@ -58,6 +90,13 @@ void setup() {
   }
 
   g_appStartMs = millis();
+
+  // Changed readings wake this (loop) task; then start the bus worker
+  XboxSMBusPoll::notifyOnChange(xTaskGetCurrentTaskHandle());
+#if !SMBUS_PASSIVE_SNIFF
+  SMBusSched::startTask(smbus_producers);
+#endif
+
   Serial.println("[Main] Type-D firmware started.");
 }
 
@@ -65,31 +104,27 @@ void loop() {
   // lightweight background services
   LedStat::loop();
   WiFiMgr::loop();
-  Cache_Manager::pollTitleUdp(); // Type-D app broadcaster
+  Metrics::loop();
 
   const bool xboxReady = (millis() - g_appStartMs) >= XBOX_BOOT_GRACE_MS;
 
-  // ===== SMBus temp/fan poller (module-paced & lock-protected) =====
-  // We call it every loop; it will self-throttle and take the lock when safe.
-  if (xboxReady) {
-    if (XboxSMBusPoll::poll(g_smbusStatus)) {
-      // Only update cache when a poll succeeds; avoids pushing stale/sentinel values.
-      Cache_Manager::updateFromSmbus(g_smbusStatus);
-      g_sawFirstGoodPoll = true;
-    }
+  // ===== SMBus temp/fan (SMBus task publishes, we just take the snapshot) =====
+  // Notified only when a value changed; avoids pushing stale/sentinel values.
+  if (ulTaskNotifyTake(pdTRUE, 0) > 0 && XboxSMBusPoll::poll(g_smbusStatus)) {
+    Cache_Manager::updateFromSmbus(g_smbusStatus);
+    g_sawFirstGoodPoll = true;
   }
 
-  // ===== Extended status (AV pack / encoder / resolution) =====
-  // Let it run independently; it does its own startup grace & pacing and uses the lock.
-  SMBusExt::loop();
-
 
   // ===== One-shot EEPROM broadcast =====
+  // (a snapshot restored from NVS is already being broadcast by tick();
+  //  this then only verifies it with one 16-byte identity read)
   // - after startup grace
   // - after WiFi connected
   // - after at least one good poll (ensures the bus is alive)
-  if (xboxReady && !g_eeSent && WiFiMgr::isConnected() && g_sawFirstGoodPoll) {
-    XboxEEPROM::broadcastOnce();  // internal lock + STOP-only reads + one-shot
+  // (not in passive mode: reading the EEPROM needs active transactions)
+  if (!SMBUS_PASSIVE_SNIFF && xboxReady && !g_eeSent && WiFiMgr::isConnected() && g_sawFirstGoodPoll) {
+    XboxEEPROM::broadcastOnce();  // queues STOP-only chunk reads; broadcasts when done
     g_eeSent = true;
   }
 
@@ -97,9 +132,12 @@ void loop() {
   if (WiFiMgr::isConnected()) {
     UDPStat::loop();
     XboxEEPROM::tick();
-  
+    SMBusHealth::loop();
   }
 
+  // ===== UDP: dispatch received datagrams (titles), flush everything queued =====
+  UDPMux::loop();
+
   // ===== Modest status print every 5s =====
   static unsigned long lastPrint = 0;
   if (millis() - lastPrint > 5000UL) {
@@ -111,7 +149,49 @@ void loop() {
                   WiFiMgr::isConnected() ? "on" : "off");
   }
 
+  // ===== Adaptive sampler counters every 60s =====
+  static unsigned long lastSmbusPrint = 0;
+  if (millis() - lastSmbusPrint > 60000UL) {
+    lastSmbusPrint = millis();
+    const XboxSMBusPoll::Stats ps = XboxSMBusPoll::getStats();
+    Serial.printf("[Main] SMBus reads=%lu err=%lu saved=%ld ext_saved=%lu int(ms) cpu=%lu board=%lu fan=%lu\n",
+                  (unsigned long)ps.reads, (unsigned long)ps.errors, (long)ps.readsSaved,
+                  (unsigned long)SMBusExt::readsSaved(),
+                  (unsigned long)ps.cpuIntervalMs, (unsigned long)ps.boardIntervalMs,
+                  (unsigned long)ps.fanIntervalMs);
+
+#if SMBUS_PASSIVE_SNIFF
+    const SMBusSniff::Stats sn = SMBusSniff::getStats();
+    Serial.printf("[Main] Sniff edges=%lu txn=%lu fed=%lu nack=%lu aborted=%lu sleeps=%lu\n",
+                  (unsigned long)sn.edges, (unsigned long)sn.transactions, (unsigned long)sn.fed,
+                  (unsigned long)sn.nacks, (unsigned long)sn.aborted, (unsigned long)sn.sleeps);
+#endif
+    const SMBusSched::Stats ss = SMBusSched::getStats();
+    const uint32_t up = ss.uptimeMs ? ss.uptimeMs : 1;
+    Serial.printf("[Main] SMBus duty=%lu.%lu%% tx/min=%lu first_ok=%lums ok=%lu fail=%lu exp=%lu busy=%lu recov=%lu\n",
+                  (unsigned long)(ss.busyUs / up / 10), (unsigned long)(ss.busyUs / up % 10),
+                  (unsigned long)((uint64_t)ss.transactions * 60000ULL / up),
+                  (unsigned long)ss.firstOkMs,
+                  (unsigned long)ss.jobsOk, (unsigned long)ss.jobsFailed, (unsigned long)ss.jobsExpired,
+                  (unsigned long)ss.busBusySkips, (unsigned long)ss.recoveries);
+    const UDPMux::Stats us = UDPMux::getStats();
+    Serial.printf("[Main] UDP sockets=%u rx=%lu unhandled=%lu tx=%lu coalesced=%lu dropped=%lu\n",
+                  (unsigned)us.sockets, (unsigned long)us.rxPackets, (unsigned long)us.rxUnhandled,
+                  (unsigned long)us.txDatagrams, (unsigned long)us.txCoalesced,
+                  (unsigned long)us.txDropped);
+  }
+
+  // 'H' on serial dumps the bus-health table; 'D' (passive mode) dumps the
+  // recorded edges for offline decoding
+  if (Serial.available() > 0) {
+    const int c = Serial.read();
+    if (c == 'H') SMBusHealth::dump(Serial);
+#if SMBUS_PASSIVE_SNIFF
+    if (c == 'D') SMBusSniff::dumpCapture(Serial);
+#endif
+  }
+
   // Light cooperative yield; lets WiFi/UDP run smoothly without jittering SMBus.
-  // (Avoid long blocking work here; all bus work happens inside modules with pacing.)
+  // (Avoid long blocking work here; all bus work happens on the SMBus task.)
   delay(1);
 }
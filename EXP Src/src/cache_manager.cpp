@@ -1,12 +1,33 @@
 #include "cache_manager.h"
 #include "xbox_smbus_poll.h"
-#include <WiFiUdp.h>
+#include "udp_mux.h"
 #include <cstring>
+#include <atomic>
 
-static XboxStatus cache;
+#ifndef TITLE_UDP_PORT
+#define TITLE_UDP_PORT 50506   // Type-D app title broadcaster (shared with EE:)
+#endif
+
+static XboxStatus cache;                 // writer's working copy (setters)
+
+// ---------- Published snapshot (seqlock: setters write, any task reads) ----------
+static std::atomic<uint32_t> g_pub_seq(0); // odd while a write is in progress
+static XboxStatus g_pub;
+
+static void publish() {
+    const uint32_t s = g_pub_seq.load(std::memory_order_relaxed);
+    g_pub_seq.store(s + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    g_pub = cache;
+    g_pub_seq.store(s + 2, std::memory_order_release);
+}
+
+static void on_title_udp(const char* msg, size_t len, const IPAddress& from, void* ctx);
 
 void Cache_Manager::begin() {
     reset();
+    // Any payload on the port is a title unless a longer prefix claims it
+    UDPMux::on(TITLE_UDP_PORT, "", on_title_udp);
 }
 
 void Cache_Manager::reset() {
@@ -14,31 +35,38 @@ void Cache_Manager::reset() {
     cache.cpuTemp = -1000;
     cache.ambientTemp = -1000;
     memset(cache.currentApp, 0, sizeof(cache.currentApp));
+    publish();
 }
 
 void Cache_Manager::setFanSpeed(int percent) {
     if (percent < 0) percent = 0;
     if (percent > 100) percent = 100;
+    if (cache.fanSpeed == percent) return;
     cache.fanSpeed = percent;
+    publish();
 }
 
 void Cache_Manager::setCpuTemp(int celsius) {
     // Accept only valid range for Xbox (avoid garbage)
-    if (celsius > 0 && celsius < 100) {
+    if (celsius > 0 && celsius < 100 && cache.cpuTemp != celsius) {
         cache.cpuTemp = celsius;
+        publish();
     }
 }
 
 void Cache_Manager::setAmbientTemp(int celsius) {
-    if (celsius > 0 && celsius < 100) {
+    if (celsius > 0 && celsius < 100 && cache.ambientTemp != celsius) {
         cache.ambientTemp = celsius;
+        publish();
     }
 }
 
 void Cache_Manager::setCurrentApp(const char *name) {
     if (name && *name) {
+        if (strncmp(cache.currentApp, name, sizeof(cache.currentApp) - 1) == 0) return;
         strncpy(cache.currentApp, name, sizeof(cache.currentApp) - 1);
         cache.currentApp[sizeof(cache.currentApp) - 1] = 0;
+        publish();
         //Serial.printf("[CacheMgr] App name updated: %s\n", cache.currentApp);
     }
 }
@@ -51,21 +79,27 @@ void Cache_Manager::updateFromSmbus(const XboxSMBusStatus& st) {
     // setCurrentApp(st.app); // Only if app name is available in st
 }
 
-const XboxStatus& Cache_Manager::getStatus() {
-    return cache;
+uint32_t Cache_Manager::getSnapshot(XboxStatus& out) {
+    uint32_t s1, s2;
+    do {
+        s1 = g_pub_seq.load(std::memory_order_acquire);
+        if (s1 & 1) continue;                    // writer mid-update
+        out = g_pub;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        s2 = g_pub_seq.load(std::memory_order_relaxed);
+        if (s1 == s2) break;
+    } while (true);
+    return s1 >> 1;
 }
 
-static WiFiUDP g_appUdp;
-static bool g_udpBound = false;
-
-// Non-blocking single-shot read helper
-static bool recv_line_udp(WiFiUDP& u, char* buf, size_t buflen) {
-    int pktLen = u.parsePacket();
-    if (pktLen <= 0) return false;
-    int n = u.read(buf, buflen - 1);
-    if (n < 0) return false;
-    buf[n] = 0;
-    return true;
+uint32_t Cache_Manager::generation() {
+    return g_pub_seq.load(std::memory_order_acquire) >> 1;
+}
+
+XboxStatus Cache_Manager::getStatus() {
+    XboxStatus st;
+    getSnapshot(st);
+    return st;
 }
 
 // Very tolerant parser: accept either "APP:Name|TID:0xXXXXXX" or just raw title
@@ -85,20 +119,12 @@ static void parse_app_payload(const char* in, char* outName32) {
     outName32[31] = 0;
 }
 
-void Cache_Manager::pollTitleUdp() {
-    if (!g_udpBound) {
-        // Bind once; failure is non-fatal
-        if (g_appUdp.begin(50506)) g_udpBound = true;
-        else return;
-    }
-
-    char buf[256];
-    if (recv_line_udp(g_appUdp, buf, sizeof(buf))) {
-        char name[32] = {0};
-        parse_app_payload(buf, name);
-        if (name[0]) {
-            setCurrentApp(name);
-        //    Serial.printf("[CacheMgr] Title via UDP: %s\n", name);
-        }
+// UDPMux handler (loop task)
+static void on_title_udp(const char* msg, size_t, const IPAddress&, void*) {
+    char name[32] = {0};
+    parse_app_payload(msg, name);
+    if (name[0]) {
+        Cache_Manager::setCurrentApp(name);
+    //    Serial.printf("[CacheMgr] Title via UDP: %s\n", name);
     }
 }
@@ -18,10 +18,13 @@ namespace Cache_Manager {
     void setAmbientTemp(int celsius);
     void setCurrentApp(const char *name);
 
-    // NOTE: remove 'static' here so we can link the definition in the .cpp
-    void pollTitleUdp();
+    // Setters run on one task (the loop) and publish a new generation only
+    // when a value actually changed. Readers on any task get a consistent
+    // copy; the return value is that copy's generation.
+    uint32_t getSnapshot(XboxStatus& out);
+    uint32_t generation();        // compare to detect changes without copying
 
-    const XboxStatus& getStatus();
+    XboxStatus getStatus();       // getSnapshot() by value
     void reset();
     void updateFromSmbus(const XboxSMBusStatus& st);
 }
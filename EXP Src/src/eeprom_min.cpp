@@ -1,6 +1,7 @@
 #include "eeprom_min.h"
-#include <WiFiUdp.h>
-#include <Wire.h>
+#include "smbus_sched.h"
+#include "udp_mux.h"
+#include <Preferences.h>
 #include <base64.h>      // ESP32 core
 #include <mbedtls/md.h>  // for HMAC-SHA1
 
@@ -13,42 +14,23 @@
 #define EEPROM_REBROADCAST_MS 10000UL
 #endif
 
-static WiFiUDP eeUdp;
-
-// ---- share the global SMBus lock (defined in xbox_smbus_poll.cpp) ----
-extern volatile bool g_smbus_locked;
-static inline bool try_lock_smbus() {
-  noInterrupts();
-  bool ok = !g_smbus_locked;
-  if (ok) g_smbus_locked = true;
-  interrupts();
-  return ok;
-}
-static inline void unlock_smbus() {
-  noInterrupts();
-  g_smbus_locked = false;
-  interrupts();
-}
-// Bounded wait for the lock (so we don't give up just because poller was mid-read)
-static bool lock_with_timeout(uint32_t ms_timeout = 500) {
-  uint32_t t0 = millis();
-  do {
-    if (try_lock_smbus()) return true;
-    delay(2);
-  } while (millis() - t0 < ms_timeout);
-  return false;
-}
+// One scheduler job per chunk keeps each bus hold short
+#ifndef EEPROM_CHUNK_BYTES
+#define EEPROM_CHUNK_BYTES 16
+#endif
+
+// Warm-boot snapshot in NVS, verified by a one-chunk identity probe
+// (serial number + start of MAC) instead of a full 256-byte re-read
+#define EEPROM_NVS_NS        "xee"
+#define EEPROM_SNAPSHOT_VER  1
+#define EEPROM_ID_OFF        0x34
+#define EEPROM_ID_LEN        16
 
 namespace XboxEEPROM {
 
-  static bool begun = false;
-
-  static void ensureUdp() {
-    if (!begun) {
-      eeUdp.begin(EEPROM_UDP_PORT);
-      begun = true;
-    }
-  }
+  // EE: packets share the title port; claim them so our own (or another
+  // board's) broadcasts are never parsed as a title
+  static void on_ee_udp(const char*, size_t, const IPAddress&, void*) {}
 
   // -------- helpers (local only) ----------
   static inline char nyb_to_hex(uint8_t v) {
@@ -95,46 +77,17 @@ namespace XboxEEPROM {
   }
 
   // -------- 24C02 read helpers (STOP-only, explicit) ------------
-  // NOTE: We acquire the global SMBus lock before doing any reads.
-  static inline void i2c_breather() { delayMicroseconds(200); }
-
+  // NOTE: only valid inside an SMBusSched sequence job (the scheduler owns Wire).
   int readBlock(uint8_t eeOffset, uint8_t *out, size_t len) {
-    if (!out || len == 0) return -1;
-
-    // Set internal address pointer (use STOP at the end)
-    Wire.beginTransmission(XboxEEPROM::I2C_ADDR);
-    Wire.write(eeOffset);
-    if (Wire.endTransmission(true) != 0)  // STOP (no repeated-start)
-      return -1;
-
-    size_t got = 0;
-    while (got < len) {
-      uint8_t chunk = (uint8_t)((len - got) > 32 ? 32 : (len - got));
-      // Explicit STOP at end of each chunk
-      uint8_t n = Wire.requestFrom((int)XboxEEPROM::I2C_ADDR, (int)chunk, (int)true);
-      if (n == 0) return -1;
-      for (uint8_t i = 0; i < n && got < len; ++i) {
-        if (!Wire.available()) return -1;
-        out[got++] = Wire.read();
-      }
-      i2c_breather(); // be a good bus citizen between chunks
-    }
-    return 0;
+    return SMBusSched::readBlock(XboxEEPROM::I2C_ADDR, eeOffset, out, len);
   }
 
   int readAll(uint8_t buf[256]) {
     if (!buf) return -1;
-
-    // Entire EEPROM read under the shared SMBus lock
-    if (!lock_with_timeout()) return -1;  // couldn't get the bus; fail safely
-
-    int rc = 0;
-    for (uint16_t off = 0; off < 256; off += 16) {
-      if (readBlock((uint8_t)off, buf + off, 16) != 0) { rc = -1; break; }
+    for (uint16_t off = 0; off < 256; off += EEPROM_CHUNK_BYTES) {
+      if (readBlock((uint8_t)off, buf + off, EEPROM_CHUNK_BYTES) != 0) return -1;
     }
-
-    unlock_smbus();
-    return rc;
+    return 0;
   }
 
   // --- tiny RC4 ---
@@ -183,125 +136,258 @@ namespace XboxEEPROM {
   static const int LEN_CHECKSUM  = 0x14;
   static const uint8_t kFactoryLens[2] = { 0x1C, 0x18 };  // try 28 then 24 bytes
 
-  // ---------- one-time ROM + HDD cache for broadcast ----------
-  static bool    s_have_rom  = false;
-  static uint8_t s_rom[256];
-  static bool    s_have_hdd  = false;
-  static char    s_hdd_hex[33] = {0};
+  // ---------- decoded snapshot ----------
+  struct Snapshot {
+    uint8_t rom[256];
+    bool    haveHdd;
+    int8_t  keyRev;        // index into the key table, -1 = none matched
+    char    hdd[33];
+    char    sn[13];
+    char    mac[18];
+    char    region[8];
+  };
+
+  // s_cur belongs to the loop (broadcasts); s_stage to the SMBus task (reads,
+  // decode). tick() adopts a finished stage, so the two never share memory.
+  static Snapshot s_cur;
+  static Snapshot s_stage;
+  static volatile bool s_have_rom  = false;  // s_cur valid
+  static volatile bool s_stage_ready = false;
 
   // Cached Base64 and timing for periodic rebroadcast
-  static String   s_raw_b64;            // Base64 of s_rom (prepared once)
+  static String   s_raw_b64;            // Base64 of s_cur.rom (prepared once)
   static uint32_t s_last_bcast = 0;     // last broadcast timestamp
-  static bool     s_read_done  = false; // we performed the one-time read (never touch SMBus again)
+  static bool     s_from_nvs   = false; // s_cur came from NVS; not yet verified
+  static volatile bool s_read_done = false; // one-time read/verify finished (never touch SMBus again)
+  static volatile bool s_bcast_due = false; // new snapshot; loop sends the first broadcast
+  static volatile bool s_err_due   = false; // read failed; loop sends EE:ERR
+  static volatile bool s_reading   = false; // chunk jobs in flight
+  static bool     s_read_wanted = false;  // broadcastOnce() asked for the read; tick() resubmits
+  static uint16_t s_read_off   = 0;     // next chunk offset
 
   // -------- internal helper: broadcast from cached data only ------------
   static void send_broadcasts_from_cache() {
     if (!s_have_rom) return;     // nothing to send yet
-    ensureUdp();
 
     // Prepare cached Base64 once
     if (s_raw_b64.length() == 0) {
-      s_raw_b64 = base64::encode(s_rom, 256);
+      s_raw_b64 = base64::encode(s_cur.rom, 256);
     }
 
-    const uint8_t* rom = s_rom;
+    const uint8_t* rom = s_cur.rom;
 
     // Optional debug prints trimmed down
     for (int i=0;i<12;i++) { Serial.printf("%02X ", rom[0x14+i]); } Serial.println();
     for (int i=0;i<12;i++) { Serial.printf("%02X ", rom[0x09+i]); } Serial.println();
 
     // RAW packet
-    eeUdp.beginPacket(IPAddress(255,255,255,255), EEPROM_UDP_PORT);
-    eeUdp.print("EE:RAW=");
-    eeUdp.print(s_raw_b64);
-    eeUdp.endPacket();
+    const String raw = String("EE:RAW=") + s_raw_b64;
+    UDPMux::send(EEPROM_UDP_PORT, raw);
 
     // HDD packet
-    if (s_have_hdd) {
-      eeUdp.beginPacket(IPAddress(255,255,255,255), EEPROM_UDP_PORT);
-      eeUdp.print("EE:HDD=");
-      eeUdp.print(s_hdd_hex);
-      eeUdp.endPacket();
+    if (s_cur.haveHdd) {
+      UDPMux::send(EEPROM_UDP_PORT, String("EE:HDD=") + s_cur.hdd);
       Serial.println("[EE] HDD packet broadcast (EE:HDD=...)");
     }
 
-    // Duplicate RAW (preserved behavior)
-    eeUdp.beginPacket(IPAddress(255,255,255,255), EEPROM_UDP_PORT);
-    eeUdp.print("EE:RAW=");
-    eeUdp.print(s_raw_b64);
-    eeUdp.endPacket();
+    // Duplicate RAW (preserved behavior; unkeyed so it is not coalesced)
+    UDPMux::send(EEPROM_UDP_PORT, raw);
 
     // Labeled packet (optional)
-    if (s_have_hdd) {
-      char snP[13];  cleanSerial(&rom[0x34], 12, snP);
-      char macP[18]; macToStr(&rom[0x40], macP);
-      const char* regP = regionName(rom[0x58]);
-
-      eeUdp.beginPacket(IPAddress(255,255,255,255), EEPROM_UDP_PORT);
-      eeUdp.print("EE:SN=");  eeUdp.print(snP);
-      eeUdp.print("|MAC=");   eeUdp.print(macP);
-      eeUdp.print("|REG=");   eeUdp.print(regP);
-      eeUdp.print("|HDD=");   eeUdp.print(s_hdd_hex);
-      eeUdp.print("|RAW=");   eeUdp.print(s_raw_b64);
-      eeUdp.endPacket();
+    if (s_cur.haveHdd) {
+      String lab = "EE:SN=";
+      lab += s_cur.sn;
+      lab += "|MAC="; lab += s_cur.mac;
+      lab += "|REG="; lab += s_cur.region;
+      lab += "|HDD="; lab += s_cur.hdd;
+      lab += "|RAW="; lab += s_raw_b64;
+      UDPMux::send(EEPROM_UDP_PORT, lab);
     }
   }
 
-  // -------- one-shot read + immediate broadcast (subsequent calls just rebroadcast) ------------
-  void broadcastOnce() {
-    ensureUdp();
-
-    // One-time SMBus read & decrypt/cache
-    if (!s_read_done) {
-      if (!s_have_rom) {
-        if (readAll(s_rom) != 0) {
-          Serial.println("[EE] readAll FAILED");
-          eeUdp.beginPacket(IPAddress(255,255,255,255), EEPROM_UDP_PORT);
-          eeUdp.print("EE:ERR=READ_FAIL");
-          eeUdp.endPacket();
-          s_read_done = true; // prevent retrying I2C forever
-          return;
-        }
-
-        // Decrypt HDD key once and cache result (CPU-only; no SMBus)
-        const uint8_t* chk = &s_rom[OFF_CHECKSUM];
-        const uint8_t* candidates[3] = { EEPROM_KEY_V10, EEPROM_KEY_V11_14, EEPROM_KEY_V16 };
-        // const char*    cand_name [3] = { "v1.0", "v1.1-1.4", "v1.6/1.6b" };
-
-        for (int k = 0; k < 3 && !s_have_hdd; ++k) {
-          uint8_t rc4key[20];
-          if (!hmac_sha1(candidates[k], 16, chk, LEN_CHECKSUM, rc4key)) continue;
-
-          uint8_t fac[LEN_FACTORY];
-          memcpy(fac, &s_rom[OFF_FACTORY], LEN_FACTORY);
-          rc4_state st; rc4_init(&st, rc4key, sizeof(rc4key));
-
-          // try both lengths
-          for (int li = 0; li < 2 && !s_have_hdd; ++li) {
-            const int fac_len = kFactoryLens[li];
-            uint8_t tmp[LEN_FACTORY];
-            memcpy(tmp, fac, LEN_FACTORY);
-            rc4_state st2 = st;           // copy state for fresh decrypt per length
-            rc4_crypt(&st2, tmp, fac_len);
-
-            uint8_t tmpHmac[20];
-            if (!hmac_sha1(candidates[k], 16, tmp, fac_len, tmpHmac)) continue;
-            if (memcmp(tmpHmac, chk, LEN_CHECKSUM) != 0) continue;
-
-            toHexUpper(&tmp[8], 16, s_hdd_hex);
-            s_have_hdd = true;
-          }
-        }
-
-        s_have_rom = true; // mark snapshot complete
+  // -------- decrypt HDD key once and cache result (CPU-only; no SMBus) ------------
+  static void decode_rom(Snapshot &snap) {
+    const uint8_t* chk = &snap.rom[OFF_CHECKSUM];
+    const uint8_t* candidates[3] = { EEPROM_KEY_V10, EEPROM_KEY_V11_14, EEPROM_KEY_V16 };
+    // const char*    cand_name [3] = { "v1.0", "v1.1-1.4", "v1.6/1.6b" };
+
+    snap.haveHdd = false;
+    snap.keyRev  = -1;
+    snap.hdd[0]  = '\0';
+
+    for (int k = 0; k < 3 && !snap.haveHdd; ++k) {
+      uint8_t rc4key[20];
+      if (!hmac_sha1(candidates[k], 16, chk, LEN_CHECKSUM, rc4key)) continue;
+
+      uint8_t fac[LEN_FACTORY];
+      memcpy(fac, &snap.rom[OFF_FACTORY], LEN_FACTORY);
+      rc4_state st; rc4_init(&st, rc4key, sizeof(rc4key));
+
+      // try both lengths
+      for (int li = 0; li < 2 && !snap.haveHdd; ++li) {
+        const int fac_len = kFactoryLens[li];
+        uint8_t tmp[LEN_FACTORY];
+        memcpy(tmp, fac, LEN_FACTORY);
+        rc4_state st2 = st;           // copy state for fresh decrypt per length
+        rc4_crypt(&st2, tmp, fac_len);
+
+        uint8_t tmpHmac[20];
+        if (!hmac_sha1(candidates[k], 16, tmp, fac_len, tmpHmac)) continue;
+        if (memcmp(tmpHmac, chk, LEN_CHECKSUM) != 0) continue;
+
+        toHexUpper(&tmp[8], 16, snap.hdd);
+        snap.haveHdd = true;
+        snap.keyRev  = (int8_t)k;
       }
+    }
 
-      // Prepare cached Base64 once (optional; helper also ensures it)
-      if (s_raw_b64.length() == 0) {
-        s_raw_b64 = base64::encode(s_rom, 256);
-      }
+    cleanSerial(&snap.rom[0x34], 12, snap.sn);
+    macToStr(&snap.rom[0x40], snap.mac);
+    strlcpy(snap.region, regionName(snap.rom[0x58]), sizeof(snap.region));
+  }
+
+  // -------- NVS snapshot ------------
+  static void save_snapshot(const Snapshot &snap) {
+    Preferences prefs;
+    if (!prefs.begin(EEPROM_NVS_NS, false)) return;
+    // Invalidate first: a reset midway through a re-save must not leave the
+    // old "ver" vouching for a half-written record
+    prefs.remove("ver");
+    prefs.putBytes("rom", snap.rom, sizeof(snap.rom));
+    prefs.putChar("rev", snap.keyRev);
+    prefs.putString("hdd", snap.haveHdd ? snap.hdd : "");
+    prefs.putString("sn", snap.sn);
+    prefs.putString("mac", snap.mac);
+    prefs.putString("reg", snap.region);
+    prefs.putUChar("ver", EEPROM_SNAPSHOT_VER);   // last: marks the record complete
+    prefs.end();
+    Serial.println("[EE] Snapshot saved to NVS");
+  }
 
-      s_read_done = true;  // never touch SMBus again
+  static bool load_snapshot(Snapshot &snap) {
+    Preferences prefs;
+    if (!prefs.begin(EEPROM_NVS_NS, true)) return false;
+    bool ok = prefs.getUChar("ver", 0) == EEPROM_SNAPSHOT_VER &&
+              prefs.getBytes("rom", snap.rom, sizeof(snap.rom)) == sizeof(snap.rom);
+    if (ok) {
+      snap.keyRev = prefs.getChar("rev", -1);
+      strlcpy(snap.hdd,    prefs.getString("hdd", "").c_str(), sizeof(snap.hdd));
+      strlcpy(snap.sn,     prefs.getString("sn", "").c_str(),  sizeof(snap.sn));
+      strlcpy(snap.mac,    prefs.getString("mac", "").c_str(), sizeof(snap.mac));
+      strlcpy(snap.region, prefs.getString("reg", "").c_str(), sizeof(snap.region));
+      snap.haveHdd = snap.hdd[0] != '\0';
+    }
+    prefs.end();
+    return ok;
+  }
+
+  // Drop the completion marker so a reset mid re-read can't resurrect the old record
+  static void invalidate_snapshot() {
+    Preferences prefs;
+    if (!prefs.begin(EEPROM_NVS_NS, false)) return;
+    prefs.remove("ver");
+    prefs.end();
+  }
+
+  // -------- chunked read through the SMBus scheduler ------------
+  // Completions run on the SMBus task; all UDP output stays in tick().
+  static void submit_chunk();
+
+  static void read_failed() {
+    Serial.println("[EE] readAll FAILED");
+    s_err_due   = true;
+    s_reading   = false;
+    s_read_done = true; // prevent retrying I2C forever
+  }
+
+  static void on_chunk(void *, SMBusSched::Result res, const uint8_t *data, uint8_t len) {
+    if (res != SMBusSched::RES_OK || len != EEPROM_CHUNK_BYTES) { read_failed(); return; }
+
+    memcpy(&s_stage.rom[s_read_off], data, len);
+    s_read_off += len;
+    if (s_read_off < 256) { submit_chunk(); return; }
+
+    decode_rom(s_stage);
+    save_snapshot(s_stage);
+    s_stage_ready = true;  // tick() adopts it and broadcasts
+    s_reading     = false;
+    s_read_done   = true;  // never touch SMBus again
+  }
+
+  static void submit_chunk() {
+    SMBusSched::Job j;
+    j.addr    = XboxEEPROM::I2C_ADDR;
+    j.reg     = (uint8_t)s_read_off;
+    j.len     = EEPROM_CHUNK_BYTES;
+    j.prio    = SMBusSched::PRIO_LOW;
+    j.retries = 2;
+    j.done    = on_chunk;
+    if (!SMBusSched::submit(j)) {
+      s_reading  = false;           // table full; tick() restarts the read
+      s_read_off = 0;
+    }
+  }
+
+  // Warm boot: one chunk decides whether the NVS snapshot is this console's
+  static void on_identity(void *, SMBusSched::Result res, const uint8_t *data, uint8_t len) {
+    if (res != SMBusSched::RES_OK || len != EEPROM_ID_LEN) { read_failed(); return; }
+
+    if (memcmp(data, &s_cur.rom[EEPROM_ID_OFF], EEPROM_ID_LEN) == 0) {
+      Serial.println("[EE] NVS snapshot verified (no full read)");
+      s_reading   = false;
+      s_read_done = true;
+      return;
+    }
+
+    // Different EEPROM (board moved/console swapped): the snapshot belongs to
+    // another console, so stop broadcasting it before the full re-read + decode
+    Serial.println("[EE] Identity mismatch; re-reading EEPROM");
+    s_have_rom = false;           // tick() drops the cached Base64
+    s_from_nvs = false;
+    invalidate_snapshot();
+    s_read_off = 0;
+    submit_chunk();
+  }
+
+  static void submit_identity() {
+    SMBusSched::Job j;
+    j.addr    = XboxEEPROM::I2C_ADDR;
+    j.reg     = EEPROM_ID_OFF;
+    j.len     = EEPROM_ID_LEN;
+    j.prio    = SMBusSched::PRIO_LOW;
+    j.retries = 2;
+    j.done    = on_identity;
+    if (!SMBusSched::submit(j)) s_reading = false;   // table full; tick() retries
+  }
+
+  // -------- warm boot: publish the NVS snapshot, no SMBus/crypto ------------
+  void begin() {
+    UDPMux::on(EEPROM_UDP_PORT, "EE:", on_ee_udp);
+    if (load_snapshot(s_cur)) {
+      s_raw_b64   = base64::encode(s_cur.rom, 256);
+      s_from_nvs  = true;
+      s_have_rom  = true;
+      s_bcast_due = true;     // first tick() with WiFi broadcasts it
+      Serial.printf("[EE] Snapshot loaded from NVS (key rev %d)\n", (int)s_cur.keyRev);
+    }
+  }
+
+  // Queue the one-time verify/read (loop task; completions on the SMBus task)
+  static void start_read() {
+    s_reading = true;
+    s_read_off = 0;
+    if (s_from_nvs) submit_identity();
+    else            submit_chunk();
+  }
+
+  // -------- one-shot read + broadcast (subsequent calls just rebroadcast) ------------
+  void broadcastOnce() {
+    if (!s_read_done) {
+      // tick() broadcasts once the read completes, and resubmits it if the
+      // scheduler's table was full (the sketch calls this only once)
+      s_read_wanted = true;
+      if (!s_reading) start_read();
+      if (!s_have_rom) return;
     }
 
     // Immediate broadcast using cached data
@@ -311,9 +397,27 @@ namespace XboxEEPROM {
 
   // -------- periodic rebroadcast (call from loop()) ------------
   void tick() {
-    if (!s_have_rom) return;  // nothing cached yet (read failed or not run)
+    if (s_err_due) {
+      s_err_due = false;
+      UDPMux::send(EEPROM_UDP_PORT, "EE:ERR=READ_FAIL", 16);
+    }
+    if (s_stage_ready) {
+      // Adopt the SMBus task's finished read (it no longer touches s_stage)
+      s_cur = s_stage;
+      s_raw_b64 = base64::encode(s_cur.rom, 256);
+      s_from_nvs  = false;
+      s_have_rom  = true;
+      s_bcast_due = true;
+      s_stage_ready = false;
+    }
+    if (s_read_wanted && !s_read_done && !s_reading) start_read();
+    if (!s_have_rom) {        // nothing cached yet, or the snapshot was another console's
+      if (s_raw_b64.length()) s_raw_b64 = String();
+      return;
+    }
     const uint32_t now = millis();
-    if (now - s_last_bcast >= EEPROM_REBROADCAST_MS) {
+    if (s_bcast_due || now - s_last_bcast >= EEPROM_REBROADCAST_MS) {
+      s_bcast_due = false;
       send_broadcasts_from_cache();
       s_last_bcast = now;
     }
@@ -11,12 +11,20 @@ namespace XboxEEPROM {
   static const uint8_t I2C_ADDR = 0x54;
 
   // Read `len` bytes starting at `eeOffset` into `out`. Returns 0 on success.
+  // Only valid inside an SMBusSched sequence job (the scheduler owns Wire).
   int readBlock(uint8_t eeOffset, uint8_t *out, size_t len);
 
   // Read full 256-byte EEPROM into `buf[256]`. Returns 0 on success.
+  // Only valid inside an SMBusSched sequence job.
   int readAll(uint8_t buf[256]);
 
-  // Send one-shot UDP broadcast (uses cached data after first read).
+  // Load the NVS snapshot from a previous boot (if any) so tick() can
+  // broadcast it right away with no SMBus traffic. Call once from setup().
+  void begin();
+
+  // First call queues the one-time read (or, after begin() found a snapshot,
+  // a single 16-byte identity check; full re-read only on mismatch) (low-priority scheduler jobs) and the
+  // broadcast follows when it completes; later calls rebroadcast the cache.
   void broadcastOnce();
 
   // Periodic rebroadcast from cached EEPROM/HDD data; call regularly (e.g., from loop()).
@@ -0,0 +1,120 @@
+// i2c_decoder.cpp — see i2c_decoder.h (no Arduino dependencies)
+
+#include "i2c_decoder.h"
+#include <string.h>
+
+void I2CDecoder::reset() {
+  memset(&_stats, 0, sizeof(_stats));
+  _sda = _scl = true;
+  _phase = IDLE;
+  _shift = _bits = 0;
+  _n = 0;
+  _haveReg = false;
+}
+
+void I2CDecoder::feed(bool sda, bool scl) {
+  if (sda == _sda && scl == _scl) return;
+
+  if (scl && _scl && sda != _sda) {
+    // SDA moved while SCL high: START / STOP
+    _sda = sda;
+    if (!sda) onStart(); else onStop();
+    return;
+  }
+
+  const bool rising = scl && !_scl;
+  _sda = sda;
+  _scl = scl;
+  if (rising) onBit(sda);
+}
+
+void I2CDecoder::onStart() {
+  if (_phase == ADDR || _phase == DATA) endFrame(false);   // repeated START
+  _stats.starts++;
+  _phase = ADDR;
+  _shift = _bits = 0;
+  _n = 0;
+}
+
+void I2CDecoder::onStop() {
+  if (_phase == ADDR || _phase == DATA) endFrame(true);
+  else if (_phase != DONE) _haveReg = false;
+  _phase = IDLE;
+}
+
+void I2CDecoder::onBit(bool bit) {
+  if (_phase != ADDR && _phase != DATA) return;
+
+  if (_bits < 8) {
+    _shift = (uint8_t)((_shift << 1) | (bit ? 1 : 0));
+    _bits++;
+    return;
+  }
+
+  // 9th clock: ACK (low) / NACK (high)
+  const bool ack = !bit;
+  _bits = 0;
+
+  if (_phase == ADDR) {
+    _stats.frames++;
+    _addr = (uint8_t)(_shift >> 1);
+    _read = (_shift & 1) != 0;
+    if (!ack) {                       // nobody home
+      _stats.nacks++;
+      _haveReg = false;
+      _phase = DONE;
+      return;
+    }
+    _phase = DATA;
+    return;
+  }
+
+  if (_n < sizeof(_buf)) _buf[_n++] = _shift;
+  // In a read, the master NACKs the last byte: frame data is complete.
+  // In a write, a NACK means the slave refused; STOP follows either way.
+  if (!ack) endFrame(false);
+}
+
+void I2CDecoder::endFrame(bool stop) {
+  if (_phase == DONE) return;
+  (void)stop;
+
+  // The clock that sets up a STOP / repeated START reads as one stray bit;
+  // anything longer is a partial byte (glitch or missed edges).
+  if (_bits > 1) {
+    _stats.aborted++;
+    _haveReg = false;
+    _phase = DONE;
+    return;
+  }
+
+  if (!_read) {
+    if (_n == 1) {
+      // register pointer for a following read (STOP-only or repeated-start)
+      _haveReg = true;
+      _regAddr = _addr;
+      _reg = _buf[0];
+    } else if (_n > 1 && _sink) {
+      I2CTransaction t;
+      t.addr  = _addr;
+      t.reg   = _buf[0];
+      t.len   = (uint8_t)(_n - 1);
+      t.write = true;
+      memcpy(t.data, &_buf[1], t.len);
+      _stats.transactions++;
+      _sink(t, _ctx);
+      _haveReg = false;
+    }
+  } else if (_n > 0 && _haveReg && _regAddr == _addr) {
+    I2CTransaction t;
+    t.addr  = _addr;
+    t.reg   = _reg;
+    t.len   = _n > sizeof(t.data) ? (uint8_t)sizeof(t.data) : _n;
+    t.write = false;
+    memcpy(t.data, _buf, t.len);
+    _stats.transactions++;
+    if (_sink) _sink(t, _ctx);
+    _haveReg = false;
+  }
+  _phase = DONE;
+}
@@ -0,0 +1,69 @@
+// i2c_decoder.h
+//
+// Software I2C/SMBus frame decoder fed with SDA/SCL line levels.
+// Pure C++ (no Arduino headers) so recorded captures can be replayed on a PC:
+// compile i2c_decoder.cpp, call feed() for each "<sda> <scl>" sample from
+// SMBusSniff::dumpCapture(), and check the transactions that come out.
+//
+// Recognises the two read shapes the Xbox and this board use:
+//   START addrW reg STOP START addrR data.. STOP     (STOP-only)
+//   START addrW reg RSTART addrR data.. STOP        (repeated-start)
+// Multi-byte writes are reported as writes (reg = first byte).
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+struct I2CTransaction {
+  uint8_t addr;        // 7-bit
+  uint8_t reg;
+  uint8_t data[32];
+  uint8_t len;
+  bool    write;       // true: data are bytes written after reg
+};
+
+class I2CDecoder {
+public:
+  typedef void (*Sink)(const I2CTransaction &t, void *ctx);
+
+  struct Stats {
+    uint32_t starts;
+    uint32_t frames;        // address phases completed
+    uint32_t transactions;  // reported to the sink
+    uint32_t nacks;         // address not acknowledged
+    uint32_t aborted;       // frame cut short (glitch / missed edges)
+  };
+
+  explicit I2CDecoder(Sink sink = nullptr, void *ctx = nullptr) : _sink(sink), _ctx(ctx) { reset(); }
+
+  void setSink(Sink sink, void *ctx) { _sink = sink; _ctx = ctx; }
+
+  // Feed one sample; only level changes matter, repeats are cheap
+  void feed(bool sda, bool scl);
+
+  void reset();
+  const Stats &stats() const { return _stats; }
+
+private:
+  enum Phase : uint8_t { IDLE, ADDR, DATA, DONE };
+
+  void onStart();
+  void onStop();
+  void onBit(bool bit);
+  void endFrame(bool stop);
+
+  Sink   _sink;
+  void  *_ctx;
+  Stats  _stats;
+
+  bool    _sda = true, _scl = true;
+  Phase   _phase = IDLE;
+  uint8_t _shift = 0, _bits = 0;
+  uint8_t _addr = 0;
+  bool    _read = false;
+  uint8_t _buf[33];              // write: reg + up to 32 bytes; read: data
+  uint8_t _n = 0;
+
+  // register pointer left by the last write-of-one-byte, for the next read
+  bool    _haveReg = false;
+  uint8_t _regAddr = 0, _reg = 0;
+};
@@ -0,0 +1,183 @@
+// metrics.cpp
+
+#include "metrics.h"
+#include "wifimgr.h"
+#include "smbus_sched.h"
+#include "smbus_health.h"
+#include "xbox_smbus_poll.h"
+#include "udp_mux.h"
+#include <ESPAsyncWebServer.h>
+#include <WiFi.h>
+#include <esp_heap_caps.h>
+
+#define METRICS_LOOP_BOUNDS 9
+
+namespace Metrics {
+
+std::atomic<uint32_t> g_counters[COUNTER_COUNT];
+
+static const uint32_t kLoopBoundsUs[METRICS_LOOP_BOUNDS] = {
+  250, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000
+};
+static std::atomic<uint32_t> s_loop_bucket[METRICS_LOOP_BOUNDS + 1];   // last = +Inf
+static std::atomic<uint64_t> s_loop_sum_us{0};
+static uint32_t s_last_loop_us = 0;
+
+static bool     s_was_connected = false;
+static bool     s_ever_connected = false;
+static std::atomic<uint32_t> s_reconnects{0};
+
+void loop() {
+  const uint32_t nowUs = micros();
+  if (s_last_loop_us) {
+    const uint32_t us = nowUs - s_last_loop_us;
+    uint8_t b = 0;
+    while (b < METRICS_LOOP_BOUNDS && us > kLoopBoundsUs[b]) ++b;
+    s_loop_bucket[b].fetch_add(1, std::memory_order_relaxed);
+    s_loop_sum_us.fetch_add(us, std::memory_order_relaxed);
+  }
+  s_last_loop_us = nowUs;
+
+  const bool up = WiFiMgr::isConnected();
+  if (up && !s_was_connected) {
+    if (s_ever_connected) s_reconnects++;
+    s_ever_connected = true;
+  }
+  s_was_connected = up;
+}
+
+// ---- Rendering ----
+
+static void header(String &out, const char *name, const char *type, const char *help) {
+  out += "# HELP "; out += name; out += ' '; out += help; out += '\n';
+  out += "# TYPE "; out += name; out += ' '; out += type; out += '\n';
+}
+
+static void sample(String &out, const char *name, const char *labels, uint64_t v) {
+  char line[160];
+  snprintf(line, sizeof(line), "%s%s%s%s %llu\n", name, labels ? "{" : "", labels ? labels : "",
+           labels ? "}" : "", (unsigned long long)v);
+  out += line;
+}
+
+static void gauge(String &out, const char *name, const char *help, uint64_t v) {
+  header(out, name, "gauge", help);
+  sample(out, name, nullptr, v);
+}
+
+static void counter(String &out, const char *name, const char *help, uint64_t v) {
+  header(out, name, "counter", help);
+  sample(out, name, nullptr, v);
+}
+
+// Cumulative buckets from per-bucket counts; bounds in microseconds
+static void histogram(String &out, const char *name, const char *help, const uint32_t *boundsUs,
+                      uint8_t nBounds, const uint32_t *buckets, uint64_t sumUs) {
+  header(out, name, "histogram", help);
+  char line[160];
+  uint64_t acc = 0;
+  for (uint8_t b = 0; b <= nBounds; ++b) {
+    acc += buckets[b];
+    if (b < nBounds)
+      snprintf(line, sizeof(line), "%s_bucket{le=\"%lu.%06lu\"} %llu\n", name,
+               (unsigned long)(boundsUs[b] / 1000000), (unsigned long)(boundsUs[b] % 1000000),
+               (unsigned long long)acc);
+    else
+      snprintf(line, sizeof(line), "%s_bucket{le=\"+Inf\"} %llu\n", name, (unsigned long long)acc);
+    out += line;
+  }
+  snprintf(line, sizeof(line), "%s_sum %llu.%06lu\n%s_count %llu\n", name,
+           (unsigned long long)(sumUs / 1000000), (unsigned long)(sumUs % 1000000), name,
+           (unsigned long long)acc);
+  out += line;
+}
+
+static String render() {
+  String out;
+  out.reserve(6144);
+  char labels[64];
+
+  header(out, "typed_info", "gauge", "Board identity");
+  sample(out, "typed_info", "board=\"exp\"", 1);
+  gauge(out, "typed_uptime_seconds", "Seconds since boot", millis() / 1000);
+
+  uint32_t loopBuckets[METRICS_LOOP_BOUNDS + 1];
+  for (uint8_t b = 0; b <= METRICS_LOOP_BOUNDS; ++b) loopBuckets[b] = s_loop_bucket[b].load(std::memory_order_relaxed);
+  histogram(out, "typed_loop_seconds", "Main loop iteration period", kLoopBoundsUs, METRICS_LOOP_BOUNDS,
+            loopBuckets, s_loop_sum_us.load(std::memory_order_relaxed));
+
+  // UDP (all traffic goes through UDPMux)
+  const UDPMux::Stats us = UDPMux::getStats();
+  header(out, "typed_udp_packets_total", "counter", "UDP datagrams by direction");
+  sample(out, "typed_udp_packets_total", "dir=\"in\"", us.rxPackets);
+  sample(out, "typed_udp_packets_total", "dir=\"out\"", us.txDatagrams);
+  header(out, "typed_udp_dropped_total", "counter", "UDP datagrams not delivered");
+  sample(out, "typed_udp_dropped_total", "reason=\"unhandled\"", us.rxUnhandled);
+  sample(out, "typed_udp_dropped_total", "reason=\"tx_queue\"", us.txDropped);
+  sample(out, "typed_udp_dropped_total", "reason=\"coalesced\"", us.txCoalesced);
+
+  // SMBus scheduler
+  const SMBusSched::Stats ss = SMBusSched::getStats();
+  counter(out, "typed_smbus_transactions_total", "SMBus register transactions issued", ss.transactions);
+  header(out, "typed_smbus_errors_total", "counter", "SMBus faults by kind");
+  sample(out, "typed_smbus_errors_total", "kind=\"job_failed\"", ss.jobsFailed);
+  sample(out, "typed_smbus_errors_total", "kind=\"job_expired\"", ss.jobsExpired);
+  sample(out, "typed_smbus_errors_total", "kind=\"retry\"", ss.retries);
+  sample(out, "typed_smbus_errors_total", "kind=\"bus_busy\"", ss.busBusySkips);
+  sample(out, "typed_smbus_errors_total", "kind=\"recovery\"", ss.recoveries);
+  sample(out, "typed_smbus_errors_total", "kind=\"sensor\"", XboxSMBusPoll::getStats().errors);
+  counter(out, "typed_smbus_busy_seconds_total", "Measured bus time", ss.busyUs / 1000000);
+
+  // SMBus per-register results and latency (SMBusHealth)
+  SMBusHealth::Entry entries[24];
+  uint32_t all[SMBusHealth::kBuckets];
+  uint64_t allSumUs = 0;
+  const uint8_t n = SMBusHealth::snapshot(entries, 24, all, &allSumUs);
+  header(out, "typed_smbus_register_total", "counter", "SMBus transactions per register and result");
+  for (uint8_t i = 0; i < n; ++i) {
+    snprintf(labels, sizeof(labels), "addr=\"0x%02X\",reg=\"0x%02X\",result=\"ok\"", entries[i].addr, entries[i].reg);
+    sample(out, "typed_smbus_register_total", labels, entries[i].ok);
+    snprintf(labels, sizeof(labels), "addr=\"0x%02X\",reg=\"0x%02X\",result=\"err\"", entries[i].addr, entries[i].reg);
+    sample(out, "typed_smbus_register_total", labels, entries[i].err);
+  }
+  uint32_t bounds[SMBusHealth::kBuckets - 1];
+  for (uint8_t b = 0; b < SMBusHealth::kBuckets - 1; ++b) bounds[b] = SMBusHealth::bucketLimitUs(b);
+  histogram(out, "typed_smbus_latency_seconds", "SMBus transaction latency",
+            bounds, SMBusHealth::kBuckets - 1, all, allSumUs);
+
+  // Memory
+  header(out, "typed_heap_free_bytes", "gauge", "Free heap by region");
+  sample(out, "typed_heap_free_bytes", "region=\"internal\"", heap_caps_get_free_size(MALLOC_CAP_INTERNAL));
+  sample(out, "typed_heap_free_bytes", "region=\"psram\"", heap_caps_get_free_size(MALLOC_CAP_SPIRAM));
+  header(out, "typed_heap_largest_block_bytes", "gauge", "Largest allocatable block by region");
+  sample(out, "typed_heap_largest_block_bytes", "region=\"internal\"", heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL));
+  sample(out, "typed_heap_largest_block_bytes", "region=\"psram\"", heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM));
+  gauge(out, "typed_heap_min_free_bytes", "Lowest free internal heap since boot", ESP.getMinFreeHeap());
+
+  // WiFi
+  const bool up = WiFi.isConnected();
+  gauge(out, "typed_wifi_connected", "1 when associated", up ? 1 : 0);
+  if (up) {
+    header(out, "typed_wifi_rssi_dbm", "gauge", "Signal strength of the current AP");
+    char rssi[48];
+    snprintf(rssi, sizeof(rssi), "typed_wifi_rssi_dbm %d\n", (int)WiFi.RSSI());
+    out += rssi;
+  }
+  counter(out, "typed_wifi_reconnects_total", "Links re-established after a drop", s_reconnects.load());
+
+  counter(out, "typed_upload_bytes_total", "OTA upload bytes accepted",
+          g_counters[UPLOAD_BYTES].load(std::memory_order_relaxed));
+  return out;
+}
+
+void begin() {
+  WiFiMgr::addRoutes([](AsyncWebServer &server) {
+    server.on("/metrics", HTTP_GET, [](AsyncWebServerRequest *request) {
+      AsyncWebServerResponse *r = request->beginResponse(200, "text/plain; version=0.0.4", render());
+      r->addHeader("Cache-Control", "no-store");
+      request->send(r);
+    });
+  });
+}
+
+} // namespace Metrics
@@ -0,0 +1,30 @@
+// metrics.h
+//
+// Prometheus text exposition on GET /metrics (port 80, next to the portal).
+// Hot paths only bump relaxed atomics (inc() / observe()); SMBus, UDP, heap
+// and WiFi figures come from the modules' own snapshots at render time.
+
+#pragma once
+#include <Arduino.h>
+#include <atomic>
+
+namespace Metrics {
+
+  enum Counter : uint8_t {
+    UPLOAD_BYTES,     // OTA firmware bytes accepted on /update
+    COUNTER_COUNT
+  };
+
+  extern std::atomic<uint32_t> g_counters[COUNTER_COUNT];
+
+  // Any task
+  inline void inc(Counter c, uint32_t n = 1) {
+    g_counters[c].fetch_add(n, std::memory_order_relaxed);
+  }
+
+  // Register GET /metrics (call after WiFiMgr::begin())
+  void begin();
+
+  // Main loop, once per iteration: loop period histogram, WiFi reconnects
+  void loop();
+}
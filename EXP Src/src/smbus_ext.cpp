@@ -4,12 +4,18 @@
 // Safe across all revisions, with special care for 1.6 (Xcalibur).
 //
 // Key points:
-// - Uses the cross-core SMBus mutex provided by xbox_smbus_poll.cpp
-//   (try_lock_smbus()/unlock_smbus()), so only ONE reader touches the bus.
-// - STOP-only transactions (no repeated-start) for maximum 1.6 compatibility.
-// - Gentle pacing with jitter and backoff; small inter-op gaps.
+// - Each sample runs as one SMBusSched sequence job, so only ONE reader
+//   touches the bus and the global duty budget/gaps/backoff apply.
+// - STOP-only transactions for maximum 1.6 compatibility (the Focus
+//   decoder additionally tries repeated-start LSB-first word reads).
+// - Gentle cadence with jitter and backoff; packet is sent after the job.
 // - Encoder is detected once; Xcalibur video mode is probed SAFELY and
 //   periodically (single register, STOP-only) so mode changes are tracked.
+// - Focus encoder: the decode strategy that worked (and its key register) is
+//   cached; steady state re-reads only that register and falls back to the
+//   full 16-read probe on a change or error.
+// - PIC and console version never change at runtime: read once per boot and
+//   reused (counted in readsSaved()). Tray/AV are re-read every sample.
 // - If base SMC reads fail, we back off and skip transmit to reduce pressure.
 // - No writes are performed to SMBus devices.
 //
@@ -17,14 +23,9 @@
 //
 
 #include "smbus_ext.h"
+#include "smbus_sched.h"
 #include <Arduino.h>
-#include <WiFiUdp.h>
-#include <Wire.h>
-
-// We only need the wrappers; they’re defined in xbox_smbus_poll.cpp
-extern bool     try_lock_smbus();
-extern void     unlock_smbus();
-extern uint32_t smbus_last_activity_ms(); // (optional pacing hint)
+#include "udp_mux.h"
 
 // ===================== Config =====================
 #define SMBUS_EXT_PORT 50505
@@ -43,11 +44,6 @@ extern uint32_t smbus_last_activity_ms(); // (optional pacing hint)
 #define SMC_VER        0x01
 #define SMC_CONSOLEVER 0x00   // may be 0xFF (not reported on some boards)
 
-// Small idle gap to be nice to the bus timing
-#ifndef SMBUS_GAP_US
-#define SMBUS_GAP_US 300
-#endif
-
 // Pacing (slower than before to further reduce contention)
 #ifndef SMBUS_EXT_STARTUP_GRACE_MS
 #define SMBUS_EXT_STARTUP_GRACE_MS 10000
@@ -69,9 +65,6 @@ extern uint32_t smbus_last_activity_ms(); // (optional pacing hint)
 #define SMBUS_EXT_DEBUG 0
 #endif
 
-// ===================== UDP ========================
-static WiFiUDP extUdp;
-
 // pacing state
 static uint32_t g_ext_first_ms = 0;
 static uint32_t g_ext_next_allowed_ms = 0;
@@ -80,6 +73,20 @@ static uint32_t g_ext_next_allowed_ms = 0;
 static bool s_encoder_known = false;
 static int  s_encoder_cache = -1;
 
+// job state: s_work is filled on the bus, s_last is what we broadcast
+static bool           s_job_pending = false;
+static bool           s_have_last   = false;
+static bool           s_smc_valid   = false;
+static int            s_smc_err     = -1;
+static uint8_t        s_smc_raw     = 0;
+static SMBusExt::Status s_work;
+static SMBusExt::Status s_last;
+
+// once-per-boot SMC registers
+static int      s_pic_ver     = -1;   // SMC_VER, -1 until read
+static bool     s_conver_done = false;
+static uint32_t s_reads_saved = 0;
+
 // Xcalibur mode cache + pacing (re-probe to catch runtime changes)
 static bool     s_xcal_mode_known    = false;
 static int      s_xcal_mode_code     = -1; // 0..5 if known
@@ -87,41 +94,23 @@ static uint32_t s_xcal_next_probe_ms = 0;
 
 // ===================== SMBus helpers ==============
 
-static inline void smbus_breather() {
-  delayMicroseconds(SMBUS_GAP_US);
-  // yield();  // (optional) keep disabled to minimize jitter on tight loops
+static uint32_t s_bus_reads = 0;      // transactions issued by this module
+
+// Thin wrappers over the scheduler primitives (valid inside the sequence job)
+static inline int readByteSTOP(uint8_t address, uint8_t reg, uint8_t& value) {
+  s_bus_reads++;
+  return SMBusSched::readByte(address, reg, value);
 }
 
-// STOP-only single byte read (1.6-safe)
-static int readByteSTOP(uint8_t address, uint8_t reg, uint8_t& value) {
-  Wire.beginTransmission(address);
-  Wire.write(reg);
-  if (Wire.endTransmission(true) != 0) return -1;     // STOP
-  smbus_breather();
-  const uint8_t n = Wire.requestFrom((int)address, 1, (int)true); // STOP
-  if (n == 1 && Wire.available()) {
-    value = Wire.read();
-    smbus_breather();
-    return 0;
-  }
-  return -1;
+static inline int readWordSTOP(uint8_t address, uint8_t reg, uint16_t& value) {
+  s_bus_reads++;
+  return SMBusSched::readWord(address, reg, value);
 }
 
-// STOP-only 16-bit read (msb:lsb)
-static int readWordSTOP(uint8_t address, uint8_t reg, uint16_t& value) {
-  Wire.beginTransmission(address);
-  Wire.write(reg);
-  if (Wire.endTransmission(true) != 0) return -1;     // STOP
-  smbus_breather();
-  const uint8_t n = Wire.requestFrom((int)address, 2, (int)true); // STOP
-  if (n == 2 && Wire.available() >= 2) {
-    const uint8_t msb = Wire.read();
-    const uint8_t lsb = Wire.read();
-    value = ((uint16_t)msb << 8) | lsb;
-    smbus_breather();
-    return 0;
-  }
-  return -1;
+// Repeated-start, LSB-first (spi2par2019 style)
+static inline bool readWordRS_LSB(uint8_t addr, uint8_t reg, uint16_t& out) {
+  s_bus_reads++;
+  return SMBusSched::readWordRS(addr, reg, out) == 0;
 }
 
 // ===================== AV-pack heuristics =========
@@ -159,9 +148,56 @@ static void getConexantResolutionFromRegs(int avVal, int& width, int& height) {
 }
 
 // ===================== Focus resolution ===========
+// Which decode path succeeded last time, and the one register whose value
+// pins that decision (re-read in steady state).
+enum FocusStrat : uint8_t {
+  FS_NONE = 0,
+  FS_VC0_RSL,     // VID_CNTL0 via RS/LSB (decisive on its own)
+  FS_VC0_STOP,    // VID_CNTL0 via STOP + byte swap (decisive on its own)
+  FS_ACT_RSL,     // HDTV active window via RS/LSB, key VACT_HT
+  FS_ACT_STOP,    // HDTV active window via STOP (as-is or swapped), key VACT_HT
+  FS_SD_RSL,      // SD counters via RS/LSB, key NL
+  FS_SD_STOP,     // SD counters via STOP, key NL (or NP)
+  FS_AV           // nothing decoded; AV-pack guess
+};
+
+struct FocusCache {
+  FocusStrat strat;
+  uint8_t    keyReg;
+  uint16_t   keyVal;
+  int        avVal;
+  int        width, height;
+  uint32_t   fullReads;   // bus reads the full probe took
+  uint32_t   probedAt;    // millis() of the last full probe
+};
+
+#ifndef FOCUS_AV_REPROBE_MS
+#define FOCUS_AV_REPROBE_MS 60000   // AV-pack guess: full re-probe at most this often
+#endif
+
+static FocusCache s_focus = {};
+
+static inline void focusRemember(FocusStrat strat, uint8_t reg, uint16_t val) {
+  s_focus.strat  = strat;
+  s_focus.keyReg = reg;
+  s_focus.keyVal = val;
+}
+
+static inline bool focusKeyIsRS(FocusStrat st) {
+  return st == FS_VC0_RSL || st == FS_ACT_RSL || st == FS_SD_RSL;
+}
+
+static inline void focusDecodeVC0(uint16_t vc0, int& width, int& height) {
+  const bool HDTV       = (vc0 & (1u << 12)) != 0;
+  const bool INTERLACED = (vc0 & (1u << 7))  != 0;
+  if (HDTV) { width = INTERLACED ? 1920 : 1280; height = INTERLACED ? 1080 : 720; }
+  else      { width = 720; height = 480; }
+}
+
 // Focus FS454: same logic as you have, plus detailed debug of register reads.
 // Enable with: #define SMBUS_EXT_DEBUG 1
-static void getFocusResolutionOrFallback(int avVal, int& width, int& height) {
+// Records the winning strategy via focusRemember() before each return.
+static void focusFullProbe(int avVal, int& width, int& height) {
   width = -1; height = -1;
 
 #if SMBUS_EXT_DEBUG
@@ -174,20 +210,6 @@ static void getFocusResolutionOrFallback(int avVal, int& width, int& height) {
   auto in = [](int v, int lo, int hi){ return v >= lo && v <= hi; };
   auto bswap = [](uint16_t x)->uint16_t { return (uint16_t)((x >> 8) | (x << 8)); };
 
-  // Local helper: repeated-start, LSB-first (spi2par2019 style) -- used ONLY for debug + optional read
-  auto readWordRS_LSB = [](uint8_t addr, uint8_t reg, uint16_t& out)->bool {
-    Wire.beginTransmission(addr);
-    Wire.write(reg);
-    if (Wire.endTransmission(false) != 0) return false; // repeated-start
-    uint8_t n = Wire.requestFrom((int)addr, 2, (int)true); // read 2, STOP
-    if (n != 2 || !Wire.available()) return false;
-    const uint8_t lo = Wire.read();
-    if (!Wire.available()) return false;
-    const uint8_t hi = Wire.read();
-    out = (uint16_t)lo | ((uint16_t)hi << 8); // LSB first
-    return true;
-  };
-
   // -------------------- 1) FS454 PID and VID_CNTL0 --------------------
   uint16_t pid_stop = 0, pid_rsl = 0;
   bool pid_ok_stop = (readWordSTOP(ENC_FOCUS, 0x32, pid_stop) == 0);
@@ -218,12 +240,14 @@ static void getFocusResolutionOrFallback(int avVal, int& width, int& height) {
       if (do_dbg) Serial.printf("[FOCUS][DEC] via VC0.RSL HDTV=%d INT=%d => %dx%d\n",
                                 (int)HDTV, (int)INTERLACED, width, height);
 #endif
+      focusRemember(FS_VC0_RSL, 0x92, vc0_rsl);
       return;
     } else {
       width = 720; height = 480;
 #if SMBUS_EXT_DEBUG
       if (do_dbg) Serial.printf("[FOCUS][DEC] via VC0.RSL SD => %dx%d\n", width, height);
 #endif
+      focusRemember(FS_VC0_RSL, 0x92, vc0_rsl);
       return;
     }
   }
@@ -240,12 +264,14 @@ static void getFocusResolutionOrFallback(int avVal, int& width, int& height) {
       if (do_dbg) Serial.printf("[FOCUS][DEC] via VC0.STOP+SWAP HDTV=%d INT=%d => %dx%d\n",
                                 (int)HDTV, (int)INTERLACED, width, height);
 #endif
+      focusRemember(FS_VC0_STOP, 0x92, vc0_stop);
       return;
     } else {
       width = 720; height = 480;
 #if SMBUS_EXT_DEBUG
       if (do_dbg) Serial.printf("[FOCUS][DEC] via VC0.STOP+SWAP SD => %dx%d\n", width, height);
 #endif
+      focusRemember(FS_VC0_STOP, 0x92, vc0_stop);
       return;
     }
   }
@@ -286,7 +312,7 @@ static void getFocusResolutionOrFallback(int avVal, int& width, int& height) {
                     decided ? "DECIDED" : "UNDECIDED");
     }
 #endif
-    if (decided) return;
+    if (decided) { focusRemember(FS_ACT_RSL, 0xBE, h_rsl); return; }
   }
 
   // Try STOP words (use as-is and with swap) just to see if they look sane
@@ -319,7 +345,7 @@ static void getFocusResolutionOrFallback(int avVal, int& width, int& height) {
                                 W2,H2, decided?"DECIDED":"UNDECIDED");
 #endif
     }
-    if (decided) return;
+    if (decided) { focusRemember(FS_ACT_STOP, 0xBE, h_stop); return; }
   }
 
   // -------------------- 3) SD counters (only if HD absent) --------------------
@@ -347,6 +373,7 @@ static void getFocusResolutionOrFallback(int avVal, int& width, int& height) {
 #if SMBUS_EXT_DEBUG
     if (do_dbg) Serial.printf("[FOCUS][DEC] via SD.RSL => %dx%d\n", width, height);
 #endif
+    focusRemember(FS_SD_RSL, 0x57, nl_rsl);
     return;
   }
   if (nl_ok_stop && np_ok_stop) {
@@ -355,6 +382,7 @@ static void getFocusResolutionOrFallback(int avVal, int& width, int& height) {
 #if SMBUS_EXT_DEBUG
     if (do_dbg) Serial.printf("[FOCUS][DEC] via SD.STOP(as-is) => %dx%d\n", width, height);
 #endif
+    focusRemember(FS_SD_STOP, 0x57, nl_stop);
     return;
   }
   if (nl_ok_stop || np_ok_stop) { // mixed case
@@ -364,6 +392,8 @@ static void getFocusResolutionOrFallback(int avVal, int& width, int& height) {
 #if SMBUS_EXT_DEBUG
       if (do_dbg) Serial.printf("[FOCUS][DEC] via SD.STOP(swapped) => %dx%d\n", width, height);
 #endif
+      if (nl_ok_stop) focusRemember(FS_SD_STOP, 0x57, nl_stop);
+      else            focusRemember(FS_SD_STOP, 0x71, np_stop);
       return;
     }
   }
@@ -374,6 +404,51 @@ static void getFocusResolutionOrFallback(int avVal, int& width, int& height) {
 #if SMBUS_EXT_DEBUG
   if (do_dbg) Serial.printf("[FOCUS][DEC] via AV-PACK => %dx%d\n", width, height);
 #endif
+  focusRemember(FS_AV, 0, 0);
+}
+
+// Steady state: one register read (or none for the AV guess) confirms the
+// cached mode. Returns false when a full probe is needed.
+static bool focusFastPath(int avVal, int& width, int& height) {
+  if (s_focus.strat == FS_NONE || s_focus.avVal != avVal) return false;
+
+  if (s_focus.strat == FS_AV) {
+    if ((millis() - s_focus.probedAt) >= FOCUS_AV_REPROBE_MS) return false;
+    width = s_focus.width; height = s_focus.height;
+    s_reads_saved += s_focus.fullReads;
+    return true;
+  }
+
+  uint16_t v = 0;
+  const bool ok = focusKeyIsRS(s_focus.strat)
+                    ? readWordRS_LSB(ENC_FOCUS, s_focus.keyReg, v)
+                    : (readWordSTOP(ENC_FOCUS, s_focus.keyReg, v) == 0);
+  if (!ok) return false;                       // error: re-probe everything
+
+  if (v != s_focus.keyVal) {
+    // VID_CNTL0 alone decides the mode; other strategies need the full probe
+    if (s_focus.strat == FS_VC0_RSL)       focusDecodeVC0(v, s_focus.width, s_focus.height);
+    else if (s_focus.strat == FS_VC0_STOP) focusDecodeVC0((uint16_t)((v >> 8) | (v << 8)), s_focus.width, s_focus.height);
+    else return false;
+    s_focus.keyVal = v;
+  }
+
+  width = s_focus.width; height = s_focus.height;
+  if (s_focus.fullReads > 1) s_reads_saved += s_focus.fullReads - 1;
+  return true;
+}
+
+static void getFocusResolutionOrFallback(int avVal, int& width, int& height) {
+  if (focusFastPath(avVal, width, height)) return;
+
+  const uint32_t before = s_bus_reads;
+  s_focus.strat = FS_NONE;
+  focusFullProbe(avVal, width, height);
+  s_focus.avVal     = avVal;
+  s_focus.width     = width;
+  s_focus.height    = height;
+  s_focus.fullReads = s_bus_reads - before;
+  s_focus.probedAt  = millis();
 }
 
 // ===================== Xcalibur helpers ===========
@@ -434,65 +509,49 @@ static void detectEncoderOnce() {
   s_encoder_known = true;
 }
 
-// ===================== Public API =================
-void SMBusExt::begin() {
-  extUdp.begin(SMBUS_EXT_PORT);
-  g_ext_first_ms = millis();
-  g_ext_next_allowed_ms = g_ext_first_ms + SMBUS_EXT_STARTUP_GRACE_MS;
-  s_xcal_next_probe_ms = g_ext_first_ms + SMBUS_EXT_STARTUP_GRACE_MS + 500; // first probe after grace
-}
-
-void SMBusExt::loop() {
-  if (millis() < g_ext_next_allowed_ms) return;
-  sendExtStatus();
-}
-
-void SMBusExt::sendExtStatus() {
+// ===================== Sample (runs on the bus) ====
+// Sequence job body: fills s_work. Returns false if the base SMC reads fail
+// so the scheduler can back the bus off.
+static bool ext_sequence(void *) {
   const uint32_t now = millis();
-
-  // 1) Only one SMBus user at a time
-  if (!try_lock_smbus()) {
-    // small defer; let the poller keep its cadence
-    g_ext_next_allowed_ms = now + SMBUS_EXT_MIN_PERIOD_MS;
-    return;
-  }
-
-  Status packet;
+  SMBusExt::Status &packet = s_work;
   uint8_t b;
   bool ok = true;
 
-  // 2) Base SMC fields (STOP-only). If any fail, SKIP transmit & back off.
+  // 1) Base SMC fields (STOP-only). If any fail, SKIP transmit & back off.
   if (readByteSTOP(SMC_ADDRESS, SMC_TRAY, b) == 0) packet.trayState = (int)b;
   else { packet.trayState = -1; ok = false; }
 
   if (readByteSTOP(SMC_ADDRESS, SMC_AVSTATE, b) == 0) packet.avPackState = (int)b;
   else { packet.avPackState = -1; ok = false; }
 
-  if (readByteSTOP(SMC_ADDRESS, SMC_VER, b) == 0) packet.picVer = (int)b;
+  if (s_pic_ver >= 0) { packet.picVer = s_pic_ver; s_reads_saved++; }
+  else if (readByteSTOP(SMC_ADDRESS, SMC_VER, b) == 0) packet.picVer = s_pic_ver = (int)b;
   else { packet.picVer = -1; ok = false; }
 
-  if (!ok) {
-    uint32_t jitter = 150 + ((now & 0xFF) % 250); // 150..399ms
-    g_ext_next_allowed_ms = now + SMBUS_EXT_BACKOFF_MS + jitter;
-    unlock_smbus();
-    return;
-  }
+  if (!ok) return false;
 
-  // 3) Console version policy
-  int err = readByteSTOP(SMC_ADDRESS, SMC_CONSOLEVER, b);
-  bool smcValid = (err == 0) && (b <= 6);
-  if (smcValid) {
-    packet.xboxVer = (int)b; // 0..6 direct
+  // 2) Console version policy (register read once per boot)
+  if (s_conver_done) {
+    s_reads_saved++;
+  } else {
+    s_smc_err = readByteSTOP(SMC_ADDRESS, SMC_CONSOLEVER, s_smc_raw);
+    s_conver_done = (s_smc_err == 0);
+  }
+  s_smc_valid = (s_smc_err == 0) && (s_smc_raw <= 6);
+  if (s_smc_valid) {
+    packet.xboxVer = (int)s_smc_raw; // 0..6 direct
   } else {
     detectEncoderOnce();
     packet.xboxVer = (s_encoder_cache == ENC_XCALIBUR) ? 6 : -1;
   }
 
-  // 4) Always broadcast encoder type if we know it
-  if (!s_encoder_known) detectEncoderOnce();
+  // 3) Always broadcast encoder type if we know it
+  if (s_encoder_known) s_reads_saved++;
+  else detectEncoderOnce();
   packet.encoderType = s_encoder_cache;
 
-  // 5) Resolution (with safe Xcal mode probing on a timer)
+  // 4) Resolution (with safe Xcal mode probing on a timer)
   int width = -1, height = -1;
 
   if (s_encoder_cache == ENC_CONEXANT) {
@@ -518,31 +577,87 @@ void SMBusExt::sendExtStatus() {
 
   packet.videoWidth  = width;
   packet.videoHeight = height;
+  return true;
+}
+
+// Completion: broadcast and schedule the next sample
+static void ext_done(void *, SMBusSched::Result res, const uint8_t *, uint8_t) {
+  const uint32_t now = millis();
+  const uint32_t jitter = 150 + (esp_random() % 250); // 150..399ms
+  s_job_pending = false;
+
+  if (res == SMBusSched::RES_EXPIRED) {
+    // bus was busy with higher-priority work; just try next period
+    g_ext_next_allowed_ms = now + SMBUS_EXT_MIN_PERIOD_MS + jitter;
+    return;
+  }
+  if (res != SMBusSched::RES_OK) {
+    g_ext_next_allowed_ms = now + SMBUS_EXT_BACKOFF_MS + jitter;
+    return;
+  }
 
-  // 6) Broadcast packet
-  extUdp.beginPacket("255.255.255.255", SMBUS_EXT_PORT);
-  extUdp.write((const uint8_t*)&packet, sizeof(packet));
-  extUdp.endPacket();
+  s_last = s_work;
+  s_have_last = true;
+  SMBusExt::sendExtStatus();
 
 #if SMBUS_EXT_DEBUG
   const char* encStr =
       s_encoder_cache == ENC_CONEXANT ? "CONEXANT" :
       s_encoder_cache == ENC_FOCUS    ? "FOCUS"    :
       s_encoder_cache == ENC_XCALIBUR ? "XCALIBUR" : "UNKNOWN";
-  const char* smcStr = (err == 0) ? (String("0x") + String(b, HEX)).c_str() : "ERR";
+  char smcStr[8];
+  if (s_smc_err == 0) snprintf(smcStr, sizeof(smcStr), "0x%x", s_smc_raw);
+  else strlcpy(smcStr, "ERR", sizeof(smcStr));
   Serial.printf("[SMBusExt] EXT: Tray=%d AV=0x%02X PIC=0x%02X SMCverRaw=%s Enc=%s -> xboxVer=%d Res=%dx%d\n",
-      packet.trayState,
-      packet.avPackState & 0xFF,
-      packet.picVer & 0xFF,
+      s_last.trayState,
+      s_last.avPackState & 0xFF,
+      s_last.picVer & 0xFF,
       smcStr,
       encStr,
-      packet.xboxVer,
-      packet.videoWidth, packet.videoHeight);
+      s_last.xboxVer,
+      s_last.videoWidth, s_last.videoHeight);
 #endif
 
-  // 7) Schedule next tick and release lock
-  uint32_t jitter = 150 + ((now & 0xFF) % 250); // 150..399ms
-  g_ext_next_allowed_ms = now + (smcValid ? SMBUS_EXT_MIN_PERIOD_MS
-                                          : SMBUS_EXT_BACKOFF_MS) + jitter;
-  unlock_smbus();
+  g_ext_next_allowed_ms = now + (s_smc_valid ? SMBUS_EXT_MIN_PERIOD_MS
+                                             : SMBUS_EXT_BACKOFF_MS) + jitter;
+}
+
+// ===================== Public API =================
+void SMBusExt::begin() {
+  g_ext_first_ms = millis();
+  g_ext_next_allowed_ms = g_ext_first_ms + SMBUS_EXT_STARTUP_GRACE_MS;
+  s_xcal_next_probe_ms = g_ext_first_ms + SMBUS_EXT_STARTUP_GRACE_MS + 500; // first probe after grace
+  s_job_pending = false;
+  s_have_last = false;
+}
+
+void SMBusExt::loop() {
+  const uint32_t now = millis();
+  if (s_job_pending || (int32_t)(now - g_ext_next_allowed_ms) < 0) return;
+
+  SMBusSched::Job j;
+  j.prio     = SMBusSched::PRIO_NORMAL;
+  j.retries  = 0;                                  // next period is the retry
+  j.deadline = now + SMBUS_EXT_MIN_PERIOD_MS;
+  j.seq      = ext_sequence;
+  j.done     = ext_done;
+  if (SMBusSched::submit(j)) {
+    s_job_pending = true;
+  } else {
+    g_ext_next_allowed_ms = now + SMBUS_EXT_MIN_PERIOD_MS;  // table full; defer
+  }
+}
+
+uint32_t SMBusExt::readsSaved() {
+  return s_reads_saved;
+}
+
+void SMBusExt::sendExtStatus() {
+  if (!s_have_last) return;
+  sendCustomStatus(s_last);
+}
+
+void SMBusExt::sendCustomStatus(const Status& status) {
+  // Queued (SMBus task); the loop's UDPMux flush sends it
+  UDPMux::send(SMBUS_EXT_PORT, &status, sizeof(status), UDPMux::KEY_EXT);
 }
@@ -16,9 +16,12 @@ namespace SMBusExt {
         int encoderType;
     };
 
-    // Send the current extended status via UDP
+    // Broadcast the most recent completed sample via UDP (no bus access)
     void sendExtStatus();   // <-- NO ARGUMENTS
 
     // Optionally: send any custom status struct
     void sendCustomStatus(const Status& status);
+
+    // Register reads skipped by caching (PIC/console version, encoder, Focus mode fast path)
+    uint32_t readsSaved();
 }
@@ -0,0 +1,142 @@
+// smbus_health.cpp
+
+#include "smbus_health.h"
+#include "smbus_sched.h"
+#include "udp_mux.h"
+#include <WiFi.h>
+#include <atomic>
+
+#ifndef SMBUS_HEALTH_PORT
+#define SMBUS_HEALTH_PORT       50507
+#endif
+#ifndef SMBUS_HEALTH_PERIOD_MS
+#define SMBUS_HEALTH_PERIOD_MS  30000UL
+#endif
+#ifndef SMBUS_HEALTH_MAX_ENTRIES
+#define SMBUS_HEALTH_MAX_ENTRIES   24
+#endif
+
+namespace SMBusHealth {
+
+static const uint32_t kLimitsUs[kBuckets - 1] = { 250, 500, 1000, 2000, 4000, 8000, 16000 };
+
+static Entry    s_entries[SMBUS_HEALTH_MAX_ENTRIES];
+static volatile uint8_t s_count = 0;    // published after the entry is filled
+static uint32_t s_overflow = 0;         // transactions on registers beyond the table
+static uint32_t s_all_hist[kBuckets];
+static std::atomic<uint64_t> s_all_sum_us{0};   // read from other tasks (/metrics)
+
+static uint32_t s_last_send = 0;
+
+uint32_t bucketLimitUs(uint8_t bucket) {
+  return (bucket < kBuckets - 1) ? kLimitsUs[bucket] : UINT32_MAX;
+}
+
+static inline uint8_t bucket_of(uint32_t us) {
+  uint8_t b = 0;
+  while (b < kBuckets - 1 && us >= kLimitsUs[b]) ++b;
+  return b;
+}
+
+void record(uint8_t addr, uint8_t reg, bool ok, uint32_t us) {
+  const uint8_t b = bucket_of(us);
+  s_all_hist[b]++;
+  s_all_sum_us.fetch_add(us, std::memory_order_relaxed);
+
+  Entry *e = nullptr;
+  const uint8_t n = s_count;
+  for (uint8_t i = 0; i < n; ++i) {
+    if (s_entries[i].addr == addr && s_entries[i].reg == reg) { e = &s_entries[i]; break; }
+  }
+  if (!e) {
+    if (n >= SMBUS_HEALTH_MAX_ENTRIES) { s_overflow++; return; }
+    e = &s_entries[n];
+    memset(e, 0, sizeof(*e));
+    e->addr = addr;
+    e->reg  = reg;
+    s_count = n + 1;
+  }
+
+  if (ok) e->ok++; else e->err++;
+  if (us > e->maxUs) e->maxUs = us;
+  e->hist[b]++;
+}
+
+// Approximate percentile from a histogram: upper bound of the bucket holding it
+static uint32_t pct_us(const uint32_t *hist, uint8_t pct) {
+  uint32_t total = 0;
+  for (uint8_t b = 0; b < kBuckets; ++b) total += hist[b];
+  if (!total) return 0;
+  const uint32_t want = (total * pct + 99) / 100;
+  uint32_t acc = 0;
+  for (uint8_t b = 0; b < kBuckets; ++b) {
+    acc += hist[b];
+    if (acc >= want) return (b < kBuckets - 1) ? kLimitsUs[b] : kLimitsUs[kBuckets - 2] * 2;
+  }
+  return 0;
+}
+
+void dump(Print &out) {
+  const SMBusSched::Stats st = SMBusSched::getStats();
+  out.printf("[SMBusHealth] clk=%luHz up=%lus tx=%lu busy_skips=%lu recov=%lu backoff=%lums retries=%lu overflow=%lu\n",
+             (unsigned long)st.clockHz, (unsigned long)(st.uptimeMs / 1000),
+             (unsigned long)st.transactions, (unsigned long)st.busBusySkips,
+             (unsigned long)st.recoveries, (unsigned long)st.backoffMs,
+             (unsigned long)st.retries, (unsigned long)s_overflow);
+  out.print("[SMBusHealth] all hist:");
+  for (uint8_t b = 0; b < kBuckets; ++b) out.printf(" %lu", (unsigned long)s_all_hist[b]);
+  out.println();
+
+  out.println("[SMBusHealth] addr reg      ok     err  p50us  p95us  maxus  hist(<250,<500,<1k,<2k,<4k,<8k,<16k,>=16k)");
+  const uint8_t n = s_count;
+  for (uint8_t i = 0; i < n; ++i) {
+    const Entry &e = s_entries[i];
+    out.printf("[SMBusHealth] 0x%02X 0x%02X %7lu %7lu %6lu %6lu %6lu ",
+               e.addr, e.reg, (unsigned long)e.ok, (unsigned long)e.err,
+               (unsigned long)pct_us(e.hist, 50), (unsigned long)pct_us(e.hist, 95),
+               (unsigned long)e.maxUs);
+    for (uint8_t b = 0; b < kBuckets; ++b) out.printf("%s%lu", b ? "," : "", (unsigned long)e.hist[b]);
+    out.println();
+  }
+}
+
+uint8_t snapshot(Entry *out, uint8_t max, uint32_t *allHist, uint64_t *allSumUs) {
+  const uint8_t n = s_count < max ? s_count : max;
+  memcpy(out, s_entries, n * sizeof(Entry));
+  if (allHist) memcpy(allHist, s_all_hist, sizeof(s_all_hist));
+  if (allSumUs) *allSumUs = s_all_sum_us.load(std::memory_order_relaxed);
+  return n;
+}
+
+// SMBH:1|clk=..|up=..|tx=..|skip=..|recov=..|boff=..|h=a,b,..|AARR=ok/err/p95/max;...
+static void send_report() {
+  const SMBusSched::Stats st = SMBusSched::getStats();
+  char buf[1024];
+  int len = snprintf(buf, sizeof(buf), "SMBH:1|clk=%lu|up=%lu|tx=%lu|skip=%lu|recov=%lu|boff=%lu|h=",
+                     (unsigned long)st.clockHz, (unsigned long)(st.uptimeMs / 1000),
+                     (unsigned long)st.transactions, (unsigned long)st.busBusySkips,
+                     (unsigned long)st.recoveries, (unsigned long)st.backoffMs);
+  for (uint8_t b = 0; b < kBuckets && len < (int)sizeof(buf); ++b) {
+    len += snprintf(buf + len, sizeof(buf) - len, "%s%lu", b ? "," : "", (unsigned long)s_all_hist[b]);
+  }
+  const uint8_t n = s_count;
+  for (uint8_t i = 0; i < n && len < (int)sizeof(buf) - 48; ++i) {
+    const Entry &e = s_entries[i];
+    len += snprintf(buf + len, sizeof(buf) - len, "%s%02X%02X=%lu/%lu/%lu/%lu",
+                    i ? ";" : "|", e.addr, e.reg, (unsigned long)e.ok, (unsigned long)e.err,
+                    (unsigned long)pct_us(e.hist, 95), (unsigned long)e.maxUs);
+  }
+  if (len >= (int)sizeof(buf)) len = sizeof(buf) - 1;
+
+  UDPMux::send(SMBUS_HEALTH_PORT, buf, (size_t)len, UDPMux::KEY_HEALTH);
+}
+
+void loop() {
+  if (WiFi.status() != WL_CONNECTED) return;
+  const uint32_t now = millis();
+  if (now - s_last_send < SMBUS_HEALTH_PERIOD_MS) return;
+  s_last_send = now;
+  send_report();
+}
+
+} // namespace SMBusHealth
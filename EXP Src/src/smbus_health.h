@@ -0,0 +1,41 @@
+// smbus_health.h
+//
+// SMBus bus-health instrumentation. SMBusSched records every transaction
+// (address, register, result, latency); this module keeps per-register
+// success/error counts and fixed-bucket latency histograms, and reports them
+// together with the scheduler's idle-wait failures, re-inits and backoff.
+//
+// Output: a "SMBH:" text datagram on SMBUS_HEALTH_PORT every
+// SMBUS_HEALTH_PERIOD_MS (loop()), and a serial table via dump().
+#pragma once
+#include <Arduino.h>
+
+namespace SMBusHealth {
+
+  static const uint8_t kBuckets = 8;   // <250, <500, <1k, <2k, <4k, <8k, <16k, >=16k us
+
+  struct Entry {
+    uint8_t  addr;
+    uint8_t  reg;
+    uint32_t ok;
+    uint32_t err;
+    uint32_t maxUs;
+    uint32_t hist[kBuckets];
+  };
+
+  // SMBus task: one call per transaction
+  void record(uint8_t addr, uint8_t reg, bool ok, uint32_t us);
+
+  // Loop: periodic UDP report (no-op until WiFi is up)
+  void loop();
+
+  // Human-readable table over serial
+  void dump(Print &out);
+
+  // Copy of the per-register table (at most max entries); returns the count.
+  // allHist/allSumUs (optional) receive the all-register latency histogram.
+  uint8_t snapshot(Entry *out, uint8_t max, uint32_t *allHist = nullptr, uint64_t *allSumUs = nullptr);
+
+  // Bucket upper bounds in microseconds (last bucket is open-ended)
+  uint32_t bucketLimitUs(uint8_t bucket);
+}
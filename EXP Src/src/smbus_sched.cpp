@@ -0,0 +1,408 @@
+// smbus_sched.cpp
+//
+// One scheduler owns Wire for every SMBus reader on the EXP board (poller,
+// smbus_ext, eeprom_min). Replaces the per-module locks, pacing and jitter.
+//
+// Safety envelope (same as the old per-module pacing, now global):
+// - STOP-only reads by default (1.6-safe); repeated-start only when a
+//   sequence asks for it explicitly.
+// - Slow bus (~55 kHz), breathers inside a transaction, a minimum gap
+//   between jobs, and bus-idle observation before each job.
+// - Bus duty budget: a token bucket credits SMBUS_DUTY_PERMILLE of wall time
+//   and every job is charged its measured bus time, so the long-run load is
+//   bounded no matter how many modules submit work.
+// - Exponential backoff on real bus errors (probe NACKs don't count).
+//
+// Threading: service() and the completion callbacks run on one pinned task
+// ("smbus"); the job table is guarded by a spinlock so submit() is safe
+// from any task. The Arduino loop never waits on the bus.
+//
+// No writes to Xbox devices are ever issued (only register-pointer sets).
+
+#include "smbus_sched.h"
+#include "smbus_health.h"
+#include <Wire.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// ---------- Timing & pacing (tuned for safety) ----------
+#ifndef SMBUS_STARTUP_GRACE_MS
+#define SMBUS_STARTUP_GRACE_MS    10000   // let the console boot first
+#endif
+#ifndef SMBUS_I2C_CLOCK_HZ
+#define SMBUS_I2C_CLOCK_HZ         55000  // ~55 kHz, conservative for all revs
+#endif
+#ifndef SMBUS_WIRE_TIMEOUT_MS
+#define SMBUS_WIRE_TIMEOUT_MS          80 // allow for clock stretching
+#endif
+#ifndef SMBUS_INTER_OP_GAP_US
+#define SMBUS_INTER_OP_GAP_US        300  // breathing room between phases
+#endif
+#ifndef SMBUS_JOB_GAP_MS
+#define SMBUS_JOB_GAP_MS               8  // idle time between two jobs
+#endif
+#ifndef SMBUS_DUTY_PERMILLE
+#define SMBUS_DUTY_PERMILLE           10  // <= 1% of wall time on the bus
+#endif
+#ifndef SMBUS_DUTY_BURST_US
+#define SMBUS_DUTY_BURST_US        20000  // max saved-up credit (one short burst)
+#endif
+#ifndef SMBUS_BACKOFF_MS_BASE
+#define SMBUS_BACKOFF_MS_BASE       8000  // backoff base on error; exponential
+#endif
+#ifndef SMBUS_BACKOFF_MS_MAX
+#define SMBUS_BACKOFF_MS_MAX       60000
+#endif
+#ifndef SMBUS_RETRY_DELAY_MS
+#define SMBUS_RETRY_DELAY_MS          40  // per-attempt delay before a retry
+#endif
+#ifndef SMBUS_WAIT_FREE_MS
+#define SMBUS_WAIT_FREE_MS             5  // wait up to ~5ms for idle lines
+#endif
+#ifndef SMBUS_FREE_STABLE_CHECKS
+#define SMBUS_FREE_STABLE_CHECKS       3  // consecutive samples required
+#endif
+#ifndef SMBUS_MAX_JOBS
+#define SMBUS_MAX_JOBS                16
+#endif
+
+// ---------- SMBus task ----------
+#ifndef SMBUS_TASK_CORE
+#define SMBUS_TASK_CORE                0  // Arduino loop runs on core 1
+#endif
+#ifndef SMBUS_TASK_PRIO
+#define SMBUS_TASK_PRIO                2
+#endif
+#ifndef SMBUS_TASK_STACK
+#define SMBUS_TASK_STACK            4096
+#endif
+#ifndef SMBUS_TASK_PERIOD_MS
+#define SMBUS_TASK_PERIOD_MS           2  // sleep between service() passes
+#endif
+
+namespace SMBusSched {
+
+struct Slot {
+  Job      job;
+  uint32_t notBefore;   // millis(): earliest start (retries)
+  uint32_t seq;         // FIFO tie-break
+  uint8_t  attempts;
+  bool     used;
+};
+
+static Slot     s_slots[SMBUS_MAX_JOBS];
+static uint32_t s_seq = 0;
+static portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED;   // guards s_slots/s_seq
+
+static TaskHandle_t s_task = nullptr;
+static TickFn       s_producers = nullptr;
+
+static int s_sda_pin = -1;
+static int s_scl_pin = -1;
+
+static uint32_t s_first_ms = 0;
+static uint32_t s_next_allowed_ms = 0;    // gap / backoff gate
+static uint8_t  s_err_streak = 0;
+static int32_t  s_credit_us = 0;          // duty token bucket
+static uint32_t s_credit_at_ms = 0;
+static volatile uint32_t s_last_activity_ms = 0;
+static Stats    s_stats = {};
+
+// ---------- Small helpers ----------
+static inline void breather() {
+  delayMicroseconds(SMBUS_INTER_OP_GAP_US);
+}
+
+static inline void mark_bus_activity() {
+  s_last_activity_ms = millis();
+}
+
+// ---------- Wire backend (the real bus) ----------
+// Wait until both SDA & SCL are high for a few consecutive samples
+static bool wire_idle(uint32_t max_wait_ms) {
+  const uint32_t start = millis();
+  int stable = 0;
+  while ((millis() - start) < max_wait_ms) {
+    const bool sdaHigh = (s_sda_pin >= 0) ? (digitalRead(s_sda_pin) == HIGH) : true;
+    const bool sclHigh = (s_scl_pin >= 0) ? (digitalRead(s_scl_pin) == HIGH) : true;
+    if (sdaHigh && sclHigh) {
+      if (++stable >= SMBUS_FREE_STABLE_CHECKS) return true;
+    } else {
+      stable = 0;
+    }
+    delayMicroseconds(150);
+  }
+  return false;
+}
+
+static void wire_reset() {
+  Wire.begin(s_sda_pin, s_scl_pin);
+  Wire.setClock(SMBUS_I2C_CLOCK_HZ);
+  Wire.setTimeOut(SMBUS_WIRE_TIMEOUT_MS);
+}
+
+// Set the register pointer, then read `len` bytes (STOP per <=32-byte chunk).
+// rs=true: repeated-start between pointer write and read (no breather).
+static int wire_read(uint8_t addr, uint8_t reg, uint8_t *out, size_t len, bool rs) {
+  Wire.beginTransmission(addr);
+  Wire.write(reg);
+  if (Wire.endTransmission(!rs) != 0) return -1;
+  if (!rs) breather();
+
+  size_t got = 0;
+  while (got < len) {
+    const uint8_t chunk = (uint8_t)((len - got) > 32 ? 32 : (len - got));
+    const uint8_t n = Wire.requestFrom((int)addr, (int)chunk, (int)true); // STOP
+    if (n != chunk) return -1;
+    for (uint8_t i = 0; i < n; ++i) {
+      if (!Wire.available()) return -1;
+      out[got++] = Wire.read();
+    }
+    breather();
+  }
+  return 0;
+}
+
+static const Backend kWireBackend = { "wire", wire_read, wire_idle, wire_reset };
+static const Backend *s_backend = &kWireBackend;
+
+// Very light recovery: only if the bus appears wedged several times in a row.
+static void maybe_recover_wire() {
+  static uint8_t stuck_streak = 0;
+  if (++stuck_streak >= 3) {
+    s_backend->reset();
+    s_stats.recoveries++;
+    stuck_streak = 0;
+  }
+}
+
+// ---------- Bus primitives ----------
+static int xfer(uint8_t addr, uint8_t reg, uint8_t *out, size_t len, bool rs) {
+  s_stats.transactions++;
+  const uint32_t t0 = micros();
+  const bool ok = (s_backend->read(addr, reg, out, len, rs) == 0);
+  SMBusHealth::record(addr, reg, ok, micros() - t0);
+  if (!ok) return -1;
+  mark_bus_activity();
+  return 0;
+}
+
+int readByte(uint8_t addr, uint8_t reg, uint8_t &value) {
+  return xfer(addr, reg, &value, 1, false);
+}
+
+int readWord(uint8_t addr, uint8_t reg, uint16_t &value) {
+  uint8_t b[2];
+  if (xfer(addr, reg, b, 2, false) != 0) return -1;
+  value = ((uint16_t)b[0] << 8) | b[1];                        // MSB first
+  return 0;
+}
+
+int readWordRS(uint8_t addr, uint8_t reg, uint16_t &value) {
+  uint8_t b[2];
+  if (xfer(addr, reg, b, 2, true) != 0) return -1;
+  value = (uint16_t)b[0] | ((uint16_t)b[1] << 8);              // LSB first
+  return 0;
+}
+
+int readBlock(uint8_t addr, uint8_t reg, uint8_t *out, size_t len) {
+  if (!out || len == 0) return -1;
+  return xfer(addr, reg, out, len, false);
+}
+
+void setBackend(const Backend *backend) {
+  s_backend = backend ? backend : &kWireBackend;
+  Serial.printf("[SMBus] Backend: %s\n", s_backend->name);
+}
+
+// ---------- Scheduling ----------
+void begin(uint8_t sdaPin, uint8_t sclPin) {
+  s_sda_pin = sdaPin;
+  s_scl_pin = sclPin;
+
+  // Do NOT enable internal pullups—Xbox SMBus already has pullups.
+  pinMode(s_sda_pin, INPUT);
+  pinMode(s_scl_pin, INPUT);
+
+  Wire.begin(s_sda_pin, s_scl_pin);
+  Wire.setClock(SMBUS_I2C_CLOCK_HZ);
+  Wire.setTimeOut(SMBUS_WIRE_TIMEOUT_MS);
+
+  for (auto &s : s_slots) s = Slot{};
+  s_first_ms        = millis();
+  s_next_allowed_ms = s_first_ms + SMBUS_STARTUP_GRACE_MS;
+  s_err_streak      = 0;
+  s_credit_us       = 0;
+  s_credit_at_ms    = s_first_ms;
+}
+
+bool submit(const Job &job) {
+  if (!job.seq && (job.len == 0 || job.len > 32)) return false;
+  bool ok = false;
+  portENTER_CRITICAL(&s_mux);
+  for (Slot &s : s_slots) {
+    if (s.used) continue;
+    s.job       = job;
+    s.notBefore = 0;
+    s.seq       = s_seq++;
+    s.attempts  = 0;
+    s.used      = true;
+    ok = true;
+    break;
+  }
+  portEXIT_CRITICAL(&s_mux);
+  return ok;
+}
+
+static void refill_credit(uint32_t now) {
+  const uint32_t dt = now - s_credit_at_ms;
+  s_credit_at_ms = now;
+  s_credit_us += (int32_t)(dt * SMBUS_DUTY_PERMILLE);   // ms * permille = us
+  if (s_credit_us > SMBUS_DUTY_BURST_US) s_credit_us = SMBUS_DUTY_BURST_US;
+}
+
+// Highest priority, then earliest deadline, then oldest.
+// Only the SMBus task frees/reschedules slots, so the returned slot stays
+// valid after the lock is dropped.
+static Slot *pick(uint32_t now) {
+  Slot *best = nullptr;
+  portENTER_CRITICAL(&s_mux);
+  for (Slot &s : s_slots) {
+    if (!s.used || (int32_t)(now - s.notBefore) < 0) continue;
+    if (!best) { best = &s; continue; }
+    if (s.job.prio != best->job.prio) {
+      if (s.job.prio < best->job.prio) best = &s;
+      continue;
+    }
+    const uint32_t dA = s.job.deadline ? s.job.deadline - now : UINT32_MAX;
+    const uint32_t dB = best->job.deadline ? best->job.deadline - now : UINT32_MAX;
+    if (dA != dB) {
+      if (dA < dB) best = &s;
+      continue;
+    }
+    if ((int32_t)(s.seq - best->seq) < 0) best = &s;
+  }
+  portEXIT_CRITICAL(&s_mux);
+  return best;
+}
+
+static void complete(Slot &s, Result res, const uint8_t *data, uint8_t len) {
+  const Job job = s.job;
+  portENTER_CRITICAL(&s_mux);
+  s.used = false;                 // free first: the callback may resubmit
+  portEXIT_CRITICAL(&s_mux);
+  if (res == RES_OK) {
+    if (s_stats.jobsOk++ == 0) s_stats.firstOkMs = millis() - s_first_ms;
+  }
+  else if (res == RES_EXPIRED) s_stats.jobsExpired++;
+  else s_stats.jobsFailed++;
+  if (job.done) job.done(job.ctx, res, data, len);
+}
+
+static void expire_overdue(uint32_t now) {
+  for (Slot &s : s_slots) {
+    portENTER_CRITICAL(&s_mux);
+    const bool overdue = s.used && s.job.deadline && (int32_t)(now - s.job.deadline) > 0;
+    portEXIT_CRITICAL(&s_mux);
+    if (overdue) complete(s, RES_EXPIRED, nullptr, 0);
+  }
+}
+
+void service() {
+  const uint32_t now = millis();
+  refill_credit(now);
+  expire_overdue(now);
+
+  if ((int32_t)(now - s_next_allowed_ms) < 0) return;   // grace / gap / backoff
+  if (s_credit_us <= 0) return;                          // duty budget spent
+
+  Slot *s = pick(now);
+  if (!s) return;
+
+  // Ensure the bus looks idle; attempt a single gentle recovery if not.
+  if (!s_backend->idle(SMBUS_WAIT_FREE_MS)) {
+    maybe_recover_wire();
+    s_stats.busBusySkips++;
+    s_next_allowed_ms = now + SMBUS_JOB_GAP_MS * 4;
+    return;
+  }
+
+  uint8_t buf[32];
+  const uint32_t t0 = micros();
+  bool ok;
+  if (s->job.seq) {
+    ok = s->job.seq(s->job.ctx);
+  } else {
+    ok = (readBlock(s->job.addr, s->job.reg, buf, s->job.len) == 0);
+  }
+  const uint32_t spent = micros() - t0;
+  s_credit_us -= (int32_t)spent;
+  s_stats.busyUs += spent;
+
+  const uint32_t end = millis();
+  s_next_allowed_ms = end + SMBUS_JOB_GAP_MS;
+
+  if (ok) {
+    s_err_streak = 0;
+    complete(*s, RES_OK, s->job.seq ? nullptr : buf, s->job.seq ? 0 : s->job.len);
+    return;
+  }
+
+  if (s->job.flags & FLAG_PROBE) {
+    complete(*s, RES_ERR, nullptr, 0);   // absent device: an answer, not a fault
+    return;
+  }
+
+  if (s->attempts < s->job.retries) {
+    s->attempts++;
+    s_stats.retries++;
+    s->notBefore = end + SMBUS_RETRY_DELAY_MS * s->attempts;
+    return;
+  }
+
+  // Real failure: back the whole bus off (console may be busy/booting)
+  if (s_err_streak < 5) s_err_streak++;
+  uint32_t backoff = (uint32_t)SMBUS_BACKOFF_MS_BASE << (s_err_streak - 1);
+  if (backoff > SMBUS_BACKOFF_MS_MAX) backoff = SMBUS_BACKOFF_MS_MAX;
+  backoff += 100 + (esp_random() % 200);                 // 100..299 ms jitter
+  s_next_allowed_ms = end + backoff;
+  s_stats.backoffMs += backoff;
+  complete(*s, RES_ERR, nullptr, 0);
+}
+
+static void smbus_task(void *) {
+  for (;;) {
+    if (s_producers) s_producers();
+    service();
+    vTaskDelay(pdMS_TO_TICKS(SMBUS_TASK_PERIOD_MS));
+  }
+}
+
+bool startTask(TickFn producers) {
+  if (s_task) return true;
+  s_producers = producers;
+  const BaseType_t rc = xTaskCreatePinnedToCore(smbus_task, "smbus", SMBUS_TASK_STACK,
+                                                nullptr, SMBUS_TASK_PRIO, &s_task,
+                                                SMBUS_TASK_CORE);
+  if (rc != pdPASS) {
+    s_task = nullptr;
+    Serial.println("[SMBus] Failed to start task");
+    return false;
+  }
+  return true;
+}
+
+uint32_t lastActivityMs() { return s_last_activity_ms; }
+
+Stats getStats() {
+  Stats st = s_stats;
+  st.uptimeMs = millis() - s_first_ms;
+  st.clockHz  = SMBUS_I2C_CLOCK_HZ;
+  st.queued = 0;
+  portENTER_CRITICAL(&s_mux);
+  for (const Slot &s : s_slots) if (s.used) st.queued++;
+  portEXIT_CRITICAL(&s_mux);
+  return st;
+}
+
+} // namespace SMBusSched
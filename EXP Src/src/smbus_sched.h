@@ -0,0 +1,114 @@
+// smbus_sched.h
+//
+// Single owner of the Xbox SMBus (Wire). Modules never touch Wire directly;
+// they submit jobs and get a completion callback.
+//
+// - Register-read jobs: addr/reg/len (STOP-only), result bytes in the callback.
+// - Sequence jobs: a function that runs with exclusive bus access and may use
+//   the read* primitives below (for multi-step probes like encoder detection).
+//
+// The scheduler runs at most one job per service() call and enforces:
+//   * startup grace, a minimum gap between jobs,
+//   * a global bus-duty budget (token bucket on measured bus time),
+//   * per-job retries and deadlines, and exponential backoff on bus errors.
+//
+// After startTask(), service() and all completion callbacks run on a pinned
+// FreeRTOS task, so bus waits never stall the Arduino loop. submit() may be
+// called from any task.
+#pragma once
+#include <Arduino.h>
+
+namespace SMBusSched {
+
+  enum Result : int8_t {
+    RES_OK      = 0,
+    RES_ERR     = -1,   // NACK/short read after all retries
+    RES_EXPIRED = -2    // deadline passed before the job could run
+  };
+
+  // Lower value runs first
+  enum Prio : uint8_t {
+    PRIO_HIGH   = 0,    // live readings (temps, fan)
+    PRIO_NORMAL = 1,    // extended status
+    PRIO_LOW    = 2     // one-shot bulk reads (EEPROM)
+  };
+
+  enum Flags : uint8_t {
+    FLAG_NONE  = 0,
+    FLAG_PROBE = 0x01   // NACK is an answer, not a bus fault: no retry/backoff
+  };
+
+  // Sequence body: runs with the bus held; return true on success
+  typedef bool (*SeqFn)(void *ctx);
+  // Completion: data/len valid for register reads with RES_OK (null for sequences)
+  typedef void (*DoneFn)(void *ctx, Result res, const uint8_t *data, uint8_t len);
+
+  struct Job {
+    uint8_t  addr     = 0;
+    uint8_t  reg      = 0;
+    uint8_t  len      = 1;           // 1..32 for register reads
+    uint8_t  prio     = PRIO_NORMAL;
+    uint8_t  retries  = 1;           // extra attempts after the first failure
+    uint8_t  flags    = FLAG_NONE;
+    uint32_t deadline = 0;           // millis(); 0 = no deadline
+    SeqFn    seq      = nullptr;     // set => sequence job
+    DoneFn   done     = nullptr;
+    void    *ctx      = nullptr;
+  };
+
+  struct Stats {
+    uint32_t jobsOk;
+    uint32_t jobsFailed;
+    uint32_t jobsExpired;
+    uint32_t retries;
+    uint32_t transactions;    // register-pointer + read pairs issued
+    uint32_t busBusySkips;    // bus lines not idle when a job was due
+    uint32_t recoveries;      // backend resets after a wedged bus
+    uint32_t busyUs;          // total measured bus time
+    uint32_t backoffMs;       // total time spent in error backoff
+    uint32_t firstOkMs;       // begin() -> first successful job (0 = none yet)
+    uint32_t uptimeMs;        // since begin(), for duty / rate math
+    uint32_t clockHz;         // configured SMBUS_I2C_CLOCK_HZ
+    uint8_t  queued;
+  };
+
+  // Bus backend: the Wire driver by default; a virtual bus can be swapped in
+  // (see smbus_virtual.h) to exercise the stack without a console.
+  struct Backend {
+    const char *name;
+    // Set register pointer then read len bytes; rs = repeated-start. 0 on success.
+    int  (*read)(uint8_t addr, uint8_t reg, uint8_t *out, size_t len, bool rs);
+    // True once SDA/SCL have been idle (high); wait at most maxWaitMs
+    bool (*idle)(uint32_t maxWaitMs);
+    // Re-init after the bus looked wedged
+    void (*reset)();
+  };
+
+  // Call before startTask(); nullptr restores the Wire backend
+  void setBackend(const Backend *backend);
+
+  // Configure Wire on the given pins (no internal pullups) and reset pacing
+  void begin(uint8_t sdaPin, uint8_t sclPin);
+
+  // Queue a job from any task; false if the table is full
+  bool submit(const Job &job);
+
+  // Run at most one due job (the SMBus task calls this; only call it
+  // directly if startTask() is not used)
+  void service();
+
+  // Producers run on the SMBus task before each service() pass
+  typedef void (*TickFn)();
+
+  // Start the pinned SMBus task. Call once from setup(), after begin().
+  bool startTask(TickFn producers = nullptr);
+
+  // ---- Bus primitives: ONLY valid inside a SeqFn ----
+  int readByte(uint8_t addr, uint8_t reg, uint8_t &value);          // STOP-only
+  int readWord(uint8_t addr, uint8_t reg, uint16_t &value);         // STOP-only, MSB first
+  int readWordRS(uint8_t addr, uint8_t reg, uint16_t &value);       // repeated-start, LSB first
+  int readBlock(uint8_t addr, uint8_t reg, uint8_t *out, size_t len);
+
+  uint32_t lastActivityMs();  // last time a transaction completed (0 = never)
+  Stats getStats();
+}
@@ -0,0 +1,137 @@
+// smbus_sniff.cpp
+//
+// Capture: a pinned task busy-samples GPIO_IN and feeds level changes to
+// I2CDecoder. When the bus has been idle for SMBUS_SNIFF_IDLE_US it sleeps
+// one tick so lower-priority work on the core can run; a transaction that
+// starts during that tick is lost (the decoder drops the partial frame) and
+// the next periodic read by the console is used instead.
+//
+// Only SMC reads are fed onward (CPU/board temp, fan). Encoder and EEPROM
+// traffic is decoded and counted; the console reads those mostly at boot.
+
+#include "smbus_sniff.h"
+
+#if SMBUS_PASSIVE_SNIFF
+
+#include "i2c_decoder.h"
+#include "xbox_smbus_poll.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "soc/soc.h"
+#include "soc/gpio_reg.h"
+
+#ifndef SMBUS_SNIFF_TASK_CORE
+#define SMBUS_SNIFF_TASK_CORE      0
+#endif
+#ifndef SMBUS_SNIFF_TASK_PRIO
+#define SMBUS_SNIFF_TASK_PRIO      1   // below WiFi; preemption costs a frame, not the link
+#endif
+#ifndef SMBUS_SNIFF_IDLE_US
+#define SMBUS_SNIFF_IDLE_US     3000   // bus idle this long -> sleep one tick
+#endif
+#ifndef SMBUS_SNIFF_RECORD_EDGES
+#define SMBUS_SNIFF_RECORD_EDGES 1024  // power of two
+#endif
+
+namespace SMBusSniff {
+
+struct Edge {
+  uint32_t us;
+  uint8_t  lines;   // bit0 = SDA, bit1 = SCL
+};
+
+static uint32_t   s_sda_mask = 0, s_scl_mask = 0;
+static I2CDecoder s_dec;
+static Stats      s_stats = {};
+static Edge       s_ring[SMBUS_SNIFF_RECORD_EDGES];
+static uint32_t   s_ring_pos = 0;     // total edges recorded
+static TaskHandle_t s_task = nullptr;
+
+static void on_txn(const I2CTransaction &t, void *) {
+  s_stats.transactions++;
+  if (XboxSMBusPoll::observe(t.addr, t.reg, t.data, t.len, t.write)) s_stats.fed++;
+}
+
+static void sniff_task(void *) {
+  uint32_t last = REG_READ(GPIO_IN_REG);
+  uint32_t lastEdgeUs = micros();
+
+  for (;;) {
+    const uint32_t in = REG_READ(GPIO_IN_REG);
+    if ((in ^ last) & (s_sda_mask | s_scl_mask)) {
+      last = in;
+      const bool sda = (in & s_sda_mask) != 0;
+      const bool scl = (in & s_scl_mask) != 0;
+      lastEdgeUs = micros();
+
+      Edge &e = s_ring[s_ring_pos++ & (SMBUS_SNIFF_RECORD_EDGES - 1)];
+      e.us    = lastEdgeUs;
+      e.lines = (uint8_t)((sda ? 1 : 0) | (scl ? 2 : 0));
+
+      s_stats.edges++;
+      s_dec.feed(sda, scl);
+      continue;
+    }
+
+    // Idle bus (both lines high, nothing for a while): give the core back
+    if ((in & s_sda_mask) && (in & s_scl_mask) &&
+        (micros() - lastEdgeUs) >= SMBUS_SNIFF_IDLE_US) {
+      s_stats.sleeps++;
+      vTaskDelay(1);
+      last = REG_READ(GPIO_IN_REG);
+      lastEdgeUs = micros();
+    }
+  }
+}
+
+bool begin(uint8_t sdaPin, uint8_t sclPin) {
+  if (s_task) return true;
+  if (sdaPin > 31 || sclPin > 31) {
+    Serial.println("[Sniff] Pins must be GPIO0..31");
+    return false;
+  }
+  pinMode(sdaPin, INPUT);   // observe only; the Xbox provides pullups
+  pinMode(sclPin, INPUT);
+  s_sda_mask = 1u << sdaPin;
+  s_scl_mask = 1u << sclPin;
+  s_dec.setSink(on_txn, nullptr);
+
+  if (xTaskCreatePinnedToCore(sniff_task, "sniff", 4096, nullptr,
+                              SMBUS_SNIFF_TASK_PRIO, &s_task, SMBUS_SNIFF_TASK_CORE) != pdPASS) {
+    s_task = nullptr;
+    Serial.println("[Sniff] Failed to start capture task");
+    return false;
+  }
+  Serial.println("[Sniff] Passive SMBus capture running");
+  return true;
+}
+
+Stats getStats() {
+  Stats st = s_stats;
+  const I2CDecoder::Stats &d = s_dec.stats();
+  st.nacks   = d.nacks;
+  st.aborted = d.aborted;
+  return st;
+}
+
+void dumpCapture(Print &out) {
+  const uint32_t end = s_ring_pos;
+  const uint32_t n = end < SMBUS_SNIFF_RECORD_EDGES ? end : SMBUS_SNIFF_RECORD_EDGES;
+  out.printf("# %lu edges (us sda scl)\n", (unsigned long)n);
+  for (uint32_t i = end - n; i != end; ++i) {
+    const Edge e = s_ring[i & (SMBUS_SNIFF_RECORD_EDGES - 1)];
+    out.printf("%lu %u %u\n", (unsigned long)e.us, e.lines & 1, (e.lines >> 1) & 1);
+  }
+}
+
+} // namespace SMBusSniff
+
+#else  // !SMBUS_PASSIVE_SNIFF
+
+namespace SMBusSniff {
+bool  begin(uint8_t, uint8_t) { return false; }
+Stats getStats() { return Stats(); }
+void  dumpCapture(Print &out) { out.println("# passive sniff disabled"); }
+}
+
+#endif
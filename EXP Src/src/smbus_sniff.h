@@ -0,0 +1,35 @@
+// smbus_sniff.h
+//
+// Passive SMBus mode: never drives the bus. A capture task samples SDA/SCL,
+// decodes frames in software (i2c_decoder.h) and feeds the console's own SMC
+// temperature/fan reads into XboxSMBusPoll's published snapshot.
+//
+// Enabled with -DSMBUS_PASSIVE_SNIFF=1 (the active scheduler is then not
+// started). The last SMBUS_SNIFF_RECORD_EDGES line changes are kept so a
+// capture can be dumped over serial and replayed through I2CDecoder offline.
+#pragma once
+#include <Arduino.h>
+
+#ifndef SMBUS_PASSIVE_SNIFF
+#define SMBUS_PASSIVE_SNIFF 0
+#endif
+
+namespace SMBusSniff {
+
+  struct Stats {
+    uint32_t edges;          // line changes seen
+    uint32_t transactions;   // decoded register reads/writes
+    uint32_t fed;            // of which fed into the status snapshot
+    uint32_t nacks;
+    uint32_t aborted;        // partial frames (missed edges, glitches)
+    uint32_t sleeps;         // capture pauses while the bus was idle
+  };
+
+  // Start the capture task on the given pins (inputs, no pullups)
+  bool begin(uint8_t sdaPin, uint8_t sclPin);
+
+  Stats getStats();
+
+  // Print the recorded edge ring as "<us> <sda> <scl>" lines (oldest first)
+  void dumpCapture(Print &out);
+}
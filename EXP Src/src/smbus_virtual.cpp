@@ -0,0 +1,227 @@
+// smbus_virtual.cpp
+//
+// In-memory device models behind SMBusSched::Backend (see smbus_virtual.h).
+// Compiled out unless SMBUS_VIRTUAL_XBOX=1.
+
+#include "smbus_virtual.h"
+
+#if SMBUS_VIRTUAL_XBOX
+
+#include <mbedtls/md.h>
+
+#ifndef SMBUS_VIRTUAL_CLOCK_HZ
+#define SMBUS_VIRTUAL_CLOCK_HZ      55000
+#endif
+#ifndef SMBUS_VIRTUAL_BOOT_MS
+#define SMBUS_VIRTUAL_BOOT_MS        5000
+#endif
+#ifndef SMBUS_VIRTUAL_NACK_PERMILLE
+#define SMBUS_VIRTUAL_NACK_PERMILLE     0
+#endif
+#ifndef SMBUS_VIRTUAL_STUCK_EVERY_S
+#define SMBUS_VIRTUAL_STUCK_EVERY_S     0   // 0 = never
+#endif
+#ifndef SMBUS_VIRTUAL_STUCK_MS
+#define SMBUS_VIRTUAL_STUCK_MS        200
+#endif
+#ifndef SMBUS_VIRTUAL_STRETCH_US
+#define SMBUS_VIRTUAL_STRETCH_US        0
+#endif
+
+// Same addresses the real modules use
+#define V_SMC       0x10
+#define V_CONEXANT  0x45
+#define V_FOCUS     0x6A
+#define V_XCALIBUR  0x70
+#define V_EEPROM    0x54
+
+namespace SMBusVirtual {
+
+const uint8_t HDD_KEY[16] = { 0x48,0x44,0x44,0x2D,0x56,0x49,0x52,0x54,0x55,0x41,0x4C,0x2D,0x4B,0x45,0x59,0x31 };
+
+static Profile  s_profile = PROFILE_V10_CONEXANT;
+static uint32_t s_boot_ms = 0;
+static uint8_t  s_eeprom[256];
+
+// ---------- Device models ----------
+// Slow thermal drift plus a 60 s "load spike" every 10 min
+static int cpu_temp(uint32_t t) {
+  const int base = 45 + (int)((t / 20000) % 6);          // 45..50, steps every 20 s
+  return ((t / 60000) % 10 == 9) ? 68 : base;
+}
+static int board_temp(uint32_t t) { return cpu_temp(t) - 12; }
+static int fan_raw(uint32_t t)    { return cpu_temp(t) >= 60 ? 40 : 20; }   // 0..50
+
+static bool smc_reg(uint8_t reg, uint8_t &v, uint32_t t) {
+  switch (reg) {
+    case 0x00: v = (s_profile == PROFILE_V16_XCALIBUR) ? 0xFF
+                 : (s_profile == PROFILE_V14_FOCUS) ? 4 : 1; return true;  // console version
+    case 0x01: v = 0x50; return true;                    // PIC version
+    case 0x03: v = 0x60; return true;                    // tray closed, media present
+    case 0x04: v = 0x06; return true;                    // AV pack: HDTV component
+    case 0x09: v = (uint8_t)cpu_temp(t);   return true;
+    case 0x0A: v = (uint8_t)board_temp(t); return true;
+    case 0x10: v = (uint8_t)fan_raw(t);    return true;
+    default:   return false;
+  }
+}
+
+// Focus FS454 word registers, sent LSB first (STOP readers see them swapped)
+static uint16_t focus_word(uint8_t reg) {
+  switch (reg) {
+    case 0x32: return 0xFE05;                            // PID
+    case 0x92: return (1u << 12);                        // VID_CNTL0: HDTV, progressive -> 720p
+    case 0xBA: return 1280;                              // HACT_WD
+    case 0xBE: return 720;                               // VACT_HT
+    case 0x57: return 525;                               // NL
+    case 0x71: return 858;                               // NP
+    default:   return 0;
+  }
+}
+
+static bool device_present(uint8_t addr) {
+  switch (addr) {
+    case V_SMC:
+    case V_EEPROM:   return true;
+    case V_CONEXANT: return s_profile == PROFILE_V10_CONEXANT;
+    case V_FOCUS:    return s_profile == PROFILE_V14_FOCUS;
+    case V_XCALIBUR: return s_profile == PROFILE_V16_XCALIBUR;
+    default:         return false;
+  }
+}
+
+static bool fill(uint8_t addr, uint8_t reg, uint8_t *out, size_t len, uint32_t t) {
+  for (size_t i = 0; i < len; ++i) {
+    uint8_t v = 0;
+    switch (addr) {
+      case V_SMC:
+        if (!smc_reg((uint8_t)(reg + i), v, t)) return false;
+        break;
+      case V_EEPROM:
+        v = s_eeprom[(uint8_t)(reg + i)];                // auto-increment, wraps
+        break;
+      case V_CONEXANT:
+        v = (reg == 0x2E) ? 0x82 : 0x00;                 // HDTV_EN + RASTER_SEL=720p
+        break;
+      case V_XCALIBUR:
+        v = (reg == 0x1C) ? 0x04 : 0x00;                 // mode code 4 = 720p
+        break;
+      case V_FOCUS: {
+        const uint16_t w = focus_word(reg);
+        v = (i & 1) ? (uint8_t)(w >> 8) : (uint8_t)(w & 0xFF);
+        break;
+      }
+    }
+    out[i] = v;
+  }
+  return true;
+}
+
+// ---------- EEPROM factory section ----------
+// Sealed the way the console's kernel does it, with the key revision that
+// matches the profile: checksum = HMAC-SHA1(key, plain), RC4 key =
+// HMAC-SHA1(key, checksum), section = RC4(plain). eeprom_min must find the
+// revision and recover HDD_KEY.
+static const uint8_t kEepromKeys[3][16] = {
+  { 0x2A,0x3B,0xAD,0x2C,0xB1,0x94,0x4F,0x93,0xAA,0xCD,0xCD,0x7E,0x0A,0xC2,0xEE,0x5A },  // 1.0
+  { 0x1D,0xF3,0x5C,0x83,0x8E,0xC9,0xB6,0xFC,0xBD,0xF6,0x61,0xAB,0x4F,0x06,0x33,0xE4 },  // 1.1-1.5
+  { 0x2B,0x84,0x57,0xBE,0x9B,0x1E,0x65,0xC6,0xCD,0x9D,0x2B,0xCE,0xC1,0xA2,0x09,0x61 },  // 1.6
+};
+
+static bool hmac_sha1(const uint8_t *key, const uint8_t *msg, size_t len, uint8_t out[20]) {
+  const mbedtls_md_info_t *info = mbedtls_md_info_from_type(MBEDTLS_MD_SHA1);
+  return info && mbedtls_md_hmac(info, key, 16, msg, len, out) == 0;
+}
+
+static void rc4(const uint8_t *key, size_t klen, uint8_t *buf, size_t len) {
+  uint8_t S[256];
+  for (int n = 0; n < 256; ++n) S[n] = (uint8_t)n;
+  uint8_t j = 0;
+  for (int n = 0; n < 256; ++n) {
+    j = (uint8_t)(j + S[n] + key[n % klen]);
+    const uint8_t t = S[n]; S[n] = S[j]; S[j] = t;
+  }
+  uint8_t i = 0;
+  j = 0;
+  for (size_t n = 0; n < len; ++n) {
+    i = (uint8_t)(i + 1);
+    j = (uint8_t)(j + S[i]);
+    const uint8_t t = S[i]; S[i] = S[j]; S[j] = t;
+    buf[n] ^= S[(uint8_t)(S[i] + S[j])];
+  }
+}
+
+static void seal_factory(Profile profile) {
+  const uint8_t *key = kEepromKeys[profile];
+  uint8_t plain[0x1C];                                   // confounder(8) + HDD key(16) + pad(4)
+  for (int i = 0; i < 8; ++i) plain[i] = (uint8_t)(0xC0 + i);
+  memcpy(&plain[8], HDD_KEY, sizeof(HDD_KEY));
+  memset(&plain[24], 0, 4);
+
+  uint8_t chk[20], rc4key[20];
+  if (!hmac_sha1(key, plain, sizeof(plain), chk) || !hmac_sha1(key, chk, sizeof(chk), rc4key)) return;
+  rc4(rc4key, sizeof(rc4key), plain, sizeof(plain));
+  memcpy(&s_eeprom[0x00], chk, sizeof(chk));
+  memcpy(&s_eeprom[0x14], plain, sizeof(plain));
+}
+
+// ---------- Backend ----------
+static bool lines_stuck(uint32_t now) {
+#if SMBUS_VIRTUAL_STUCK_EVERY_S > 0
+  return ((now - s_boot_ms) % (SMBUS_VIRTUAL_STUCK_EVERY_S * 1000UL)) < SMBUS_VIRTUAL_STUCK_MS;
+#else
+  (void)now;
+  return false;
+#endif
+}
+
+static int v_read(uint8_t addr, uint8_t reg, uint8_t *out, size_t len, bool rs) {
+  // Wire time: address+reg, address+data bytes, 9 bits each (+ STOP/START gap)
+  const uint32_t bits = (uint32_t)(4 + len) * 9;
+  delayMicroseconds(bits * 1000000UL / SMBUS_VIRTUAL_CLOCK_HZ + SMBUS_VIRTUAL_STRETCH_US);
+  (void)rs;
+
+  const uint32_t now = millis();
+  if ((now - s_boot_ms) < SMBUS_VIRTUAL_BOOT_MS) return -1;       // console still booting
+  if (lines_stuck(now)) return -1;
+  if (!device_present(addr)) return -1;                           // NACK
+#if SMBUS_VIRTUAL_NACK_PERMILLE > 0
+  if ((esp_random() % 1000) < SMBUS_VIRTUAL_NACK_PERMILLE) return -1;
+#endif
+  return fill(addr, reg, out, len, now - s_boot_ms) ? 0 : -1;
+}
+
+static bool v_idle(uint32_t maxWaitMs) {
+  const uint32_t start = millis();
+  while (lines_stuck(millis())) {
+    if ((millis() - start) >= maxWaitMs) return false;
+    delay(1);
+  }
+  return true;
+}
+
+static void v_reset() {
+  Serial.println("[SMBusVirtual] Bus reset");
+}
+
+static const SMBusSched::Backend kBackend = { "virtual-xbox", v_read, v_idle, v_reset };
+
+const SMBusSched::Backend *backend(Profile profile) {
+  s_profile = profile;
+  s_boot_ms = millis();
+
+  // Recognisable EEPROM: sealed factory section (HDD key), serial, MAC and
+  // region where eeprom_min looks
+  for (int i = 0; i < 256; ++i) s_eeprom[i] = (uint8_t)(i * 7 + 3);
+  seal_factory(profile);
+  memcpy(&s_eeprom[0x34], "VIRTUAL00001", 12);
+  static const uint8_t mac[6] = { 0x00, 0x50, 0xF2, 0x12, 0x34, 0x56 };
+  memcpy(&s_eeprom[0x40], mac, sizeof(mac));
+  s_eeprom[0x58] = 0x00;                                 // NTSC-U
+
+  return &kBackend;
+}
+
+} // namespace SMBusVirtual
+
+#endif // SMBUS_VIRTUAL_XBOX
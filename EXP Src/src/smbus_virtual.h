@@ -0,0 +1,38 @@
+// smbus_virtual.h
+//
+// Virtual Original-Xbox SMBus for bench runs without a console.
+// Build with -DSMBUS_VIRTUAL_XBOX=1 and the scheduler is pointed at an
+// in-memory bus instead of Wire: SMC @0x10, one video encoder for the chosen
+// revision (Conexant 0x45 / Focus 0x6A / Xcalibur 0x70) and a 24C02 @0x54
+// whose factory section is encrypted with that revision's EEPROM key.
+//
+// Scripted faults (all optional, off by default):
+//   SMBUS_VIRTUAL_BOOT_MS        devices NACK until the "console" has booted
+//   SMBUS_VIRTUAL_NACK_PERMILLE  random NACK rate
+//   SMBUS_VIRTUAL_STUCK_EVERY_S  lines held low for SMBUS_VIRTUAL_STUCK_MS every N s
+//   SMBUS_VIRTUAL_STRETCH_US     extra clock-stretch per transaction
+//
+// Transfer time is modelled at SMBUS_VIRTUAL_CLOCK_HZ, so SMBusSched's duty,
+// transaction-rate and time-to-first-reading stats stay meaningful.
+#pragma once
+#include <Arduino.h>
+#include "smbus_sched.h"
+
+#ifndef SMBUS_VIRTUAL_XBOX
+#define SMBUS_VIRTUAL_XBOX 0
+#endif
+
+namespace SMBusVirtual {
+
+  enum Profile : uint8_t {
+    PROFILE_V10_CONEXANT = 0,   // 1.0–1.3
+    PROFILE_V14_FOCUS    = 1,   // 1.4–1.5
+    PROFILE_V16_XCALIBUR = 2    // 1.6/1.6b
+  };
+
+  // Backend for SMBusSched::setBackend()
+  const SMBusSched::Backend *backend(Profile profile);
+
+  // HDD key sealed in the virtual EEPROM (what eeprom_min should recover)
+  extern const uint8_t HDD_KEY[16];
+}
@@ -0,0 +1,216 @@
+// udp_mux.cpp
+
+#include "udp_mux.h"
+#include <WiFi.h>
+#include <WiFiUdp.h>
+#include <string.h>
+
+// Listening ports (each needs its own socket); the first one also sends
+#ifndef UDP_MUX_MAX_PORTS
+#define UDP_MUX_MAX_PORTS      2
+#endif
+#ifndef UDP_MUX_MAX_HANDLERS
+#define UDP_MUX_MAX_HANDLERS   6
+#endif
+// Per queue bank (two banks: producers fill one while loop() sends the other)
+#ifndef UDP_MUX_QUEUE_LEN
+#define UDP_MUX_QUEUE_LEN      12
+#endif
+#ifndef UDP_MUX_ARENA_BYTES
+#define UDP_MUX_ARENA_BYTES    3072
+#endif
+// Datagrams handled per loop() so a flood can't starve the loop
+#ifndef UDP_MUX_RX_BUDGET
+#define UDP_MUX_RX_BUDGET      4
+#endif
+#ifndef UDP_MUX_RX_MAX
+#define UDP_MUX_RX_MAX         256
+#endif
+
+namespace UDPMux {
+
+struct Listener {
+  uint16_t port;
+  bool     bound;
+  WiFiUDP  sock;
+};
+
+struct Route {
+  uint16_t    port;
+  const char *prefix;
+  uint8_t     prefixLen;
+  Handler     fn;
+  void       *ctx;
+};
+
+struct Entry {
+  uint16_t port;      // 0 = coalesced away
+  uint8_t  key;
+  uint16_t off;
+  uint16_t len;
+};
+
+struct Bank {
+  Entry    q[UDP_MUX_QUEUE_LEN];
+  uint8_t  n;
+  uint16_t used;
+  uint8_t  arena[UDP_MUX_ARENA_BYTES];
+};
+
+static Listener s_listen[UDP_MUX_MAX_PORTS];
+static uint8_t  s_nlisten = 0;
+static Route    s_routes[UDP_MUX_MAX_HANDLERS];
+static uint8_t  s_nroutes = 0;
+static WiFiUDP  s_txonly;             // only if nothing listens
+static bool     s_txonly_bound = false;
+
+static Bank     s_bank[2];
+static uint8_t  s_active = 0;         // bank producers append to
+static portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED;   // guards s_bank/s_active
+
+static Stats    s_stats = {};
+
+bool on(uint16_t port, const char *prefix, Handler fn, void *ctx) {
+  if (!fn || s_nroutes >= UDP_MUX_MAX_HANDLERS) return false;
+
+  bool have = false;
+  for (uint8_t i = 0; i < s_nlisten; ++i) have |= (s_listen[i].port == port);
+  if (!have) {
+    if (s_nlisten >= UDP_MUX_MAX_PORTS) return false;
+    s_listen[s_nlisten].port  = port;
+    s_listen[s_nlisten].bound = false;
+    s_nlisten++;
+  }
+
+  Route &r = s_routes[s_nroutes++];
+  r.port      = port;
+  r.prefix    = prefix ? prefix : "";
+  r.prefixLen = (uint8_t)strlen(r.prefix);
+  r.fn        = fn;
+  r.ctx       = ctx;
+  return true;
+}
+
+bool send(uint16_t port, const void *data, size_t len, uint8_t key) {
+  if (!port || !data || !len || len > UDP_MUX_ARENA_BYTES) return false;
+
+  bool ok = false;
+  portENTER_CRITICAL(&s_mux);
+  Bank &b = s_bank[s_active];
+  if (key != KEY_NONE) {
+    for (uint8_t i = 0; i < b.n; ++i) {
+      if (b.q[i].port == port && b.q[i].key == key) {
+        b.q[i].port = 0;            // arena space comes back on flush
+        s_stats.txCoalesced++;
+      }
+    }
+  }
+  if (b.n < UDP_MUX_QUEUE_LEN && b.used + len <= UDP_MUX_ARENA_BYTES) {
+    Entry &e = b.q[b.n++];
+    e.port = port;
+    e.key  = key;
+    e.off  = b.used;
+    e.len  = (uint16_t)len;
+    memcpy(b.arena + b.used, data, len);
+    b.used += len;
+    ok = true;
+  } else {
+    s_stats.txDropped++;
+  }
+  portEXIT_CRITICAL(&s_mux);
+  return ok;
+}
+
+bool send(uint16_t port, const String &text, uint8_t key) {
+  return send(port, text.c_str(), text.length(), key);
+}
+
+static void bind_sockets() {
+  for (uint8_t i = 0; i < s_nlisten; ++i) {
+    Listener &l = s_listen[i];
+    if (!l.bound && l.sock.begin(l.port)) {
+      l.bound = true;
+      s_stats.sockets++;
+    }
+  }
+  if (!s_nlisten && !s_txonly_bound && s_txonly.begin(0)) {
+    s_txonly_bound = true;
+    s_stats.sockets++;
+  }
+}
+
+static WiFiUDP *tx_socket() {
+  if (s_nlisten) return s_listen[0].bound ? &s_listen[0].sock : nullptr;
+  return s_txonly_bound ? &s_txonly : nullptr;
+}
+
+static void dispatch(uint16_t port, const char *msg, size_t len, const IPAddress &from) {
+  const Route *best = nullptr;
+  for (uint8_t i = 0; i < s_nroutes; ++i) {
+    const Route &r = s_routes[i];
+    if (r.port != port || r.prefixLen > len) continue;
+    if (strncmp(msg, r.prefix, r.prefixLen) != 0) continue;
+    if (!best || r.prefixLen > best->prefixLen) best = &r;
+  }
+  if (best) best->fn(msg, len, from, best->ctx);
+  else      s_stats.rxUnhandled++;
+}
+
+static void receive() {
+  char buf[UDP_MUX_RX_MAX + 1];
+  for (uint8_t i = 0; i < s_nlisten; ++i) {
+    Listener &l = s_listen[i];
+    if (!l.bound) continue;
+    for (uint8_t n = 0; n < UDP_MUX_RX_BUDGET; ++n) {
+      if (l.sock.parsePacket() <= 0) break;
+      const int got = l.sock.read(buf, UDP_MUX_RX_MAX);
+      if (got < 0) continue;
+      buf[got] = 0;
+      s_stats.rxPackets++;
+      dispatch(l.port, buf, (size_t)got, l.sock.remoteIP());
+    }
+  }
+}
+
+static void flush() {
+  // Swap banks so producers never wait on the network
+  portENTER_CRITICAL(&s_mux);
+  Bank &b = s_bank[s_active];
+  s_active ^= 1;
+  portEXIT_CRITICAL(&s_mux);
+  if (!b.n) return;
+
+  WiFiUDP *u = tx_socket();
+  for (uint8_t i = 0; i < b.n; ++i) {
+    const Entry &e = b.q[i];
+    if (!e.port) continue;
+    if (u && u->beginPacket(IPAddress(255, 255, 255, 255), e.port)) {
+      u->write(b.arena + e.off, e.len);
+      if (u->endPacket()) { s_stats.txDatagrams++; continue; }
+    }
+    s_stats.txDropped++;
+  }
+  b.n = 0;
+  b.used = 0;
+}
+
+void loop() {
+  if (WiFi.status() != WL_CONNECTED) {
+    // Nothing can go out; drop stale datagrams instead of replaying them later
+    portENTER_CRITICAL(&s_mux);
+    Bank &b = s_bank[s_active];
+    b.n = 0;
+    b.used = 0;
+    portEXIT_CRITICAL(&s_mux);
+    return;
+  }
+  bind_sockets();
+  receive();
+  flush();
+}
+
+Stats getStats() {
+  return s_stats;
+}
+
+} // namespace UDPMux
@@ -0,0 +1,50 @@
+// udp_mux.h
+//
+// The EXP board's only UDP endpoint. Modules never own a WiFiUDP:
+//
+// - Receive: on(port, prefix, handler) registers a handler; loop() drains each
+//   listening socket and dispatches every datagram to the handler with the
+//   longest matching prefix ("" matches anything).
+// - Send: send() copies a datagram into a queue (any task, never blocks) and
+//   loop() flushes the whole queue in one burst. A keyed datagram replaces a
+//   queued one with the same port+key, so a superseded status never goes out.
+//
+// Each datagram stays one message on the wire (receivers parse one struct or
+// line per packet); batching here means one socket and one flush per tick.
+#pragma once
+#include <Arduino.h>
+
+namespace UDPMux {
+
+  // msg is NUL-terminated (binary payloads still get len)
+  typedef void (*Handler)(const char *msg, size_t len, const IPAddress &from, void *ctx);
+
+  // Coalescing keys (0 = never replaced)
+  enum Key : uint8_t {
+    KEY_NONE   = 0,
+    KEY_STATUS = 1,   // 50504 core status
+    KEY_EXT    = 2,   // 50505 extended status
+    KEY_BEACON = 3,   // TYPE_D_ID beacon
+    KEY_HEALTH = 4    // SMBH diagnostics
+  };
+
+  // Register during setup(); sockets bind once WiFi is up. false if full.
+  bool on(uint16_t port, const char *prefix, Handler fn, void *ctx = nullptr);
+
+  // Queue a broadcast datagram from any task; false if the queue is full
+  bool send(uint16_t port, const void *data, size_t len, uint8_t key = KEY_NONE);
+  bool send(uint16_t port, const String &text, uint8_t key = KEY_NONE);
+
+  // Loop task: receive + dispatch, then flush the queue
+  void loop();
+
+  struct Stats {
+    uint32_t rxPackets;
+    uint32_t rxUnhandled;   // no handler matched
+    uint32_t txDatagrams;
+    uint32_t txCoalesced;   // replaced before they were sent
+    uint32_t txDropped;     // queue full or send failed
+    uint8_t  sockets;
+  };
+  Stats getStats();
+}
@@ -1,13 +1,12 @@
 #include "udp_stat.h"
-#include <WiFiUdp.h>
+#include "udp_mux.h"
 #include "cache_manager.h" // For XboxStatus
 #include <WiFi.h>
 #include "led_stat.h"
+#include "smbus_sched.h"
 #include <string.h>
 #include <Arduino.h>
 
-// ---- exported by xbox_smbus_poll.cpp ----
-extern uint32_t smbus_last_activity_ms();
 
 // ====== Config ======
 #define UDP_PORT                 50504
@@ -34,14 +33,18 @@ extern uint32_t smbus_last_activity_ms();
 #define ID_BROADCAST_INTERVAL_MS   1500   // ~1.5s nominal + jitter
 #endif
 
+// Type D device ID of the EXP board. Displays lease IDs 1..64 and skip this
+// one (DETECT_ID_RESERVED in the display's detect.cpp) -- keep them in sync.
+#ifndef TYPE_D_EXP_ID
+#define TYPE_D_EXP_ID              6
+#endif
+
 // Blink timings
 static const unsigned long blinkDuration = 2000; // blink for 2s when we send
 static const unsigned long blinkPeriod   = 150;  // blink on/off cycle
 
 // ====== State ======
-static WiFiUDP udp;
-
-static const uint8_t  STATIC_ID = 6; // Type D device ID
+static const uint8_t  STATIC_ID = TYPE_D_EXP_ID; // Type D device ID
 
 static unsigned long  nextDataCheck = 0;
 static unsigned long  nextIdBeacon  = 0;
@@ -52,8 +55,8 @@ static unsigned long  udpBlinkStart = 0;
 static unsigned long  lastBlink = 0;
 static bool           blinkState = false;
 
-// Keep last-sent to avoid spamming unchanged data
-static XboxStatus g_last_sent = {0};
+// Generation of the last status sent (Cache_Manager starts at 1 after begin())
+static uint32_t g_last_gen = 0;
 
 // ====== Helpers ======
 static inline unsigned long jitter_ms(unsigned long maxJ) {
@@ -61,32 +64,22 @@ static inline unsigned long jitter_ms(unsigned long maxJ) {
 }
 
 static inline bool bus_quiet_enough() {
-  const uint32_t last = smbus_last_activity_ms();
+  const uint32_t last = SMBusSched::lastActivityMs();
   const uint32_t now  = millis();
   // guard if last==0 (no activity yet) -> treat as quiet
   if (last == 0) return true;
   return (now - last) >= SMBUS_QUIET_BEFORE_UDP_MS;
 }
 
-static bool status_changed(const XboxStatus& a, const XboxStatus& b) {
-  if (a.fanSpeed    != b.fanSpeed)    return true;
-  if (a.cpuTemp     != b.cpuTemp)     return true;
-  if (a.ambientTemp != b.ambientTemp) return true;
-  if (strncmp(a.currentApp, b.currentApp, sizeof(a.currentApp)) != 0) return true;
-  return false;
-}
-
 static bool udpHasData() {
-  const XboxStatus& cur = Cache_Manager::getStatus();
-  return status_changed(cur, g_last_sent);
+  return Cache_Manager::generation() != g_last_gen;
 }
 
 static void sendUdpPacket() {
-  const XboxStatus& st = Cache_Manager::getStatus();
-  udp.beginPacket("255.255.255.255", UDP_PORT);
-  udp.write(reinterpret_cast<const uint8_t*>(&st), sizeof(XboxStatus));
-  udp.endPacket();
-  g_last_sent = st; // mark as flushed
+  XboxStatus st;
+  const uint32_t gen = Cache_Manager::getSnapshot(st);
+  UDPMux::send(UDP_PORT, &st, sizeof(XboxStatus), UDPMux::KEY_STATUS);
+  g_last_gen = gen; // mark as flushed
 #if UDP_STAT_DEBUG
   Serial.println("[UDPStat] Sent status packet.");
 #endif
@@ -154,10 +147,9 @@ void UDPStat::loop() {
     nextIdBeacon = now + ID_BROADCAST_INTERVAL_MS + jitter_ms(UDP_JITTER_MAX_MS);
 
     if (WiFi.status() == WL_CONNECTED && bus_quiet_enough()) {
-      udp.beginPacket("255.255.255.255", ID_BROADCAST_PORT);
-      udp.print("TYPE_D_ID:");
-      udp.print(STATIC_ID);
-      udp.endPacket();
+      char id[16];
+      const int n = snprintf(id, sizeof(id), "TYPE_D_ID:%u", (unsigned)STATIC_ID);
+      UDPMux::send(ID_BROADCAST_PORT, id, (size_t)n, UDPMux::KEY_BEACON);
 #if UDP_STAT_DEBUG
       Serial.println("[UDPStat] Sent ID beacon.");
 #endif
@@ -4,6 +4,7 @@
 #include <Preferences.h>
 #include <DNSServer.h>
 #include "led_stat.h"
+#include "metrics.h"
 #include <vector>
 #include "esp_wifi.h"
 #include <Update.h> // For OTA
@@ -24,6 +25,11 @@ static const int maxAttempts = 10;
 static unsigned long lastAttempt = 0;
 static unsigned long retryDelay = 3000;
 
+static const uint8_t maxRouteFns = 4;
+static RouteFn routeFns[maxRouteFns];
+static uint8_t routeFnCount = 0;
+static bool serverStarted = false;
+
 AsyncWebServer& getServer() {
     return server;
 }
@@ -218,6 +224,8 @@ void startPortal() {
                 if (Update.write(data, len) != len) {
                     Update.printError(Serial);
                     updateError = true;
+                } else {
+                    Metrics::inc(Metrics::UPLOAD_BYTES, len);
                 }
             }
             if (final) {
@@ -356,9 +364,11 @@ void startPortal() {
     server.on("/redirect", HTTP_GET, cp);
     server.on("/ncsi.txt", HTTP_GET, cp);
     server.on("/captiveportal", HTTP_GET, cp);
+    for (uint8_t i = 0; i < routeFnCount; ++i) routeFns[i](server);
     server.onNotFound(cp);
 
     server.begin();
+    serverStarted = true;
     state = State::PORTAL;
 }
 
@@ -412,6 +422,12 @@ void loop() {
     }
 }
 
+void addRoutes(RouteFn fn) {
+    if (routeFnCount >= maxRouteFns) return;
+    routeFns[routeFnCount++] = fn;
+    if (serverStarted) fn(server);
+}
+
 void restartPortal() {
     startPortal();
 }
@@ -2,8 +2,15 @@
 
 #include <Arduino.h>
 
+class AsyncWebServer;
+
 namespace WiFiMgr {
 
+    // Extra routes (e.g. /metrics) on the port-80 server. Applied now and again
+    // whenever the portal rebuilds the server.
+    typedef void (*RouteFn)(AsyncWebServer &server);
+    void addRoutes(RouteFn fn);
+
     //AsyncWebServer& getServer();
 
     void begin();
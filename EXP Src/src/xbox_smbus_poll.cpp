@@ -1,18 +1,16 @@
 // xbox_smbus_poll.cpp
 //
-// Safe, low-jitter, read-only SMBus poller for the Original Xbox.
-// - STOP-only I2C phases by default (1.6-safe), RS is not required.
-// - Cross-core FreeRTOS mutex so only one reader runs at a time.
-// - Round-robin reads to avoid bursts (CPU, Board, Fan, Idle).
-// - Slow bus (~55 kHz), explicit inter-op gaps, exponential backoff.
-// - Light bus-idle observation (no internal pullups).
-//
-// Exports (for other modules like smbus_ext.cpp):
-//   bool     try_lock_smbus();        // legacy wrapper on top of mutex
-//   void     unlock_smbus();          // legacy wrapper on top of mutex
-//   bool     smbus_acquire(uint32_t timeout_ms);
-//   void     smbus_release();
-//   uint32_t smbus_last_activity_ms();  // last time we touched the bus
+// Safe, read-only SMBus poller for the Original Xbox (CPU, board temp, fan).
+// - Bus access goes through SMBusSched (smbus_sched.cpp): STOP-only reads,
+//   slow clock, inter-op gaps, duty budget and backoff are enforced there.
+// - tick() runs on the SMBus task and queues high-priority sensor reads on an
+//   adaptive per-sensor interval: fast while a value moves or sits near a
+//   thermal threshold, doubling toward a slow ceiling while stable or
+//   failing. Changed readings are published through a seqlock snapshot and
+//   the consumer task gets a notification; poll() copies the snapshot out
+//   without ever touching the bus.
+// - One-shot Xcalibur (1.6) probe after the console has settled, queued as a
+//   probe job so a missing encoder never counts as a bus error.
 //
 // Notes:
 // - This file is read-only on SMBus; there are NO writes to Xbox devices.
@@ -20,10 +18,9 @@
 
 #include "xbox_smbus_poll.h"
 #include "parser_xboxsmbus.h"
+#include "smbus_sched.h"
 #include <Arduino.h>
-#include <Wire.h>
-#include "freertos/FreeRTOS.h"
-#include "freertos/semphr.h"
+#include <atomic>
 
 // ---------- Xbox SMBus addresses / regs ----------
 #define SMC_ADDRESS       0x10    // 7-bit
@@ -32,255 +29,275 @@
 #define SMC_FANSPEED      0x10
 #define XCALIBUR_ADDRESS  0x70    // Xbox 1.6 encoder (probe only, read)
 
-// ---------- Timing & pacing (tuned for safety) ----------
-#ifndef SMBUS_STARTUP_GRACE_MS
-#define SMBUS_STARTUP_GRACE_MS    10000   // let the console boot first
+// ---------- Cadence (adaptive per sensor) ----------
+#ifndef SMBUS_POLL_PERIOD_MS
+#define SMBUS_POLL_PERIOD_MS       1000   // reference cadence (and initial interval)
 #endif
-#ifndef SMBUS_MIN_TICK_MS
-#define SMBUS_MIN_TICK_MS          250   // one RR step every 1s (~4s full cycle)
+#ifndef SMBUS_POLL_FAST_MS
+#define SMBUS_POLL_FAST_MS          500   // value moving or near a threshold
 #endif
-#ifndef SMBUS_BACKOFF_MS_BASE
-#define SMBUS_BACKOFF_MS_BASE      8000   // backoff base on error; exponential
+#ifndef SMBUS_POLL_SLOW_MS
+#define SMBUS_POLL_SLOW_MS         8000   // long-stable (or failing) sensor
 #endif
-#ifndef SMBUS_I2C_CLOCK_HZ
-#define SMBUS_I2C_CLOCK_HZ         55000  // ~55 kHz, conservative for all revs
+#ifndef SMBUS_POLL_STABLE_READS
+#define SMBUS_POLL_STABLE_READS       2   // unchanged reads before slowing down
 #endif
-#ifndef SMBUS_INTER_OP_GAP_US
-#define SMBUS_INTER_OP_GAP_US        300  // breathing room between phases
+#ifndef SMBUS_POLL_DELTA
+#define SMBUS_POLL_DELTA              2   // change (C or %) that counts as "moving"
 #endif
-#ifndef SMBUS_WAIT_FREE_MS
-#define SMBUS_WAIT_FREE_MS            15  // wait up to ~15ms for idle lines
+#ifndef SMBUS_CPU_HOT_C
+#define SMBUS_CPU_HOT_C              60   // sample fast at/above this CPU temp
 #endif
-#ifndef SMBUS_FREE_STABLE_CHECKS
-#define SMBUS_FREE_STABLE_CHECKS       3  // consecutive samples required
+#ifndef SMBUS_BOARD_HOT_C
+#define SMBUS_BOARD_HOT_C            45   // ... and this board temp
 #endif
-#ifndef SMBUS_WIRE_TIMEOUT_MS
-#define SMBUS_WIRE_TIMEOUT_MS          80 // allow for clock stretching
+#ifndef SMBUS_POLL_DEADLINE_MS
+#define SMBUS_POLL_DEADLINE_MS     2000   // stale after this; drop instead of queueing up
 #endif
 #ifndef SMBUS_16_DETECT_DELAY_MS
 #define SMBUS_16_DETECT_DELAY_MS    12000 // don't probe Xcalibur until console is settled
 #endif
 
-// ---------- Global pacing state ----------
-static uint32_t g_first_ms         = 0;
-static uint32_t g_next_allowed_ms  = 0;
-static uint8_t  g_err_streak       = 0;
-static uint8_t  g_rr_step          = 0;
+enum Sensor : uint8_t { SENS_CPU = 0, SENS_BOARD, SENS_FAN, SENS_COUNT };
 
-// Remember which pins Wire is on so we can observe the lines
-static int s_sda_pin = -1;
-static int s_scl_pin = -1;
+static const uint8_t kSensorReg[SENS_COUNT] = { SMC_CPUTEMP, SMC_BOARDTEMP, SMC_FANSPEED };
 
-// ---------- 1.6 detection cache (one-time) ----------
-static bool g_is16_known  = false;
-static bool g_is16_cached = false;
+struct Sampler {
+  uint32_t intervalMs;
+  uint32_t nextAt;
+  uint8_t  stable;    // consecutive unchanged reads
+};
+
+// ---------- State ----------
+static uint32_t g_first_ms       = 0;
+static uint32_t g_cycle_start_ms = 0;     // first sensor cycle (saved-reads reference)
+static bool     g_cycle_started  = false;
+static uint8_t  g_inflight       = 0;     // bit per sensor with a queued job
+static Sampler  g_samp[SENS_COUNT];
+static XboxSMBusPoll::Stats g_stats = {};
+static XboxSMBusStatus g_latest;          // SMBus task's working copy
 
-// ---------- Cross-core SMBus guard (mutex) ----------
-// We keep legacy wrappers for compatibility with other files that may
-// still call try_lock_smbus()/unlock_smbus().
+// ---------- Published snapshot (seqlock: SMBus task writes, loop reads) ----------
+static std::atomic<uint32_t> g_pub_seq(0); // odd while a write is in progress
+static XboxSMBusStatus g_pub;
+static uint32_t     g_seen_seq    = 0;     // reader side: last generation copied out
+static TaskHandle_t g_notify_task = nullptr;
 
-static SemaphoreHandle_t g_smbus_mutex = nullptr;
-static volatile uint32_t g_last_smbus_activity_ms = 0;
+static void publish() {
+  const uint32_t s = g_pub_seq.load(std::memory_order_relaxed);
+  g_pub_seq.store(s + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  g_pub = g_latest;
+  g_pub_seq.store(s + 2, std::memory_order_release);
+  if (g_notify_task) xTaskNotifyGive(g_notify_task);
+}
 
-// Legacy variable kept for link compatibility (unused internally)
-volatile bool g_smbus_locked = false;
+// ---------- 1.6 detection cache (one-time) ----------
+static bool g_is16_known   = false;
+static bool g_is16_cached  = false;
+static bool g_is16_pending = false;
 
-static inline void mark_bus_activity() {
-  g_last_smbus_activity_ms = millis();
+// Tcorr_C ≈ 0.8*T_C − 3.56, rounded
+static int correct_board_temp_16(uint8_t val) {
+  double f = (double)val * 1.8 + 32.0; // C -> F
+  f *= 0.8;
+  double c = (f - 32.0) / 1.8;         // F -> C
+  int adj = (int)(c + (c >= 0.0 ? 0.5 : -0.5));
+  if (adj < 0)   adj = 0;
+  if (adj > 120) adj = 120;
+  return adj;
 }
 
-// Exported helpers (can be declared in a small header if you like)
-bool smbus_acquire(uint32_t timeout_ms) {
-  if (!g_smbus_mutex) return false;
-  if (xSemaphoreTake(g_smbus_mutex, pdMS_TO_TICKS(timeout_ms)) == pdTRUE) {
-    g_smbus_locked = true;  // legacy flag for old code paths
-    return true;
-  }
-  return false;
+static inline uint32_t slower(uint32_t ms) {
+  return (ms * 2 > SMBUS_POLL_SLOW_MS) ? SMBUS_POLL_SLOW_MS : ms * 2;
 }
-void smbus_release() {
-  if (g_smbus_mutex) {
-    g_smbus_locked = false;
-    xSemaphoreGive(g_smbus_mutex);
+
+// Adapt one sensor's interval to what the last read told us
+static void adapt(uint8_t which, bool ok, int prev, int v) {
+  Sampler &sp = g_samp[which];
+  if (!ok) {
+    sp.stable = 0;
+    sp.intervalMs = slower(sp.intervalMs);          // don't hammer a failing register
+    return;
   }
-}
-uint32_t smbus_last_activity_ms() { return g_last_smbus_activity_ms; }
 
-// Legacy wrappers (backed by the mutex)
-bool try_lock_smbus() { return smbus_acquire(0); }
-void unlock_smbus()   { smbus_release(); }
+  const bool hot =
+      (which == SENS_CPU   && v >= SMBUS_CPU_HOT_C) ||
+      (which == SENS_BOARD && v >= SMBUS_BOARD_HOT_C);
+  const int delta = (prev < 0) ? 0 : abs(v - prev);
 
-// ---------- Small helpers ----------
-static inline void smbus_breather() {
-  delayMicroseconds(SMBUS_INTER_OP_GAP_US);
-  yield();
-}
-
-// Wait until both SDA & SCL are high for a few consecutive samples
-static bool wait_bus_free(uint32_t max_wait_ms = SMBUS_WAIT_FREE_MS) {
-  const uint32_t start = millis();
-  int stable = 0;
-  while ((millis() - start) < max_wait_ms) {
-    const bool sdaHigh = (s_sda_pin >= 0) ? (digitalRead(s_sda_pin) == HIGH) : true;
-    const bool sclHigh = (s_scl_pin >= 0) ? (digitalRead(s_scl_pin) == HIGH) : true;
-    if (sdaHigh && sclHigh) {
-      if (++stable >= SMBUS_FREE_STABLE_CHECKS) return true;
-    } else {
-      stable = 0;
+  if (hot || delta >= SMBUS_POLL_DELTA) {
+    sp.stable = 0;
+    sp.intervalMs = SMBUS_POLL_FAST_MS;
+  } else if (delta == 0) {
+    if (++sp.stable >= SMBUS_POLL_STABLE_READS) {
+      sp.stable = 0;
+      sp.intervalMs = slower(sp.intervalMs);
     }
-    delayMicroseconds(150);
+  } else {
+    sp.stable = 0;                                  // small wiggle: hold the rate
   }
-  return false;
 }
 
-// Very light recovery: only if the bus appears wedged for a while.
-// (We do NOT spam re-inits; just one try per "wedged" observation.)
-static void maybe_recover_wire() {
-  static uint8_t stuck_streak = 0;
-  if (!wait_bus_free()) {
-    if (++stuck_streak >= 3) {
-      Wire.begin(s_sda_pin, s_scl_pin);
-      Wire.setClock(SMBUS_I2C_CLOCK_HZ);
-      Wire.setTimeOut(SMBUS_WIRE_TIMEOUT_MS);
-      stuck_streak = 0;
-    }
-  } else {
-    stuck_streak = 0;
+// Validate/convert one raw SMC byte, adapt the rate, publish on change.
+// Returns false for out-of-range values.
+static bool apply_reading(uint8_t which, uint8_t val) {
+  int *field = nullptr;
+  int v = -1;
+  switch (which) {
+    case SENS_CPU:   // CPU temp (C)
+      if (val < 120) { field = &g_latest.cpuTemp; v = (int)val; }
+      break;
+    case SENS_BOARD: // Board temp (C), with 1.6 correction
+      if (val < 120) { field = &g_latest.boardTemp; v = g_is16_cached ? correct_board_temp_16(val) : (int)val; }
+      break;
+    case SENS_FAN:   // Fan speed (raw 0–50 → %)
+      if (val <= 50) { field = &g_latest.fanSpeed; v = (int)val * 2; }
+      break;
   }
+  if (!field) {                                     // out-of-range value
+    g_stats.errors++;
+    adapt(which, false, -1, -1);
+    return false;
+  }
+  adapt(which, true, *field, v);
+
+  // Only wake the consumer when something actually changed
+  if (*field != v) {
+    *field = v;
+    publish();
+  }
+  return true;
 }
 
-// ---------- STOP-only single-byte read ----------
-// Safer on 1.6: write(reg)+STOP, short gap, requestFrom()+STOP.
-// Returns 0 on success, -1 on any failure.
-static int readSMBusByteSTOP(uint8_t address, uint8_t reg, uint8_t& value) {
-  Wire.beginTransmission(address);
-  Wire.write(reg);
-  if (Wire.endTransmission(true) != 0) return -1;  // STOP
-  smbus_breather();
+static void on_sensor(void *ctx, SMBusSched::Result res, const uint8_t *data, uint8_t len) {
+  const uint8_t which = (uint8_t)(uintptr_t)ctx;
+  g_inflight &= (uint8_t)~(1u << which);
+  if (res == SMBusSched::RES_EXPIRED) return;       // never ran; keep the rate
+  if (res != SMBusSched::RES_OK || len < 1) {
+    g_stats.errors++;
+    adapt(which, false, -1, -1);
+    return;
+  }
+  apply_reading(which, data[0]);
+}
 
-  const uint8_t n = Wire.requestFrom((int)address, (int)1, (int)true); // STOP
-  if (n != 1 || !Wire.available()) return -1;
+static void on_is16(void *, SMBusSched::Result res, const uint8_t *, uint8_t) {
+  g_is16_pending = false;
+  if (res == SMBusSched::RES_EXPIRED) return;   // never ran; try again
+  g_is16_cached = (res == SMBusSched::RES_OK);
+  g_is16_known  = true;                         // known regardless to avoid repeat pokes
+}
 
-  value = Wire.read();
-  mark_bus_activity();
-  smbus_breather();
-  return 0;
+static void queue_sensor(uint8_t which, uint32_t now) {
+  if (g_inflight & (1u << which)) return;       // previous read still queued
+  SMBusSched::Job j;
+  j.addr     = SMC_ADDRESS;
+  j.reg      = kSensorReg[which];
+  j.len      = 1;
+  j.prio     = SMBusSched::PRIO_HIGH;
+  j.retries  = 1;
+  j.deadline = now + SMBUS_POLL_DEADLINE_MS;
+  j.done     = on_sensor;
+  j.ctx      = (void *)(uintptr_t)which;
+  if (SMBusSched::submit(j)) {
+    g_inflight |= (uint8_t)(1u << which);
+    g_stats.reads++;
+  }
 }
 
 // ---------- Public API ----------
 void XboxSMBusPoll::begin(uint8_t sdaPin, uint8_t sclPin) {
-  s_sda_pin = sdaPin;
-  s_scl_pin = sclPin;
-
-  // Do NOT enable internal pullups—Xbox SMBus already has pullups.
-  pinMode(s_sda_pin, INPUT);
-  pinMode(s_scl_pin, INPUT);
+  SMBusSched::begin(sdaPin, sclPin);
 
-  Wire.begin(s_sda_pin, s_scl_pin);
-  Wire.setClock(SMBUS_I2C_CLOCK_HZ);
-  Wire.setTimeOut(SMBUS_WIRE_TIMEOUT_MS);
-
-  if (!g_smbus_mutex) {
-    g_smbus_mutex = xSemaphoreCreateMutex();
-  }
+  g_first_ms      = millis();
+  g_cycle_started = false;
+  g_inflight      = 0;
+  g_stats         = {};
+  for (Sampler &sp : g_samp) sp = { SMBUS_POLL_PERIOD_MS, g_first_ms, 0 };
+  g_latest        = XboxSMBusStatus();
+  g_pub           = g_latest;
+  g_pub_seq.store(0, std::memory_order_relaxed);
+  g_seen_seq      = 0;
+  g_is16_known    = false;
+  g_is16_cached   = false;
+  g_is16_pending  = false;
+}
 
-  g_first_ms        = millis();
-  g_next_allowed_ms = g_first_ms + SMBUS_STARTUP_GRACE_MS;
-  g_err_streak      = 0;
-  g_rr_step         = 0;
-  g_is16_known      = false;
-  g_is16_cached     = false;
+void XboxSMBusPoll::notifyOnChange(TaskHandle_t task) {
+  g_notify_task = task;
 }
 
-bool XboxSMBusPoll::poll(XboxSMBusStatus& status) {
+void XboxSMBusPoll::tick() {
   const uint32_t now = millis();
-  if (now < g_next_allowed_ms) return true;
 
-  // Acquire the SMBus (non-blocking here; next tick will try again)
-  if (!try_lock_smbus()) {
-    g_next_allowed_ms = now + SMBUS_MIN_TICK_MS;
-    return true;
+  // One-shot 1.6 detection, queued ahead of the first board temp read
+  if (!g_is16_known && !g_is16_pending && (now - g_first_ms) >= SMBUS_16_DETECT_DELAY_MS) {
+    SMBusSched::Job j;
+    j.addr    = XCALIBUR_ADDRESS;
+    j.reg     = 0x00;
+    j.len     = 1;
+    j.prio    = SMBusSched::PRIO_HIGH;
+    j.retries = 0;
+    j.flags   = SMBusSched::FLAG_PROBE;
+    j.done    = on_is16;
+    g_is16_pending = SMBusSched::submit(j);
   }
 
-  bool ok = true;
-
-  // Ensure the bus looks idle; attempt a single gentle recovery if not.
-  if (!wait_bus_free()) {
-    maybe_recover_wire();
-    if (!wait_bus_free()) {
-      ok = false;
-    }
+  if (!g_cycle_started) {
+    g_cycle_started  = true;
+    g_cycle_start_ms = now;
   }
-
-  // One-shot 1.6 detection (safe, STOP-only) to the Xcalibur address,
-  // but only after a post-boot delay to avoid early, fragile probing.
-  bool is16 = g_is16_cached;
-  if (ok && !g_is16_known && (now - g_first_ms) >= SMBUS_16_DETECT_DELAY_MS) {
-    uint8_t dummy = 0;
-    g_is16_cached = (readSMBusByteSTOP(XCALIBUR_ADDRESS, 0x00, dummy) == 0);
-    g_is16_known  = true;        // mark known regardless to avoid repeat pokes
-    is16 = g_is16_cached;
+  for (uint8_t s = 0; s < SENS_COUNT; ++s) {
+    Sampler &sp = g_samp[s];
+    if ((int32_t)(now - sp.nextAt) < 0) continue;
+    sp.nextAt = now + sp.intervalMs;
+    queue_sensor(s, now);
   }
+}
 
-  // Round-robin reading to avoid multi-read bursts per tick.
-  if (ok) {
-    uint8_t val = 0;
-    switch (g_rr_step++ & 0x03) {
-      case 0: { // CPU temp (C)
-        if (readSMBusByteSTOP(SMC_ADDRESS, SMC_CPUTEMP, val) == 0 && val < 120) {
-          status.cpuTemp = (int)val;
-        } else {
-          ok = false;
-        }
-        break;
-      }
-      case 1: { // Board temp (C), with 1.6 correction
-        if (readSMBusByteSTOP(SMC_ADDRESS, SMC_BOARDTEMP, val) == 0 && val < 120) {
-          if (is16) {
-            // Tcorr_C ≈ 0.8*T_C − 3.56, rounded
-            double f = (double)val * 1.8 + 32.0; // C -> F
-            f *= 0.8;
-            double c = (f - 32.0) / 1.8;         // F -> C
-            int adj = (int)(c + (c >= 0.0 ? 0.5 : -0.5));
-            if (adj < 0)   adj = 0;
-            if (adj > 120) adj = 120;
-            status.boardTemp = adj;
-          } else {
-            status.boardTemp = (int)val;
-          }
-        } else {
-          ok = false;
-        }
-        break;
-      }
-      case 2: { // Fan speed (raw 0–50 → %)
-        if (readSMBusByteSTOP(SMC_ADDRESS, SMC_FANSPEED, val) == 0 && val <= 50) {
-          status.fanSpeed = (int)val * 2;
-        } else {
-          ok = false;
-        }
-        break;
-      }
-      case 3: { // Idle step to keep average bus pressure low
-        // room for other modules (e.g., smbus_ext.cpp) to grab the bus
-        break;
-      }
-    }
+XboxSMBusPoll::Stats XboxSMBusPoll::getStats() {
+  Stats st = g_stats;
+  // Saved = what the fixed SMBUS_POLL_PERIOD_MS cadence would have issued - actual
+  if (g_cycle_started) {
+    const uint32_t ref = ((millis() - g_cycle_start_ms) / SMBUS_POLL_PERIOD_MS + 1) * SENS_COUNT;
+    st.readsSaved = (int32_t)ref - (int32_t)st.reads;
   }
+  st.cpuIntervalMs   = g_samp[SENS_CPU].intervalMs;
+  st.boardIntervalMs = g_samp[SENS_BOARD].intervalMs;
+  st.fanIntervalMs   = g_samp[SENS_FAN].intervalMs;
+  return st;
+}
 
-  // Pacing / backoff
-  if (!ok) {
-    if (g_err_streak < 5) g_err_streak++;
-    uint32_t backoff = (uint32_t)SMBUS_BACKOFF_MS_BASE << (g_err_streak - 1);
-    if (backoff > 60000) backoff = 60000; // cap at 60s
-    const uint32_t jitter = 100 + ((now & 0xFF) % 200); // 100..299 ms
-    g_next_allowed_ms = now + backoff + jitter;
-  } else {
-    g_err_streak = 0;
-    const uint32_t jitter = 100 + ((now & 0xFF) % 200); // 100..299 ms
-    g_next_allowed_ms = now + SMBUS_MIN_TICK_MS + jitter;
+bool XboxSMBusPoll::observe(uint8_t addr, uint8_t reg, const uint8_t *data, uint8_t len, bool write) {
+  // Console talking to the Xcalibur encoder => 1.6 board temp correction
+  if (addr == XCALIBUR_ADDRESS && !g_is16_known) {
+    g_is16_cached = true;
+    g_is16_known  = true;
   }
+  if (write || addr != SMC_ADDRESS || len < 1) return false;
+  for (uint8_t s = 0; s < SENS_COUNT; ++s) {
+    if (kSensorReg[s] == reg) return apply_reading(s, data[0]);
+  }
+  return false;
+}
+
+bool XboxSMBusPoll::poll(XboxSMBusStatus& status) {
+  XboxSMBusStatus snap;
+  uint32_t s1, s2;
+  do {
+    s1 = g_pub_seq.load(std::memory_order_acquire);
+    if (s1 & 1u) continue;                       // writer mid-update; retry
+    snap = g_pub;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    s2 = g_pub_seq.load(std::memory_order_relaxed);
+    if (s1 == s2) break;
+  } while (true);
 
-  unlock_smbus();
-  return ok;
+  if (s1 == g_seen_seq) return false;            // nothing new
+  g_seen_seq = s1;
+  status.cpuTemp   = snap.cpuTemp;
+  status.boardTemp = snap.boardTemp;
+  status.fanSpeed  = snap.fanSpeed;
+  return true;
 }
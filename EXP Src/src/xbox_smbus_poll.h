@@ -1,6 +1,8 @@
 #pragma once
 
 #include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 
 // Structure to hold polled values (adapt/expand as needed)
 struct XboxSMBusStatus {
@@ -13,5 +15,28 @@ struct XboxSMBusStatus {
 
 namespace XboxSMBusPoll {
     void begin(uint8_t sdaPin = 7, uint8_t sclPin = 6);
-    bool poll(XboxSMBusStatus& status); // Returns true if poll successful
+
+    // SMBus task only: queue due sensor reads (never blocks on the bus)
+    void tick();
+
+    // Any task: copy the latest published snapshot; true if it changed since the last call
+    bool poll(XboxSMBusStatus& status);
+
+    // Passive mode (smbus_sniff): feed a transaction the console itself made.
+    // Single producer only (the sniff task, with the active poller not running).
+    // Returns true if it updated a sensor.
+    bool observe(uint8_t addr, uint8_t reg, const uint8_t *data, uint8_t len, bool write);
+
+    // Task to xTaskNotifyGive() whenever a published value changes
+    void notifyOnChange(TaskHandle_t task);
+
+    struct Stats {
+        uint32_t reads;          // sensor reads queued
+        uint32_t errors;         // failed / out-of-range reads
+        int32_t  readsSaved;     // vs. fixed SMBUS_POLL_PERIOD_MS cadence (negative while hot)
+        uint32_t cpuIntervalMs;  // current adaptive intervals
+        uint32_t boardIntervalMs;
+        uint32_t fanIntervalMs;
+    };
+    Stats getStats();
 }
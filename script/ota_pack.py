@@ -0,0 +1,53 @@
+import sys
+import os
+import struct
+import hashlib
+import zlib
+
+# Must match OtaHeader in src/ota.cpp
+MAGIC = b"TDOT"
+HDR_VER = 1
+COMP_NONE = 0
+COMP_ZLIB = 1
+HDR_FMT = "<4sBBHII32s"   # 48 bytes, little endian
+
+def main():
+    if len(sys.argv) < 2:
+        print("Usage: python ota_pack.py firmware.bin [output.ota] [--store]")
+        return
+
+    args = [a for a in sys.argv[1:] if not a.startswith("--")]
+    store = "--store" in sys.argv
+
+    input_path = args[0]
+    if len(args) > 1:
+        output_path = args[1]
+    else:
+        base, ext = os.path.splitext(input_path)
+        output_path = f"{base}.ota"
+
+    with open(input_path, "rb") as f:
+        image = f.read()
+
+    if not image or image[0] != 0xE9:
+        print(f"Error: {input_path} is not an ESP32 app image (missing 0xE9 magic)")
+        sys.exit(1)
+
+    # --- PACKING ---
+    # Default zlib window (32 KB) matches the device's inflate dictionary
+    payload = image if store else zlib.compress(image, 9)
+    comp = COMP_NONE if store else COMP_ZLIB
+    digest = hashlib.sha256(image).digest()
+    header = struct.pack(HDR_FMT, MAGIC, HDR_VER, comp, struct.calcsize(HDR_FMT),
+                         len(image), len(payload), digest)
+
+    with open(output_path, "wb") as f:
+        f.write(header)
+        f.write(payload)
+
+    ratio = 100.0 * len(payload) / len(image)
+    print(f"Saved: {output_path} ({len(image)} -> {len(payload)} bytes, {ratio:.0f}%)")
+    print(f"SHA-256: {digest.hex()}")
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,71 @@
+// Resumable uploads for forms with data-kind: the file goes up in chunks, each
+// with its CRC32, and a dropped link resumes from the offset the device reports.
+// The whole-file CRC32 names the upload, so only the same content resumes.
+(function () {
+    const T = new Uint32Array(256);
+    for (let n = 0; n < 256; n++) {
+        let c = n;
+        for (let k = 0; k < 8; k++) c = c & 1 ? 0xEDB88320 ^ (c >>> 1) : c >>> 1;
+        T[n] = c >>> 0;
+    }
+    function crcUpdate(c, b) {
+        for (let i = 0; i < b.length; i++) c = T[(c ^ b[i]) & 255] ^ (c >>> 8);
+        return c;
+    }
+    const crcHex = c => ((c ^ 0xFFFFFFFF) >>> 0).toString(16).padStart(8, '0');
+    const crc32 = b => crcHex(crcUpdate(0xFFFFFFFF, b));
+    async function fileCrc32(file, st) {
+        const step = 1 << 20;
+        let c = 0xFFFFFFFF;
+        for (let off = 0; off < file.size; off += step) {
+            st.textContent = file.name + ': checking ' + Math.floor(100 * off / file.size) + '%';
+            c = crcUpdate(c, new Uint8Array(await file.slice(off, off + step).arrayBuffer()));
+        }
+        return crcHex(c);
+    }
+    const sleep = ms => new Promise(r => setTimeout(r, ms));
+    async function call(url, opt) {
+        const r = await fetch(url, opt);
+        const t = await r.json().catch(() => ({}));
+        t.status = r.status;
+        return t;
+    }
+
+    async function send(kind, file, st) {
+        const q = 'kind=' + kind + '&name=' + encodeURIComponent(file.name) + '&size=' + file.size +
+                  '&crc=' + await fileCrc32(file, st);
+        let s = await call('/upload/start?' + q, { method: 'POST' });
+        if (!s.id) throw new Error(s.error || 'start failed');
+        let off = s.offset, fails = 0;
+        const chunk = s.chunk || 32768;
+        while (off < file.size) {
+            st.textContent = file.name + ': ' + Math.floor(100 * off / file.size) + '%';
+            const buf = new Uint8Array(await file.slice(off, off + chunk).arrayBuffer());
+            try {
+                const r = await call('/upload/chunk?id=' + s.id + '&offset=' + off + '&crc=' + crc32(buf), {
+                    method: 'POST', headers: { 'Content-Type': 'application/octet-stream' }, body: buf });
+                if (r.offset === undefined) throw new Error(r.error || ('HTTP ' + r.status));
+                off = r.offset;
+                fails = 0;
+            } catch (e) {
+                if (++fails > 8) throw e;
+                await sleep(500 * fails);
+                // Ask where the device is; it only ever keeps verified chunks
+                const again = await call('/upload/start?' + q, { method: 'POST' }).catch(() => ({}));
+                if (again.offset !== undefined) off = again.offset;
+            }
+        }
+    }
+
+    document.querySelectorAll('form[data-kind]').forEach(f => f.addEventListener('submit', async e => {
+        e.preventDefault();
+        let st = f.querySelector('.upstat');
+        if (!st) { st = document.createElement('div'); st.className = 'upstat'; f.appendChild(st); }
+        try {
+            for (const file of f.querySelector('input[type=file]').files) await send(f.dataset.kind, file, st);
+            location.reload();
+        } catch (err) {
+            st.textContent = 'Upload failed: ' + err.message;
+        }
+    }));
+})();
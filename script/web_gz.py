@@ -0,0 +1,90 @@
+import sys
+import os
+import gzip
+import zlib
+
+# Static web shells -> gzipped C arrays served with Content-Encoding: gzip.
+# Run after editing anything in script/web/, then commit the generated files:
+#
+#   python web_gz.py [out_dir ...]      (default: ../src and ../src/S3)
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+WEB_DIR = os.path.join(HERE, "web")
+DEFAULT_OUT = [os.path.join(HERE, "..", "src"), os.path.join(HERE, "..", "src", "S3")]
+
+TYPES = {
+    ".html": "text/html",
+    ".css": "text/css",
+    ".js": "application/javascript",
+}
+
+def symbol_for(name):
+    return name.replace(".", "_").replace("-", "_").upper()
+
+def c_bytes(data):
+    lines = []
+    for i in range(0, len(data), 16):
+        lines.append("  " + ", ".join(f"0x{b:02X}" for b in data[i:i + 16]) + ",")
+    return "\n".join(lines)
+
+def main():
+    out_dirs = sys.argv[1:] or DEFAULT_OUT
+
+    assets = []
+    for name in sorted(os.listdir(WEB_DIR)):
+        ext = os.path.splitext(name)[1]
+        if ext not in TYPES:
+            continue
+        with open(os.path.join(WEB_DIR, name), "rb") as f:
+            raw = f.read()
+        # mtime=0 keeps the output (and the fixed 10-byte gzip header) reproducible
+        gz = gzip.compress(raw, compresslevel=9, mtime=0)
+        assets.append((symbol_for(name), TYPES[ext], raw, gz))
+        print(f"{name}: {len(raw)} -> {len(gz)} bytes")
+
+    hdr = ["// web_assets.h",
+           "//",
+           "// GENERATED by script/web_gz.py from script/web/ -- do not edit.",
+           "",
+           "#pragma once",
+           "#include <Arduino.h>",
+           "",
+           "struct WebAsset {",
+           "    const char    *type;",
+           "    const uint8_t *gz;       // gzip member, 10-byte header (no name, mtime 0)",
+           "    uint32_t       gzLen;",
+           "    uint32_t       rawLen;",
+           "    uint32_t       etag;     // CRC32 of the uncompressed bytes",
+           "};",
+           "",
+           "namespace WebAssets {"]
+    for sym, _, _, _ in assets:
+        hdr.append(f"    extern const WebAsset {sym};")
+    hdr += ["}", ""]
+
+    src = ["// web_assets.cpp",
+           "//",
+           "// GENERATED by script/web_gz.py from script/web/ -- do not edit.",
+           "",
+           '#include "web_assets.h"',
+           ""]
+    for sym, ctype, raw, gz in assets:
+        src.append(f"static const uint8_t {sym}_GZ[] PROGMEM = {{")
+        src.append(c_bytes(gz))
+        src.append("};")
+        src.append("")
+    src.append("namespace WebAssets {")
+    for sym, ctype, raw, gz in assets:
+        etag = zlib.crc32(raw) & 0xFFFFFFFF
+        src.append(f'    const WebAsset {sym} = {{ "{ctype}", {sym}_GZ, {len(gz)}, {len(raw)}, 0x{etag:08X} }};')
+    src += ["}", ""]
+
+    for out in out_dirs:
+        with open(os.path.join(out, "web_assets.h"), "w", newline="\n") as f:
+            f.write("\n".join(hdr))
+        with open(os.path.join(out, "web_assets.cpp"), "w", newline="\n") as f:
+            f.write("\n".join(src))
+        print(f"Saved: {os.path.join(out, 'web_assets.[h|cpp]')}")
+
+if __name__ == "__main__":
+    main()
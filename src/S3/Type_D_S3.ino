@@ -27,6 +27,15 @@
 #include "cmd.h"
 #include "diag.h"
 #include "udp_detect.h"
+#include "telemetry.h"
+#include "disp_queue.h"
+#include "playlist.h"
+#include "ota.h"
+#include "webcache.h"
+#include "thumbs.h"
+#include "bootprof.h"
+#include "trace.h"
+#include "metrics.h"
 
 #define WIFI_TIMEOUT 120
 #define BRIGHTNESS_PREF_KEY "brightness"
@@ -78,18 +87,25 @@ void displayPortalInfo() {
     tft.drawString("Connect below to setup.", tft.width()/2, tft.height()/2 + 32);
 }
 
+// Splash stays up at least this long; the rest of setup() runs under it
+#ifndef BOOT_SPLASH_MS
+#define BOOT_SPLASH_MS 800
+#endif
+
 void setup() {
     Serial.begin(115200);
     delay(200);
     Serial.println("[Type D] Booting...");
+    BootProf::mark("serial");
+    OTA::bootCheck();   // trial boot after an update: count it, roll back if it keeps failing
 
     tft.init();
     tft.setRotation(0);
     apply_brightness_on_boot();
     tft.fillScreen(TFT_BLACK);
+    BootProf::mark("display");
 
-    ImageDisplay::begin(&tft);
-
+    // FFat first: the boot animation, image index and web handlers all read it
     if (!FFat.begin()) {
         Serial.println("[Type D] FFat Mount Failed! Attempting to format...");
         if (FFat.format()) {
@@ -103,11 +119,21 @@ void setup() {
     } else {
         Serial.println("[Type D] FFat Mounted OK.");
     }
-    server80.serveStatic("/resource/", FFat, "/resource/");
-    server8080.serveStatic("/resource/", FFat, "/resource/");
+    BootProf::mark("ffat");
+    WebCache::serveDir(server80, "/resource/");
+    WebCache::serveDir(server8080, "/resource/");
+
+    // Start association and image indexing now; both run in other tasks
+    // while this one plays the boot animation.
+    WiFiMgr::begin();
+    Serial.println("[Type D] WiFiMgr initialized.");
+    BootProf::mark("wifi begin");
+    ImageDisplay::beginAsync(&tft);
+    DispQueue::begin(&tft);   // before any web/serial producer can post
 
     // --- BOOT ANIMATION ---
     bootShowScreen();
+    BootProf::mark("boot anim");
 
     // ---- SPLASH TEXT ----
     tft.fillScreen(TFT_BLACK);
@@ -118,14 +144,10 @@ void setup() {
     tft.setTextColor(TFT_WHITE, TFT_BLACK);
     tft.setTextSize(2);
     tft.drawString(VERSION_TEXT, tft.width() / 2, tft.height() / 2 + 10);
-    delay(1500);
+    const uint32_t splashAt = millis();
 
-    // WiFiMgr replaces WiFiManager
-    WiFiMgr::begin();
-    Serial.println("[Type D] WiFiMgr initialized.");
-
-    // If not connected, display portal info
-    if (!WiFiMgr::isConnected()) {
+    // If the portal is up (no saved network, or the fast join failed), display portal info
+    if (!WiFiMgr::isConnected() && WiFiMgr::isPortalActive()) {
         displayPortalInfo();
     }
 
@@ -133,31 +155,49 @@ void setup() {
 
     // --- Start detection and web server modules ---
     Detect::begin();
+    while (!ImageDisplay::waitReady(5000))
+        Serial.println("[Type D] Waiting for the image index...");
+    BootProf::mark("index");
     server8080.begin();
     FileMan::begin(server8080);
     Diag::begin(server8080);
+    Telemetry::begin(server8080);
+    Playlist::begin(server8080);
+    Trace::begin(server8080);
+    Metrics::begin(server8080);
     cmd_init(&server8080, &tft);
     UI::begin(&tft);
+    BootProf::mark("web");
 
-    Serial.printf("[Type D] Device ID: %d\n", Detect::getId());
+    Serial.printf("[Type D] Device ID: %d%s\n", Detect::getId(), Detect::isAssigned() ? "" : " (election running)");
 
-    // --- Show a random image on WiFi success as well ---
-    ImageDisplay::displayRandomImage();
+    // --- Start the playlist if one is saved (loaded by the index task), else a random image ---
+    while (millis() - splashAt < BOOT_SPLASH_MS) delay(10);
+    ImageDisplay::resume();
+    BootProf::mark("first image");
 }
 
 void loop() {
+    TRACE_SCOPE("loop");
     WiFiMgr::loop();
+    Telemetry::loop();
+    OTA::loop();
+    cmd_loop();
+    Thumbs::loop();
+    BootProf::loop();
+    Metrics::loop();
+
+    // 1. Detection and UDP polling run even under a menu: an open menu must
+    //    not stop lease renewals, or peers re-lease our ID after ~12 s
+    Detect::loop();
+    UDPDetect::loop();
 
-    // 1. Highest priority: About, brightness, menu overlays
+    // 2. Highest priority for the screen: About, brightness, menu overlays
     if (ui_about_isActive()) { ui_about_update(); return; }
     if (ui_bright_isVisible()) { ui_bright_update(); return; }
     if (UISet::isMenuVisible()) { UISet::update(); return; }
     UI::update();
 
-    // 2. Run detection and UDP polling
-    Detect::loop();
-    UDPDetect::loop();
-
     // 3. Status overlay logic -- only show between images and if no UI/menu overlay is active
     bool anyUiActive = ui_about_isActive() || ui_bright_isVisible() || UISet::isMenuVisible() || UI::isMenuVisible();
 
@@ -180,13 +220,14 @@ void loop() {
     if (showingXboxStatus && !anyUiActive) {
         if (millis() - lastStatusDisplay > 2000) {
             showingXboxStatus = false;
-            ImageDisplay::displayRandomImage();
+            ImageDisplay::resume();
         }
         return; // Block image update while overlay active
     }
 
     // 4. Only update image if overlay is not showing and not in a menu
     if (!UI::isMenuVisible()) {
+        DispQueue::drain();   // web/serial display commands, applied on this task only
         ImageDisplay::update();
     }
 
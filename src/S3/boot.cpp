@@ -132,5 +132,5 @@ void bootShowScreen() {
     tft.setTextColor(TFT_WHITE, TFT_BLACK);
     tft.setTextSize(1);
     tft.drawString(VERSION_TEXT, tft.width() / 2, tft.height() / 2 + 10);
-    delay(1500);
+    // No hold here: setup() draws the splash next and keeps it up for BOOT_SPLASH_MS
 }
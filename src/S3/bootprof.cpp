@@ -0,0 +1,70 @@
+// bootprof.cpp
+
+#include "bootprof.h"
+#include "wifimgr.h"
+
+namespace BootProf {
+
+struct Mark {
+  const char *phase;
+  uint32_t    ms;
+};
+
+static Mark    s_marks[BOOT_PROF_MAX];
+static uint8_t s_count = 0;
+static bool    s_reported = false;
+
+void markAt(const char *phase, uint32_t ms) {
+  if (s_count >= BOOT_PROF_MAX) return;
+  s_marks[s_count++] = {phase, ms};
+}
+
+void mark(const char *phase) {
+  markAt(phase, millis());
+}
+
+uint32_t at(const char *phase) {
+  for (uint8_t i = 0; i < s_count; i++)
+    if (!strcmp(s_marks[i].phase, phase)) return s_marks[i].ms;
+  return 0;
+}
+
+String summary() {
+  String s;
+  for (uint8_t i = 0; i < s_count; i++) {
+    if (i) s += ", ";
+    s += s_marks[i].phase;
+    s += ' ';
+    s += String(s_marks[i].ms);
+  }
+  return s;
+}
+
+void dump(Print &out) {
+  out.println("[Boot] phase            at ms   took ms");
+  uint32_t prev = 0;
+  for (uint8_t i = 0; i < s_count; i++) {
+    // "network" comes from the WiFi task and overlaps the rest: no delta
+    const bool async = !strcmp(s_marks[i].phase, "network");
+    if (async)
+      out.printf("[Boot] %-16s %6lu         -\n", s_marks[i].phase, (unsigned long)s_marks[i].ms);
+    else
+      out.printf("[Boot] %-16s %6lu   %7lu\n", s_marks[i].phase,
+                 (unsigned long)s_marks[i].ms, (unsigned long)(s_marks[i].ms - prev));
+    if (!async) prev = s_marks[i].ms;
+  }
+}
+
+void loop() {
+  if (s_reported) return;
+  const uint32_t net = WiFiMgr::getConnectInfo().bootMs;
+  if (net) markAt("network", net);
+  else if (millis() < BOOT_PROF_REPORT_MS) return;
+  s_reported = true;
+  dump(Serial);
+  Serial.printf("[Boot] First image at %lu ms, network %s\n",
+                (unsigned long)at("first image"),
+                net ? (String(net) + " ms").c_str() : "not up");
+}
+
+} // namespace BootProf
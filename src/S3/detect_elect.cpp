@@ -0,0 +1,309 @@
+// detect_elect.cpp
+//
+// Election state machine behind Detect (see detect_elect.h). Every state is
+// left by a timer or a packet; nothing here blocks, so one step() only does
+// a few comparisons and at most one small send.
+//
+// IDs are leases: each holder re-announces "TYPE_D_LEASE:<id>:<mac>:<ms>"
+// before <ms> runs out, and peers forget IDs whose lease expired. When two
+// nodes want the same ID the lower MAC keeps it and the other simply picks
+// another free one, so there is no proposal storm or random backoff.
+
+#include "detect_elect.h"
+#include <ctype.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ==== CONFIGURABLES ====
+#define DETECT_DISCOVER_TIMEOUT 3000   // ms to listen for leases after discover
+#define DETECT_REPLY_SPREAD_MS 1000    // peers answer a discover within 0..this (coalesced)
+#define DETECT_CLAIM_WINDOW 1200       // ms a new claim must survive before it is ours
+#define DETECT_CLAIM_REPEAT_MS 400     // re-announce a pending claim this often
+#define DETECT_BROADCAST_INTERVAL 3000 // ms between beacons for small fleets (floor)
+#define DETECT_BEACON_MAX_MS 16000     // beacon interval ceiling for large fleets
+#define DETECT_NET_BEACON_RATE 8       // target beacons/s for the WHOLE network
+#define DETECT_BEACON_MIN_GAP_MS 250   // hard rate limit per node
+#define DETECT_LEASE_BEACONS 4         // a lease lasts this many beacon intervals
+#ifndef DETECT_PICK_SPREAD
+#define DETECT_PICK_SPREAD 8           // PICK chooses among this many lowest free IDs
+#endif
+#define DETECT_DISCOVER_MSG "TYPE_D_DISCOVER?"
+#define DETECT_ID_MSG_PREFIX "TYPE_D_ID:"
+#define DETECT_LEASE_MSG_PREFIX "TYPE_D_LEASE:"
+
+namespace Detect {
+
+static void macToHex(const uint8_t mac[6], char *out) {
+  snprintf(out, 13, "%02X%02X%02X%02X%02X%02X", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+}
+
+static bool hexToMac(const char *hex, uint8_t mac[6]) {
+  for (int i = 0; i < 6; ++i) {
+    char byteStr[3] = { hex[2 * i], hex[2 * i + 1], 0 };
+    if (!isxdigit((unsigned char)byteStr[0]) || !isxdigit((unsigned char)byteStr[1])) return false;
+    mac[i] = (uint8_t)strtol(byteStr, nullptr, 16);
+  }
+  return true;
+}
+
+// ---- Plumbing ----
+void Election::begin(const Io &ioIn, const uint8_t mac[6], uint32_t seed) {
+  io = ioIn;
+  memcpy(selfMac, mac, 6);
+  rng = seed ? seed : 0x9E3779B9u;
+  memset(leases, 0, sizeof(leases));
+  counters = Stats{};
+  deviceId = 1;
+  lastBeacon = 0;
+  enterState(State::OFFLINE);
+}
+
+// xorshift32, uniform enough for jitter; [lo, hi) like Arduino random()
+uint32_t Election::rand(uint32_t lo, uint32_t hi) {
+  rng ^= rng << 13;
+  rng ^= rng >> 17;
+  rng ^= rng << 5;
+  return hi > lo ? lo + rng % (hi - lo) : lo;
+}
+
+void Election::logf(const char *fmt, ...) {
+  if (!io.log) return;
+  char line[80];
+  va_list ap;
+  va_start(ap, fmt);
+  vsnprintf(line, sizeof(line), fmt, ap);
+  va_end(ap);
+  io.log(io.ctx, line);
+}
+
+void Election::enterState(State s, uint32_t waitMs) {
+  state = s;
+  stateStart = now();
+  stateWait = waitMs;
+}
+
+bool Election::stateExpired() const {
+  return (now() - stateStart) >= stateWait;
+}
+
+void Election::send(const char *msg) {
+  io.sendDetect(io.ctx, msg);
+  counters.txPackets++;
+}
+
+// ---- Lease table ----
+bool Election::leaseLive(uint8_t id, uint32_t t) const {
+  const Lease &l = leases[id];
+  return l.active && (t - l.seenAt) < l.leaseMs;
+}
+
+uint8_t Election::livePeers() const {
+  const uint32_t t = now();
+  uint8_t n = 0;
+  for (uint8_t id = DETECT_ID_MIN; id <= DETECT_ID_MAX; ++id)
+    if (leaseLive(id, t)) n++;
+  return n;
+}
+
+// Interval that keeps the whole network near DETECT_NET_BEACON_RATE beacons/s
+uint32_t Election::beaconInterval() const {
+  uint32_t iv = (uint32_t)(livePeers() + 1) * 1000UL / DETECT_NET_BEACON_RATE;
+  if (iv < DETECT_BROADCAST_INTERVAL) iv = DETECT_BROADCAST_INTERVAL;
+  if (iv > DETECT_BEACON_MAX_MS) iv = DETECT_BEACON_MAX_MS;
+  return iv;
+}
+
+uint32_t Election::jittered(uint32_t iv) {
+  return iv - iv / 4 + rand(0, iv / 2 + 1);   // +/-25%
+}
+
+// Pull the next renewal earlier (never later); repeated requests coalesce
+void Election::beaconSoon(uint32_t withinMs) {
+  uint32_t at = now() + rand(0, withinMs + 1);
+  if ((int32_t)(at - nextBeaconAt) < 0) nextBeaconAt = at;
+}
+
+// Announce (or renew) a lease on the detect port
+bool Election::sendLease(uint8_t id) {
+  const uint32_t t = now();
+  if (lastBeacon && (t - lastBeacon) < DETECT_BEACON_MIN_GAP_MS) return false;
+  lastBeacon = t;
+
+  const uint32_t iv = beaconInterval();
+  char mac[13];
+  macToHex(selfMac, mac);
+  char msg[48];
+  snprintf(msg, sizeof(msg), DETECT_LEASE_MSG_PREFIX "%u:%s:%lu",
+           id, mac, (unsigned long)(iv * DETECT_LEASE_BEACONS));
+  send(msg);
+  nextBeaconAt = t + jittered(iv);
+  return true;
+}
+
+// Lower MAC wins; legacy peers (no MAC, all zero) always win
+bool Election::peerWins(const uint8_t peerMac[6]) const {
+  return memcmp(peerMac, selfMac, 6) < 0;
+}
+
+void Election::yieldTo(uint8_t id) {
+  logf("ID %d held by lower MAC; picking another.", id);
+  counters.conflicts++;
+  enterState(State::PICK, rand(20, 200));
+}
+
+// ---- Packet handling (shared by all states) ----
+void Election::handleClaim(uint8_t id, const uint8_t mac[6], uint32_t leaseMs) {
+  if (id < DETECT_ID_MIN || id > DETECT_ID_MAX) return;
+  if (memcmp(mac, selfMac, 6) == 0) return;   // our own broadcast looped back
+  // Never trust a peer for longer than the slowest legitimate lease
+  if (leaseMs > (uint32_t)DETECT_BEACON_MAX_MS * DETECT_LEASE_BEACONS)
+    leaseMs = (uint32_t)DETECT_BEACON_MAX_MS * DETECT_LEASE_BEACONS;
+
+  Lease &l = leases[id];
+  memcpy(l.mac, mac, 6);
+  l.seenAt = now();
+  l.leaseMs = leaseMs;
+  l.active = true;
+
+  const uint8_t mine = (state == State::CLAIM) ? candidateId
+                     : (state == State::ASSIGNED) ? deviceId : 0;
+  if (id != mine) return;
+
+  if (peerWins(mac)) {
+    yieldTo(id);
+  } else {
+    // We keep it; make sure the other side hears about it quickly
+    counters.conflicts++;
+    beaconSoon(DETECT_BEACON_MIN_GAP_MS);
+  }
+}
+
+void Election::onPacket(const char *buf) {
+  counters.rxPackets++;
+
+  // Someone is discovering: schedule (not send) our renewal, so a burst of
+  // discovers and 64 holders turn into at most one beacon per holder
+  if (strcmp(buf, DETECT_DISCOVER_MSG) == 0) {
+    if (state == State::ASSIGNED) beaconSoon(DETECT_REPLY_SPREAD_MS);
+    return;
+  }
+
+  const size_t leaseLen = strlen(DETECT_LEASE_MSG_PREFIX);
+  if (strncmp(buf, DETECT_LEASE_MSG_PREFIX, leaseLen) == 0) {
+    // Range-check before narrowing: "TYPE_D_LEASE:257:..." must not become ID 1
+    const char *p = buf + leaseLen;
+    char *end = nullptr;
+    const unsigned long id = strtoul(p, &end, 10);
+    if (end == p || *end != ':' || id < DETECT_ID_MIN || id > DETECT_ID_MAX) return;
+
+    char macHex[13] = {0};
+    unsigned long leaseMs = 0;
+    uint8_t mac[6];
+    if (sscanf(end + 1, "%12[0-9A-Fa-f]:%lu", macHex, &leaseMs) == 2 && hexToMac(macHex, mac)) {
+      handleClaim((uint8_t)id, mac, leaseMs);
+    }
+    return;
+  }
+
+  // Legacy firmware: "TYPE_D_ID:<id>" without MAC. Treat as an all-zero MAC
+  // so older units always keep their ID.
+  const size_t idLen = strlen(DETECT_ID_MSG_PREFIX);
+  if (strncmp(buf, DETECT_ID_MSG_PREFIX, idLen) == 0) {
+    char *end = nullptr;
+    const long id = strtol(buf + idLen, &end, 10);
+    if (end == buf + idLen || id < DETECT_ID_MIN || id > DETECT_ID_MAX) return;
+    const uint8_t zero[6] = {0};
+    handleClaim((uint8_t)id, zero, (uint32_t)DETECT_BROADCAST_INTERVAL * DETECT_LEASE_BEACONS);
+  }
+}
+
+// ---- Election step: advance at most one state per call ----
+void Election::step() {
+  const uint32_t t = now();
+  switch (state) {
+    case State::JITTER:
+      if (!stateExpired()) break;
+      send(DETECT_DISCOVER_MSG);
+      logf("Sent discover broadcast.");
+      enterState(State::DISCOVER, DETECT_DISCOVER_TIMEOUT);
+      break;
+
+    case State::DISCOVER:
+      if (stateExpired()) enterState(State::PICK, rand(20, 200));
+      break;
+
+    case State::PICK: {
+      if (!stateExpired()) break;
+      // Pick at random among the lowest DETECT_PICK_SPREAD free IDs, so nodes
+      // that booted together don't all claim the same one and lose in turn
+      uint8_t freeIds[DETECT_PICK_SPREAD];
+      uint8_t nFree = 0;
+      for (uint8_t tryId = DETECT_ID_MIN; tryId <= DETECT_ID_MAX && nFree < DETECT_PICK_SPREAD; ++tryId) {
+        if (tryId == DETECT_ID_RESERVED || leaseLive(tryId, t)) continue;
+        freeIds[nFree++] = tryId;
+      }
+      if (nFree == 0) {
+        // Every lease is live -- retry after the shortest lease could lapse
+        logf("All IDs leased; waiting for a lease to expire.");
+        enterState(State::PICK, DETECT_BROADCAST_INTERVAL);
+        break;
+      }
+      candidateId = freeIds[rand(0, nFree)];
+      logf("Claiming candidate ID: %d", candidateId);
+      enterState(State::CLAIM, DETECT_CLAIM_WINDOW);
+      lastBeacon = 0;
+      sendLease(candidateId);
+      lastClaim = t;
+      break;
+    }
+
+    case State::CLAIM:
+      if (stateExpired()) {
+        deviceId = candidateId;
+        logf("Final assigned ID: %d", deviceId);
+        logf("ID assignment complete.");
+        enterState(State::ASSIGNED);
+        sendStatus();
+      } else if (t - lastClaim >= DETECT_CLAIM_REPEAT_MS) {
+        if (sendLease(candidateId)) lastClaim = t;
+      }
+      break;
+
+    case State::ASSIGNED:
+      // Renew our lease; the status beacon for viewer apps rides along
+      if ((int32_t)(t - nextBeaconAt) >= 0 && sendLease(deviceId)) {
+        sendStatus();
+      }
+      break;
+
+    case State::OFFLINE:
+      break;
+  }
+}
+
+void Election::start() {
+  enterState(State::JITTER, rand(200, 800));
+}
+
+void Election::stop() {
+  enterState(State::OFFLINE);
+  deviceId = 1;
+}
+
+void Election::sendStatus() {
+  char msg[32];
+  snprintf(msg, sizeof(msg), DETECT_ID_MSG_PREFIX "%d", deviceId);
+  io.sendStatus(io.ctx, msg);
+  counters.txPackets++;
+}
+
+Stats Election::stats() const {
+  Stats s = counters;
+  s.livePeers = livePeers();
+  s.beaconIntervalMs = beaconInterval();
+  return s;
+}
+
+} // namespace Detect
@@ -0,0 +1,152 @@
+// disp_queue.cpp
+//
+// Bounded lock-free MPSC queue (Vyukov style: one sequence number per cell).
+// Producers claim a slot with a CAS on the enqueue index, fill it, then
+// publish it by bumping the cell sequence. The single consumer is the
+// render loop. No mutexes, no heap, no waiting on either side.
+//
+// drain() applies commands in FIFO order. It only merges where the result
+// is the same: a run of NEXT/PREV becomes one net step (five quick "next"
+// clicks move five items but decode one image), and back-to-back identical
+// SHOW_FILE / RANDOM* commands collapse into one.
+
+#include "disp_queue.h"
+#include "imagedisplay.h"
+#include "disp_cfg.h"
+#include <atomic>
+#include "trace.h"
+
+#define DISPQ_SLOTS          32   // must be a power of two; >= CMD_BATCH_MAX_CMDS
+#define DISPQ_MAX_PER_DRAIN  8    // bound the work done by one drain()
+#define DISPQ_PATH_LEN       96
+
+static_assert((DISPQ_SLOTS & (DISPQ_SLOTS - 1)) == 0, "DISPQ_SLOTS must be a power of two");
+
+namespace DispQueue {
+
+struct Cmd {
+  Op op;
+  int32_t arg;
+  char path[DISPQ_PATH_LEN];
+};
+
+struct Cell {
+  std::atomic<uint32_t> seq;
+  Cmd cmd;
+};
+
+static Cell cells[DISPQ_SLOTS];
+static std::atomic<uint32_t> enqPos(0);
+static uint32_t deqPos = 0;               // consumer only
+static std::atomic<uint32_t> droppedCount(0);
+static LGFX *s_tft = nullptr;
+
+void begin(LGFX *tft) {
+  s_tft = tft;
+  for (uint32_t i = 0; i < DISPQ_SLOTS; ++i) cells[i].seq.store(i, std::memory_order_relaxed);
+  enqPos.store(0, std::memory_order_relaxed);
+  deqPos = 0;
+  Serial.println("[DispQueue] Ready");
+}
+
+bool post(Op op, int32_t arg, const char *path) {
+  uint32_t pos = enqPos.load(std::memory_order_relaxed);
+  Cell *cell;
+  for (;;) {
+    cell = &cells[pos & (DISPQ_SLOTS - 1)];
+    const uint32_t seq = cell->seq.load(std::memory_order_acquire);
+    const int32_t diff = (int32_t)(seq - pos);
+    if (diff == 0) {
+      if (enqPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+    } else if (diff < 0) {
+      droppedCount.fetch_add(1, std::memory_order_relaxed);
+      Serial.println("[DispQueue] Full, command dropped");
+      return false;
+    } else {
+      pos = enqPos.load(std::memory_order_relaxed);
+    }
+  }
+
+  cell->cmd.op = op;
+  cell->cmd.arg = arg;
+  if (path) strlcpy(cell->cmd.path, path, sizeof(cell->cmd.path));
+  else cell->cmd.path[0] = '\0';
+  cell->seq.store(pos + 1, std::memory_order_release);
+  return true;
+}
+
+static bool pop(Cmd &out) {
+  Cell &cell = cells[deqPos & (DISPQ_SLOTS - 1)];
+  const uint32_t seq = cell.seq.load(std::memory_order_acquire);
+  if ((int32_t)(seq - (deqPos + 1)) < 0) return false;   // empty
+  out = cell.cmd;
+  cell.seq.store(deqPos + DISPQ_SLOTS, std::memory_order_release);
+  deqPos++;
+  return true;
+}
+
+// Repeating one of these straight away gives the same picture again
+static bool collapsible(const Cmd &a, const Cmd &b) {
+  if (a.op != b.op) return false;
+  switch (a.op) {
+    case OP_RANDOM: case OP_RANDOM_JPG: case OP_RANDOM_GIF: case OP_CLEAR: return true;
+    case OP_SHOW_FILE: return strcmp(a.path, b.path) == 0;
+    default: return false;
+  }
+}
+
+static void apply(const Cmd &c) {
+  switch (c.op) {
+    case OP_NEXT:       ImageDisplay::nextImage(); break;
+    case OP_PREV:       ImageDisplay::prevImage(); break;
+    case OP_RANDOM:     ImageDisplay::displayRandomImage(); break;
+    case OP_RANDOM_JPG: ImageDisplay::displayRandomJpg(); break;
+    case OP_RANDOM_GIF: ImageDisplay::displayRandomGif(); break;
+    case OP_SHOW_FILE:  if (c.path[0]) ImageDisplay::displayImage(String(c.path)); break;
+    case OP_CLEAR:      ImageDisplay::clear(); break;
+    case OP_SET_MODE:   ImageDisplay::setMode((ImageDisplay::Mode)c.arg); break;
+    case OP_BRIGHTNESS:
+      if (s_tft) s_tft->setBrightness((c.arg * 255) / 100);
+      break;
+    case OP_POWER:
+      if (s_tft) s_tft->powerSave(c.arg == 0);
+      break;
+    case OP_PLAYLIST_RELOAD:
+      ImageDisplay::reloadPlaylist();
+      break;
+  }
+}
+
+void drain() {
+  TRACE_SCOPE("DispQueue::drain");
+  Cmd c;
+  Cmd held;             // applied once we know the next command doesn't repeat it
+  bool holding = false;
+  int steps = 0;        // run of NEXT/PREV folded into a net step
+
+  for (int i = 0; i < DISPQ_MAX_PER_DRAIN && pop(c); ++i) {
+    if (c.op == OP_NEXT || c.op == OP_PREV) {
+      if (holding) { apply(held); holding = false; }
+      steps += (c.op == OP_NEXT) ? 1 : -1;
+      continue;
+    }
+    if (steps) { ImageDisplay::stepImage(steps); steps = 0; }
+    if (holding && collapsible(held, c)) { held = c; continue; }
+    if (holding) { apply(held); holding = false; }
+    if (c.op == OP_SHOW_FILE || c.op == OP_RANDOM || c.op == OP_RANDOM_JPG ||
+        c.op == OP_RANDOM_GIF || c.op == OP_CLEAR) {
+      held = c;
+      holding = true;
+    } else {
+      apply(c);
+    }
+  }
+  if (steps) ImageDisplay::stepImage(steps);
+  if (holding) apply(held);
+}
+
+uint32_t dropped() {
+  return droppedCount.load(std::memory_order_relaxed);
+}
+
+} // namespace DispQueue
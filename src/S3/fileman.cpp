@@ -3,54 +3,54 @@
 #include <FFat.h>
 #include "fileman.h"
 #include "imagedisplay.h"
+#include "disp_queue.h"
+#include "webcache.h"
+#include "thumbs.h"
+#include <esp_rom_crc.h>
+#include "trace.h"
+#include "metrics.h"
+#include <vector>
+#include <algorithm>
+#include <time.h>
+
+// Resumable uploads: chunk size offered to the browser, and the largest body accepted
+#ifndef UPLOAD_CHUNK_SIZE
+#define UPLOAD_CHUNK_SIZE 32768
+#endif
+#ifndef UPLOAD_CHUNK_MAX
+#define UPLOAD_CHUNK_MAX 65536
+#endif
+// Partial uploads live here until complete, then are renamed into place
+#define PART_DIR "/.part"
+// Unfinished resumable uploads: how many are kept, and how long an idle one
+// lives once the clock is set
+#ifndef UPLOAD_PART_MAX
+#define UPLOAD_PART_MAX 4
+#endif
+#ifndef UPLOAD_PART_TTL_S
+#define UPLOAD_PART_TTL_S (24UL * 3600)
+#endif
 
 // --- Internal state ---
 static AsyncWebServer* _server = nullptr;
 
 // --- HTML page strings ---
-static const char* _pageHeader =
-    "<!DOCTYPE html><html><head>"
-    "<title>File Manager</title>"
-    "<meta charset='UTF-8'>"
-    "<meta name='viewport' content='width=480'>"
-"<style>"
-"html, body {"
-"    height: 100%;"
-"    margin: 0;"
-"    padding: 0;"
-"}"
-"body {"
-"    min-height: 100vh;"
-"    display: flex;"
-"    flex-direction: column;"
-"    justify-content: center;"
-"    align-items: center;"
-"    background:#141414;"
-"    color:#EEE;"
-"    font-family:sans-serif;"
-"}"
-"h1, h2 {color:#4eec27;}"
-".centered {"
-"    width: 100%;"
-"    display: flex;"
-"    flex-direction: column;"
-"    align-items: center;"
-"    justify-content: center;"
-"}"
-".section {"
-"    background:#232323;"
-"    padding:16px 18px;"
-"    margin:22px auto;"
-"    border-radius:14px;"
-"    display:inline-block;"
-"}"
-".file-list {margin:10px 0; display:inline-block; text-align:left;}"
-".qbtn {margin:6px 9px 6px 0; padding:10px 20px; background:#444; border:none; color:#fff; border-radius:8px; font-size:1.1em; cursor:pointer; display:inline-block;}"
-".qbtn:hover {background:#299a2c;}"
-"label {font-weight:600;}"
-"input[type=file],button {margin:.7em 0; padding:.5em 1.2em; font-size:1.1em; border-radius:5px; border:1px solid #555;}"
-"</style>"
-"</head><body><div class='centered'>";
+// (styles live in script/web/fileman.css, served pre-gzipped as /ui/fileman.css)
+static String pageHeader() {
+    String html =
+        "<!DOCTYPE html><html><head>"
+        "<title>File Manager</title>"
+        "<meta charset='UTF-8'>"
+        "<meta name='viewport' content='width=480'>";
+    html += "<link rel='stylesheet' href='" + WebCache::assetUrl("/ui/fileman.css", WebAssets::FILEMAN_CSS) + "'>";
+    html += "</head><body><div class='centered'>";
+    return html;
+}
+
+// Upgrades forms with data-kind to resumable chunked uploads
+static String uploadScript() {
+    return "<script defer src='" + WebCache::assetUrl("/ui/upload.js", WebAssets::UPLOAD_JS) + "'></script>";
+}
 
 static const char* _pageFooter =
     "<div style='font-style:italic;color:#444;' id='lostmsg'></div>"
@@ -70,7 +70,12 @@ String buildFileManagerPage();
 String listBootImageSection();
 String listGallerySection();
 String buildResourceManagerPage();
+String buildGalleryPage();
 void handleUpload(AsyncWebServerRequest *request, String filename, size_t index, uint8_t *data, size_t len, bool final);
+void handleUploadStart(AsyncWebServerRequest *request);
+static void prunePartials(const String& keepId, bool atBoot);
+void handleUploadChunk(AsyncWebServerRequest *request);
+void handleUploadChunkBody(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total);
 void handleDelete(AsyncWebServerRequest *request);
 void serveFile(AsyncWebServerRequest *request);
 void handleDisplayRandom(AsyncWebServerRequest *request);
@@ -84,20 +89,32 @@ String getRandomGifImagePath();
 // --- Upload state ---
 File uploadFile;
 String uploadTargetPath;
+String uploadTempPath;
 
 // --- Setup routes and handlers ---
 void FileMan::begin(AsyncWebServer& server) {
     _server = &server;
 
+    // Multipart temp files never survive a reboot; resumable parts do, within limits
+    prunePartials("", true);
+
     // Main UI
+    WebCache::serveAsset(server, "/ui/fileman.css", WebAssets::FILEMAN_CSS);
+    WebCache::serveAsset(server, "/ui/upload.js", WebAssets::UPLOAD_JS);
     server.on("/", HTTP_GET, [](AsyncWebServerRequest *request) {
-        request->send(200, "text/html", buildFileManagerPage());
+        WebCache::sendPage(request, buildFileManagerPage());
     });
 
     // Resource Manager page [ADD]
     server.on("/resource", HTTP_GET, [](AsyncWebServerRequest *request) {
-        request->send(200, "text/html", buildResourceManagerPage());
+        WebCache::sendPage(request, buildResourceManagerPage());
+    });
+
+    // Thumbnail grid (thumbnails are rendered by Thumbs::loop())
+    server.on("/gallery", HTTP_GET, [](AsyncWebServerRequest *request) {
+        WebCache::sendPage(request, buildGalleryPage());
     });
+    WebCache::serveDir(server, "/thumb/", true);
 
     // Serve FFat files
     server.on("/sd/boot", HTTP_GET, serveFile);
@@ -139,6 +156,10 @@ void FileMan::begin(AsyncWebServer& server) {
         }
     );
 
+    // Resumable chunked uploads (script/web/upload.js); the forms above are the fallback
+    server.on("/upload/start", HTTP_POST, handleUploadStart);
+    server.on("/upload/chunk", HTTP_POST, handleUploadChunk, nullptr, handleUploadChunkBody);
+
     // Delete handlers
     server.on("/delete_boot", HTTP_POST, handleDelete);
     server.on("/delete_gallery", HTTP_POST, handleDelete);
@@ -155,11 +176,11 @@ void FileMan::begin(AsyncWebServer& server) {
 
 // --- HTML page builder ---
 String buildFileManagerPage() {
-    String html = _pageHeader;
+    String html = pageHeader();
 
     html += "<div class='section'>";
     html += "<div style='width:100%;text-align:center;margin-bottom:1em'>"
-            "<img src=\"/resource/TD.jpg\" alt=\"Type D\" style=\"width:128px;height:auto;display:block;margin:0 auto;\">"
+            "<img src=\"" + WebCache::url("/resource/TD.jpg") + "\" alt=\"Type D\" style=\"width:128px;height:auto;display:block;margin:0 auto;\">"
             "</div>";
     html += "<h1>File Manager</h1>";
 
@@ -175,6 +196,7 @@ String buildFileManagerPage() {
 
     html += listBootImageSection();
     html += listGallerySection();
+    html += uploadScript();
     html += _pageFooter;
     return html;
 }
@@ -199,7 +221,7 @@ String listBootImageSection() {
     }
     if (!hasBootImg)
         html += "<div>No boot image present.</div>";
-    html += "<form method='POST' enctype='multipart/form-data' action='/upload_boot'>";
+    html += "<form method='POST' enctype='multipart/form-data' action='/upload_boot' data-kind='boot'>";
     html += "<input type='file' name='upload' accept='.jpg,.gif' required><button class='qbtn' type='submit'>Upload</button>";
     html += "</form></div>";
     return html;
@@ -233,7 +255,7 @@ String listGallerySection() {
         jpg.close();
     }
     if (!hasJpg) html += "No jpg files found.";
-    html += "<form method='POST' enctype='multipart/form-data' action='/upload_jpg'>";
+    html += "<form method='POST' enctype='multipart/form-data' action='/upload_jpg' data-kind='jpg'>";
     html += "<input type='file' name='upload' accept='.jpg' multiple required><button class='qbtn' type='submit'>Upload</button></form></div>";
 
     // GIFs
@@ -261,13 +283,14 @@ String listGallerySection() {
         gif.close();
     }
     if (!hasGif) html += "No gif files found.";
-    html += "<form method='POST' enctype='multipart/form-data' action='/upload_gif'>";
+    html += "<form method='POST' enctype='multipart/form-data' action='/upload_gif' data-kind='gif'>";
     html += "<input type='file' name='upload' accept='.gif' multiple required><button class='qbtn' type='submit'>Upload</button></form></div>";
 
     html += "<div style='margin:10px 0;'>";
     html += "<form method='POST' action='/display_random_jpg' style='display:inline;'><button class='qbtn' type='submit'>Random JPG</button></form> ";
     html += "<form method='POST' action='/display_random_gif' style='display:inline;'><button class='qbtn' type='submit'>Random GIF</button></form>";
     html += "<form method='POST' action='/display_random' style='display:inline;'><button class='qbtn' type='submit'>Random Image</button></form>";
+    html += "<a class='qbtn' href='/gallery'>Gallery</a>";
     html += "</div>";
 
     html += "</div>";
@@ -276,7 +299,7 @@ String listGallerySection() {
 
 // --- Resource Manager page builder [ADD] ---
 String buildResourceManagerPage() {
-    String html = _pageHeader;
+    String html = pageHeader();
     html += "<div class='section'><h1>Resource Manager</h1>";
 
     // Space info
@@ -308,9 +331,45 @@ String buildResourceManagerPage() {
         res.close();
     }
     if (!hasResource) html += "No resource files found.";
-    html += "<form method='POST' enctype='multipart/form-data' action='/upload_resource'>";
+    html += "<form method='POST' enctype='multipart/form-data' action='/upload_resource' data-kind='resource'>";
     html += "<input type='file' name='upload' multiple required><button class='qbtn' type='submit'>Upload</button></form></div>";
 
+    html += "<div style='margin:18px 0;'><a class='qbtn' href='/'>Back to File Manager</a></div>";
+    html += "</div>";
+    html += uploadScript();
+    html += _pageFooter;
+    return html;
+}
+
+// --- Gallery page builder ---
+static void addGalleryTiles(String& html, const char* folder, const char* ext, const char* route) {
+    File dir = FFat.open(folder);
+    if (!dir) return;
+    File f = dir.openNextFile();
+    while (f) {
+        String fn = f.name();
+        if (fn.endsWith(ext)) {
+            const String thumb = Thumbs::pathFor(String(folder) + "/" + fn);
+            html += "<a class='tile' target='_blank' href='" + String(route) + "?file=" + fn + "'>";
+            if (FFat.exists(thumb)) {
+                html += "<img loading='lazy' width='" + String(THUMB_SIZE) + "' height='" + String(THUMB_SIZE) +
+                        "' src='" + WebCache::url(thumb, true) + "' alt=''>";
+            } else {
+                html += "<div class='nothumb' style='width:" + String(THUMB_SIZE) + "px;height:" + String(THUMB_SIZE) + "px'></div>";
+            }
+            html += fn + "</a>";
+        }
+        f = dir.openNextFile();
+    }
+    dir.close();
+}
+
+String buildGalleryPage() {
+    String html = pageHeader();
+    html += "<div class='section'><h1>Gallery</h1><div class='grid'>";
+    addGalleryTiles(html, "/jpg", ".jpg", "/sd/jpg");
+    addGalleryTiles(html, "/gif", ".gif", "/sd/gif");
+    html += "</div>";
     html += "<div style='margin:18px 0;'><a class='qbtn' href='/'>Back to File Manager</a></div>";
     html += "</div>";
     html += _pageFooter;
@@ -330,57 +389,356 @@ void serveFile(AsyncWebServerRequest *request) {
         request->send(404, "text/plain", "Invalid file type");
         return;
     }
-    File f = FFat.open(path);
-    if (!f) {
-        request->send(404, "text/plain", "File not found");
-        return;
-    }
     String contentType = file.endsWith(".gif") ? "image/gif" : (file.endsWith(".jpg") ? "image/jpeg" : "application/octet-stream");
-    AsyncWebServerResponse *response = request->beginResponse(f, contentType, false);
-    request->send(response);
-    f.close();
+    WebCache::sendFile(request, path, contentType);
+}
+
+// --- Upload destination for a kind ("boot", "jpg", "gif", "resource"); "" if rejected ---
+static String uploadTarget(const String& kind, const String& filename) {
+    if (!filename.length() || filename.indexOf('/') >= 0 || filename.indexOf("..") >= 0) return "";
+    if (kind == "boot") return filename.endsWith(".gif") ? "/boot/boot.gif" : "/boot/boot.jpg";
+    if (kind == "jpg" || kind == "gif" || kind == "resource") return "/" + kind + "/" + filename;
+    return "";
+}
+
+static void ensureParentDir(const String& path) {
+    int lastSlash = path.lastIndexOf('/');
+    if (lastSlash > 0) {
+        String dir = path.substring(0, lastSlash);
+        if (!FFat.exists(dir.c_str())) FFat.mkdir(dir.c_str());
+    }
+}
+
+// Move a finished temp file over the destination and refresh dependants
+static bool commitUpload(const String& tempPath, const String& targetPath) {
+    ensureParentDir(targetPath);
+    if (FFat.exists(targetPath.c_str())) FFat.remove(targetPath.c_str());
+    if (!FFat.rename(tempPath.c_str(), targetPath.c_str())) {
+        Serial.printf("[FileMan] Rename failed: %s -> %s\n", tempPath.c_str(), targetPath.c_str());
+        return false;
+    }
+    WebCache::invalidate(targetPath);
+    if (targetPath.startsWith("/jpg/") || targetPath.startsWith("/gif/")) Thumbs::queue(targetPath);
+    Serial.printf("[FileMan] Upload complete: %s\n", targetPath.c_str());
+    return true;
 }
 
 // --- Handle upload (called both as request and upload handler) ---
 void handleUpload(AsyncWebServerRequest *request, String filename, size_t index, uint8_t *data, size_t len, bool final) {
+    TRACE_SCOPE("FileMan::upload");
     String url = request->url();
-    String folder = "";
-    String forceName = "";
-
-    if (url == "/upload_boot") {
-        folder = "/boot";
-        forceName = filename.endsWith(".gif") ? "boot.gif" : "boot.jpg";
-    } else if (url == "/upload_jpg") {
-        folder = "/jpg";
-    } else if (url == "/upload_gif") {
-        folder = "/gif";
-    } else if (url == "/upload_resource") {
-        folder = "/resource";
-    } else {
+    if (!url.startsWith("/upload_")) return;
+
+    if (index == 0) {
+        uploadTargetPath = uploadTarget(url.substring(8), filename);
+        if (!uploadTargetPath.length()) {
+            Serial.printf("[FileMan] Rejected upload: %s\n", filename.c_str());
+            return;
+        }
+        // Write beside the destination so a dropped upload never truncates the old file
+        char tmp[32];
+        snprintf(tmp, sizeof(tmp), PART_DIR "/m_%08lx.tmp",
+                 (unsigned long)esp_rom_crc32_le(0, (const uint8_t *)uploadTargetPath.c_str(), uploadTargetPath.length()));
+        uploadTempPath = tmp;
+        ensureParentDir(uploadTempPath);
+        uploadFile = FFat.open(uploadTempPath, FILE_WRITE);
+        Serial.printf("[FileMan] Starting upload: %s\n", uploadTargetPath.c_str());
+    }
+    if (uploadFile) {
+        Metrics::inc(Metrics::UPLOAD_BYTES, uploadFile.write(data, len));
+    }
+    if (final && uploadFile) {
+        uploadFile.close();
+        if (!commitUpload(uploadTempPath, uploadTargetPath)) FFat.remove(uploadTempPath.c_str());
+    }
+}
+
+// --- Resumable uploads ---
+// An upload is identified by CRC32("<target>:<size>:<file crc>"), where the
+// client supplies the CRC32 of the whole file, so a different file with the
+// same name and size never resumes onto stale bytes. Its bytes collect in
+// /.part/<id>.part and /.part/<id>.meta holds "<target>\n<size>\n<file crc>\n
+// <running crc>\n<bytes>". Only chunks whose CRC matched are ever appended, so
+// the part size is the resume offset, and each append extends the running CRC
+// that is compared with the file CRC before the rename. A part whose size
+// disagrees with <bytes> (power lost between the append and the .meta update)
+// is started over.
+static String partPath(const String& id, const char* ext) {
+    return String(PART_DIR "/") + id + ext;
+}
+
+// Drop uploads nobody is coming back for: multipart temps (boot only), a
+// .part whose .meta is gone, anything idle past UPLOAD_PART_TTL_S, and beyond
+// UPLOAD_PART_MAX the least recently written. keepId is never touched.
+static void prunePartials(const String& keepId, bool atBoot) {
+    struct Partial { String id; bool meta; bool part; time_t lastWrite; };
+    std::vector<Partial> list;
+
+    File dir = FFat.open(PART_DIR);
+    if (!dir) return;
+    File f = dir.openNextFile();
+    while (f) {
+        String fn = f.name();
+        const time_t lw = f.getLastWrite();
+        f.close();
+        if (fn.startsWith("m_")) {
+            if (atBoot) FFat.remove(String(PART_DIR "/") + fn);
+        } else if (fn.endsWith(".part") || fn.endsWith(".meta")) {
+            String id = fn.substring(0, fn.length() - 5);
+            auto it = std::find_if(list.begin(), list.end(), [&](const Partial& p) { return p.id == id; });
+            if (it == list.end()) it = list.insert(list.end(), Partial{ id, false, false, 0 });
+            if (fn.endsWith(".meta")) it->meta = true; else it->part = true;
+            if (lw > it->lastWrite) it->lastWrite = lw;
+        }
+        f = dir.openNextFile();
+    }
+    dir.close();
+
+    auto drop = [](const Partial& p, const char* why) {
+        Serial.printf("[FileMan] Dropping partial upload %s (%s)\n", p.id.c_str(), why);
+        FFat.remove(partPath(p.id, ".part").c_str());
+        FFat.remove(partPath(p.id, ".meta").c_str());
+    };
+    const time_t now = time(nullptr);
+    const bool clockSet = now > 1600000000;
+    for (size_t i = 0; i < list.size();) {
+        const Partial& p = list[i];
+        const char* why = nullptr;
+        if (p.id != keepId) {
+            if (!p.meta) why = "orphaned";
+            else if (clockSet && p.lastWrite > 1600000000 && now - p.lastWrite > (time_t)UPLOAD_PART_TTL_S) why = "expired";
+        }
+        if (why) {
+            drop(p, why);
+            list.erase(list.begin() + i);
+        } else {
+            ++i;
+        }
+    }
+
+    // Least recently written go first; a starting upload needs one slot itself
+    std::sort(list.begin(), list.end(), [](const Partial& a, const Partial& b) { return a.lastWrite < b.lastWrite; });
+    const size_t keep = keepId.length() ? UPLOAD_PART_MAX - 1 : UPLOAD_PART_MAX;
+    size_t others = 0;
+    for (const Partial& p : list) others += (p.id != keepId);
+    for (const Partial& p : list) {
+        if (others <= keep) break;
+        if (p.id == keepId) continue;
+        drop(p, "too many");
+        others--;
+    }
+}
+
+static size_t fileSize(const String& path) {
+    File f = FFat.open(path);
+    if (!f) return 0;
+    size_t n = f.size();
+    f.close();
+    return n;
+}
+
+struct PartMeta {
+    String target;
+    size_t size = 0;
+    uint32_t fileCrc = 0;   // client's CRC32 of the whole file
+    uint32_t runCrc = 0;    // CRC32 of the bytes in the part so far
+    size_t runLen = 0;      // bytes covered by runCrc
+};
+
+static bool readPartMeta(const String& id, PartMeta& pm) {
+    if (id.length() != 8) return false;
+    File m = FFat.open(partPath(id, ".meta"));
+    if (!m) return false;
+    pm.target = m.readStringUntil('\n');
+    pm.size = (size_t)m.readStringUntil('\n').toInt();
+    pm.fileCrc = strtoul(m.readStringUntil('\n').c_str(), nullptr, 16);
+    pm.runCrc = strtoul(m.readStringUntil('\n').c_str(), nullptr, 16);
+    pm.runLen = (size_t)m.readStringUntil('\n').toInt();
+    m.close();
+    return pm.target.length() > 0;
+}
+
+static bool writePartMeta(const String& id, const PartMeta& pm) {
+    File m = FFat.open(partPath(id, ".meta"), FILE_WRITE);
+    if (!m) return false;
+    size_t n = m.printf("%s\n%lu\n%08lx\n%08lx\n%lu\n", pm.target.c_str(), (unsigned long)pm.size,
+                        (unsigned long)pm.fileCrc, (unsigned long)pm.runCrc, (unsigned long)pm.runLen);
+    m.close();
+    return n > 0;
+}
+
+static void sendUploadState(AsyncWebServerRequest *request, int code, size_t offset, bool done) {
+    String json = "{\"offset\":" + String((unsigned long)offset);
+    if (done) json += ",\"done\":true";
+    json += "}";
+    request->send(code, "application/json", json);
+}
+
+static void sendUploadError(AsyncWebServerRequest *request, int code, const char* msg) {
+    request->send(code, "application/json", String("{\"error\":\"") + msg + "\"}");
+}
+
+// Every byte is in: check the running CRC against the file CRC, then move the
+// part into place. Replies and returns false on failure; a mismatch discards
+// the part, a failed rename keeps it (and its .meta) for /upload/start to retry.
+static bool finishUpload(AsyncWebServerRequest *request, const String& id, const PartMeta& pm) {
+    String part = partPath(id, ".part");
+    if (pm.runCrc != pm.fileCrc) {
+        Serial.printf("[FileMan] Upload %s failed file CRC (%08lx != %08lx)\n",
+                      pm.target.c_str(), (unsigned long)pm.runCrc, (unsigned long)pm.fileCrc);
+        FFat.remove(part.c_str());
+        FFat.remove(partPath(id, ".meta").c_str());
+        sendUploadError(request, 422, "file crc mismatch");
+        return false;
+    }
+    if (!commitUpload(part, pm.target)) {
+        sendUploadError(request, 500, "rename failed");
+        return false;
+    }
+    FFat.remove(partPath(id, ".meta").c_str());
+    return true;
+}
+
+// POST /upload/start?kind=&name=&size=&crc=<8 hex, whole file> -> {id, offset, chunk}
+void handleUploadStart(AsyncWebServerRequest *request) {
+    String target = uploadTarget(request->arg("kind"), request->arg("name"));
+    if (!target.length() || !request->hasArg("size") || request->arg("crc").length() != 8) {
+        sendUploadError(request, 400, "bad request");
         return;
     }
+    size_t size = (size_t)request->arg("size").toInt();
+    uint32_t fileCrc = strtoul(request->arg("crc").c_str(), nullptr, 16);
+
+    char crcHex[9];
+    snprintf(crcHex, sizeof(crcHex), "%08lx", (unsigned long)fileCrc);
+    String key = target + ":" + String((unsigned long)size) + ":" + crcHex;
+    char id[9];
+    snprintf(id, sizeof(id), "%08lx", (unsigned long)esp_rom_crc32_le(0, (const uint8_t *)key.c_str(), key.length()));
+    String part = partPath(id, ".part");
+
+    if (!FFat.exists(part.c_str())) prunePartials(id, false);   // new upload: make room
+    size_t offset = fileSize(part);
+    PartMeta pm;
+    if (!readPartMeta(id, pm) || pm.runLen != offset || offset > size) {
+        // No running CRC for these bytes: start the part over
+        if (offset) FFat.remove(part.c_str());
+        offset = 0;
+        pm = PartMeta();
+        pm.target = target;
+        pm.size = size;
+        pm.fileCrc = fileCrc;
+        if (!FFat.exists(PART_DIR)) FFat.mkdir(PART_DIR);
+        if (!writePartMeta(id, pm)) {
+            sendUploadError(request, 500, "cannot create upload");
+            return;
+        }
+    }
+    size_t used = FFat.usedBytes(), total = FFat.totalBytes();
+    if (size - offset > (total > used ? total - used : 0)) {
+        sendUploadError(request, 507, "not enough space");
+        return;
+    }
+    if (offset == size) {
+        // Empty file, or every chunk landed but the rename did not
+        if (!FFat.exists(part.c_str())) {
+            File p = FFat.open(part, FILE_WRITE);
+            p.close();
+        }
+        if (!finishUpload(request, id, pm)) return;
+    } else if (offset) {
+        Serial.printf("[FileMan] Resuming upload: %s at %lu/%lu\n", target.c_str(), (unsigned long)offset, (unsigned long)size);
+    }
+    request->send(200, "application/json",
+        String("{\"id\":\"") + id + "\",\"offset\":" + String((unsigned long)offset) +
+        ",\"chunk\":" + String(UPLOAD_CHUNK_SIZE) + "}");
+}
 
+// Body of /upload/chunk: collect the (bounded) chunk in the request's scratch buffer
+void handleUploadChunkBody(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
     if (index == 0) {
-        String targetPath = folder + "/";
-        targetPath += (forceName.length() ? forceName : filename);
-        uploadTargetPath = targetPath;
-        int lastSlash = targetPath.lastIndexOf('/');
-        if (lastSlash > 0) {
-            String dir = targetPath.substring(0, lastSlash);
-            if (!FFat.exists(dir.c_str())) {
-                FFat.mkdir(dir.c_str());
-            }
+        if (total == 0 || total > UPLOAD_CHUNK_MAX) return;   // answered with 413 below
+        request->_tempObject = malloc(total);                  // freed with the request
+    }
+    if (request->_tempObject && index + len <= total)
+        memcpy((uint8_t *)request->_tempObject + index, data, len);
+}
+
+// POST /upload/chunk?id=&offset=&crc=<8 hex> -> {offset[, done]}
+void handleUploadChunk(AsyncWebServerRequest *request) {
+    TRACE_SCOPE("FileMan::uploadChunk");
+    String id = request->arg("id");
+    PartMeta pm;
+    if (!readPartMeta(id, pm)) {
+        sendUploadError(request, 404, "unknown upload");
+        return;
+    }
+    String part = partPath(id, ".part");
+    size_t have = fileSize(part);
+    if (have != pm.runLen) {
+        // A .meta update was lost after an append: start the part over
+        File r = FFat.open(part, FILE_WRITE);
+        r.close();
+        pm.runCrc = 0;
+        pm.runLen = 0;
+        writePartMeta(id, pm);
+        sendUploadState(request, 409, 0, false);
+        return;
+    }
+    size_t offset = (size_t)request->arg("offset").toInt();
+    if (offset != have) {
+        // Tell the client where to continue from
+        sendUploadState(request, 409, have, false);
+        return;
+    }
+    size_t len = request->contentLength();
+    const uint8_t *buf = (const uint8_t *)request->_tempObject;
+    if (!buf || len == 0 || len > UPLOAD_CHUNK_MAX) {
+        sendUploadError(request, 413, "bad chunk size");
+        return;
+    }
+    if (offset + len > pm.size) {
+        sendUploadError(request, 400, "chunk past end");
+        return;
+    }
+    uint32_t want = strtoul(request->arg("crc").c_str(), nullptr, 16);
+    if (esp_rom_crc32_le(0, buf, len) != want) {
+        sendUploadError(request, 422, "crc mismatch");
+        return;
+    }
+
+    File p = FFat.open(part, FILE_APPEND);
+    size_t wrote = 0;
+    if (p) {
+        wrote = p.write(buf, len);
+        p.close();
+    }
+    if (wrote != len) {
+        // FFat can't truncate: drop a torn tail by starting the part over,
+        // so the offset always sits on a verified boundary
+        if (wrote) {
+            File r = FFat.open(part, FILE_WRITE);
+            r.close();
+            pm.runCrc = 0;
+            pm.runLen = 0;
+            writePartMeta(id, pm);
         }
-        uploadFile = FFat.open(targetPath, FILE_WRITE);
-        Serial.printf("[FileMan] Starting upload: %s\n", targetPath.c_str());
+        sendUploadError(request, 507, "write failed");
+        return;
     }
-    if (uploadFile) {
-        uploadFile.write(data, len);
+    have += len;
+    pm.runCrc = esp_rom_crc32_le(pm.runCrc, buf, len);
+    pm.runLen = have;
+    if (!writePartMeta(id, pm)) {
+        sendUploadError(request, 500, "cannot update upload");
+        return;
     }
-    if (final) {
-        if (uploadFile) uploadFile.close();
-        Serial.printf("[FileMan] Upload complete: %s\n", uploadTargetPath.c_str());
+    Metrics::inc(Metrics::UPLOAD_BYTES, len);
+    if (have == pm.size) {
+        if (!finishUpload(request, id, pm)) return;
+        sendUploadState(request, 200, have, true);
+        return;
     }
+    sendUploadState(request, 200, have, false);
 }
 
 // --- Handle file delete (PATCHED for Serial debug & file/dir check) ---
@@ -391,6 +749,8 @@ void handleDelete(AsyncWebServerRequest *request) {
 
     if (FFat.exists(path.c_str())) {
         FFat.remove(path.c_str());
+        WebCache::invalidate(path);
+        Thumbs::remove(path);
         Serial.printf("[FileMan] Deleted: %s\n", path.c_str());
     } else {
         Serial.printf("[FileMan] File not found for delete: %s\n", path.c_str());
@@ -399,24 +759,24 @@ void handleDelete(AsyncWebServerRequest *request) {
     request->redirect(redirect);
 }
 
-// --- Display random image helpers/handlers ---
+// --- Display handlers: queue for the render loop, redirect immediately ---
+static void queueAndRedirect(AsyncWebServerRequest *request, DispQueue::Op op, const char *path = nullptr) {
+    if (DispQueue::post(op, 0, path)) request->redirect("/");
+    else request->send(503, "text/plain", "Display busy, try again");
+}
 void handleDisplayRandom(AsyncWebServerRequest *request) {
-    ImageDisplay::displayRandomImage();
-    request->redirect("/");
+    queueAndRedirect(request, DispQueue::OP_RANDOM);
 }
 void handleDisplayRandomJpg(AsyncWebServerRequest *request) {
-    ImageDisplay::displayRandomJpg();
-    request->redirect("/");
+    queueAndRedirect(request, DispQueue::OP_RANDOM_JPG);
 }
 void handleDisplayRandomGif(AsyncWebServerRequest *request) {
-    ImageDisplay::displayRandomGif();
-    request->redirect("/");
+    queueAndRedirect(request, DispQueue::OP_RANDOM_GIF);
 }
 
 void handleSelectImage(AsyncWebServerRequest *request) {
     String folder = request->arg("folder");
     String file = request->arg("file");
     String path = folder + "/" + file;
-    ImageDisplay::displayImage(path);
-    request->redirect("/");
+    queueAndRedirect(request, DispQueue::OP_SHOW_FILE, path.c_str());
 }
@@ -8,12 +8,21 @@
 #include <LovyanGFX.hpp>
 #include "esp_heap_caps.h"
 #include "disp_cfg.h"
+#include "playlist.h"
 #include <WiFi.h>
 #include <esp_system.h>
 #include <ctime>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "trace.h"
+#include "metrics.h"
 
 class LGFX;
 
+#define IMAGE_DEFAULT_DWELL_MS   2000   // still images outside a playlist
+#define IMAGE_DEFAULT_GIF_LOOPS  1      // GIFs outside a playlist
+#define IMAGE_IDLE_RETRY_MS      1000   // nothing to show: look again after this
+
 namespace ImageDisplay {
 
 bool paused = false;
@@ -30,9 +39,6 @@ static int imgIndex = 0;
 static unsigned long lastImageChange = 0;
 static bool currentIsGif = false;
 
-// --- PATCH: Flag for deferred random image trigger ---
-volatile bool g_triggerRandomImage = false;
-
 // --- RAMGIFHandle for GIF-in-RAM logic ---
 struct RAMGIFHandle {
     uint8_t *data;
@@ -40,9 +46,37 @@ struct RAMGIFHandle {
     size_t pos;
 };
 static RAMGIFHandle* s_gifHandle = nullptr;
+static void freeRamGifHandle();
 
 static bool imageDone = false;
 
+// --- Deadline scheduler: one deadline for "next GIF frame" or "item over" ---
+static uint32_t nextDeadline = 0;   // millis() when update() has work to do
+static uint32_t itemEndAt = 0;      // dwell end of the current item
+static uint8_t gifLoopsLeft = 0;    // 0 = loop until itemEndAt
+static bool itemFinished = false;   // current item done; advance at nextDeadline
+
+static void finishItem(uint32_t at) {
+    if (currentIsGif) {
+        gif.close();
+        freeRamGifHandle();
+    }
+    currentIsGif = false;
+    itemFinished = true;
+    imageDone = true;
+    nextDeadline = at;
+}
+
+// True if nextImage() in the current mode has anything left to try
+static bool havePlayable() {
+    switch (currentMode) {
+        case MODE_PLAYLIST: return Playlist::hasPlayable();
+        case MODE_JPG:      return !jpgList.empty();
+        case MODE_GIF:      return !gifList.empty();
+        default:            return !randomStack.empty();
+    }
+}
+
 void removeFromPlaylist(const String& path) {
     auto removeIt = [&](std::vector<String>& list) {
         list.erase(std::remove(list.begin(), list.end(), path), list.end());
@@ -52,6 +86,15 @@ void removeFromPlaylist(const String& path) {
     removeIt(randomStack);
 }
 
+// An item that can't be shown is dropped from the file lists and the compiled
+// playlist. Advance at once if something else can play; otherwise hold for
+// the default dwell instead of retrying the same failure on every update().
+static void skipItem(const String& path, uint32_t now) {
+    removeFromPlaylist(path);
+    Playlist::markMissing(path.c_str());
+    finishItem(havePlayable() ? now : now + IMAGE_DEFAULT_DWELL_MS);
+}
+
 void setPaused(bool p) { paused = p; }
 
 void drawNoImagesMessage(LGFX* tft) {
@@ -153,6 +196,45 @@ void begin(LGFX* tft) {
     currentMode = MODE_RANDOM;
 }
 
+// --- Boot: index FFat and load the playlist while setup() plays the boot animation ---
+static SemaphoreHandle_t s_ready = nullptr;
+
+static void indexTask(void*) {
+    const uint32_t t0 = millis();
+    refreshFileLists();
+    reloadPlaylist();
+    Serial.printf("[ImageDisplay] Indexed %u jpg, %u gif in %lu ms\n",
+                  (unsigned)jpgList.size(), (unsigned)gifList.size(), (unsigned long)(millis() - t0));
+    xSemaphoreGive(s_ready);
+    vTaskDelete(nullptr);
+}
+
+void beginAsync(LGFX* tft) {
+    _tft = tft;
+    if (!seeded) {
+        rng.seed(esp_random() ^ millis());
+        seeded = true;
+    }
+    currentMode = MODE_RANDOM;
+    s_ready = xSemaphoreCreateBinary();
+    // Core 0 beside the WiFi stack; the loop task on core 1 keeps the animation smooth
+    if (!s_ready || xTaskCreatePinnedToCore(indexTask, "imgidx", 6144, nullptr, 1, nullptr, 0) != pdPASS) {
+        Serial.println("[ImageDisplay] Index task failed, indexing inline");
+        if (s_ready) vSemaphoreDelete(s_ready);
+        s_ready = nullptr;
+        refreshFileLists();
+        reloadPlaylist();
+    }
+}
+
+bool waitReady(uint32_t timeoutMs) {
+    if (!s_ready) return true;
+    if (xSemaphoreTake(s_ready, pdMS_TO_TICKS(timeoutMs)) != pdTRUE) return false;
+    vSemaphoreDelete(s_ready);
+    s_ready = nullptr;
+    return true;
+}
+
 void setMode(Mode m) {
     currentMode = m;
     imgIndex = 0;
@@ -197,7 +279,10 @@ void refreshFileLists() {
     }
 }
 
-void displayImage(const String& path) {
+// Show one item. Still images are drawn here; GIFs are only opened and then
+// played frame by frame from update() on the deadline scheduler.
+static void showItem(const String& path, uint32_t dwellMs, uint8_t loops) {
+    TRACE_SCOPE("ImageDisplay::showItem");
     if (!_tft) {
         Serial.println("[ImageDisplay] _tft pointer is NULL!");
         return;
@@ -209,6 +294,12 @@ void displayImage(const String& path) {
 
     currentIsGif = false;
     imageDone = false;
+    itemFinished = false;
+
+    const uint32_t now = millis();
+    lastImageChange = now;
+    itemEndAt = now + dwellMs;
+    nextDeadline = itemEndAt;
 
     String lower = path;
     lower.toLowerCase();
@@ -218,12 +309,11 @@ void displayImage(const String& path) {
         if (!jpgFile || jpgFile.size() == 0) {
             Serial.printf("[ImageDisplay] JPG missing or empty: %s\n", path.c_str());
             if (jpgFile) jpgFile.close();
-            removeFromPlaylist(path);
-            if (!jpgList.empty()) nextImage(); // Patch: Prevent infinite recursion
-            else if (_tft) drawNoImagesMessage(_tft);
+            skipItem(path, now);
             return;
         }
         size_t jpgSize = jpgFile.size();
+        const uint32_t t0 = micros();
         uint8_t* jpgBuffer = (uint8_t*)heap_caps_malloc(jpgSize, MALLOC_CAP_SPIRAM);
         if (jpgBuffer) {
             int bytesRead = jpgFile.read(jpgBuffer, jpgSize);
@@ -234,6 +324,7 @@ void displayImage(const String& path) {
             _tft->drawJpg(jpgBuffer, jpgSize, 0, 0);
             heap_caps_free(jpgBuffer);
             jpgBuffer = nullptr;
+            Metrics::observe(Metrics::HIST_JPG_DECODE, micros() - t0);
         } else {
             jpgFile.close();
             Serial.println("[ImageDisplay] PSRAM alloc failed!");
@@ -243,10 +334,7 @@ void displayImage(const String& path) {
         if (!f || f.size() == 0) {
             Serial.printf("[ImageDisplay] GIF missing or empty: %s\n", path.c_str());
             if (f) f.close();
-            removeFromPlaylist(path);
-            if (!gifList.empty()) nextImage(); // Patch: Prevent infinite recursion
-            else if (_tft) drawNoImagesMessage(_tft);
-            imageDone = true;
+            skipItem(path, now);
             return;
         }
         size_t gifSize = f.size();
@@ -262,39 +350,26 @@ void displayImage(const String& path) {
             gif.begin(GIF_PALETTE_RGB565_BE);
             if (gif.open("", GIFOpenRAM, GIFCloseRAM, GIFReadRAM, GIFSeekRAM, gifDraw)) {
                 currentIsGif = true;
-                int startLoop = gif.getLoopCount();
-                int frameDelay = 0;
-                while (gif.playFrame(true, &frameDelay)) {
-                    delay(frameDelay);
-                    yield();
-                    if (gif.getLoopCount() > startLoop) break;
-                }
-                gif.close();
-                freeRamGifHandle();
-                currentIsGif = false;
-                imageDone = true;
+                gifLoopsLeft = loops;
+                nextDeadline = now;   // first frame on the next update()
             } else {
                 Serial.println("[ImageDisplay] GIF decoder failed to open RAM file!");
                 freeRamGifHandle();
-                currentIsGif = false;
-                imageDone = true;
+                skipItem(path, now);
             }
         } else {
             f.close();
             Serial.println("[ImageDisplay] GIF PSRAM alloc failed!");
-            currentIsGif = false;
-            imageDone = true;
+            finishItem(now + IMAGE_DEFAULT_DWELL_MS);   // may fit later; don't spin
         }
     } else {
         Serial.println("[ImageDisplay] Unknown file type or open/size failed!");
-        imageDone = true;
+        skipItem(path, now);
     }
-    lastImageChange = millis();
 }
 
-// --- PATCH: Only call this from main loop! ---
-void triggerRandomImage() {
-    g_triggerRandomImage = true;
+void displayImage(const String& path) {
+    showItem(path, IMAGE_DEFAULT_DWELL_MS, IMAGE_DEFAULT_GIF_LOOPS);
 }
 
 void displayRandomImage() {
@@ -333,61 +408,102 @@ void displayRandomGif() {
     displayImage(gifList[imgIndex]);
 }
 
-void nextImage() {
-    if (currentMode == MODE_RANDOM && !randomStack.empty()) {
-        imgIndex = (imgIndex + 1) % randomStack.size();
-        displayImage(randomStack[imgIndex]);
-    } else if (currentMode == MODE_JPG && !jpgList.empty()) {
-        imgIndex = (imgIndex + 1) % jpgList.size();
-        displayImage(jpgList[imgIndex]);
-    } else if (currentMode == MODE_GIF && !gifList.empty()) {
-        imgIndex = (imgIndex + 1) % gifList.size();
-        displayImage(gifList[imgIndex]);
+// Move |delta| items forward (delta > 0) or back, decoding only the one we land on
+void stepImage(int delta) {
+    if (delta == 0) return;
+    const std::vector<String>* list =
+        (currentMode == MODE_RANDOM) ? &randomStack :
+        (currentMode == MODE_JPG)    ? &jpgList :
+        (currentMode == MODE_GIF)    ? &gifList : nullptr;
+    if (list && !list->empty()) {
+        const int n = (int)list->size();
+        imgIndex = ((imgIndex + delta) % n + n) % n;
+        displayImage((*list)[imgIndex]);
+    } else if (currentMode == MODE_PLAYLIST) {
+        Playlist::Entry e;
+        bool ok = false;
+        for (int i = 0; i < abs(delta); ++i) ok = (delta > 0) ? Playlist::next(e) : Playlist::prev(e);
+        if (ok) showItem(String(e.path), e.durationMs, e.loops);
     }
 }
 
-void prevImage() {
-    if (currentMode == MODE_RANDOM && !randomStack.empty()) {
-        imgIndex = (imgIndex - 1 + randomStack.size()) % randomStack.size();
-        displayImage(randomStack[imgIndex]);
-    } else if (currentMode == MODE_JPG && !jpgList.empty()) {
-        imgIndex = (imgIndex - 1 + jpgList.size()) % jpgList.size();
-        displayImage(jpgList[imgIndex]);
-    } else if (currentMode == MODE_GIF && !gifList.empty()) {
-        imgIndex = (imgIndex - 1 + gifList.size()) % gifList.size();
-        displayImage(gifList[imgIndex]);
+void nextImage() { stepImage(1); }
+
+void prevImage() { stepImage(-1); }
+
+void reloadPlaylist() {
+    if (Playlist::load()) {
+        Serial.println("[ImageDisplay] Playlist active");
+        setMode(MODE_PLAYLIST);
+        finishItem(millis());
+    } else if (currentMode == MODE_PLAYLIST) {
+        Serial.println("[ImageDisplay] Playlist gone, back to random");
+        setMode(MODE_RANDOM);
+        randomStack.clear();
+        finishItem(millis());
     }
 }
 
-// --- PATCH: In your main Arduino loop, call this! ---
+void resume() {
+    if (currentMode == MODE_PLAYLIST) nextImage();
+    else displayRandomImage();
+}
+
 void loop() {
-    if (g_triggerRandomImage) {
-        g_triggerRandomImage = false;
-        displayRandomImage();
-    }
-    // ... add any other periodic updates here if needed ...
+    // No changes
 }
 
+// Every mode auto-advances. update() is a cheap deadline check until either
+// the next GIF frame or the end of the current item is due.
 void update() {
-    if (paused) return; 
-    if (currentMode != MODE_RANDOM) return;
-    if (randomStack.empty()) {  // <--- ADDED
-        if (_tft) drawNoImagesMessage(_tft);
+    TRACE_SCOPE("ImageDisplay::update");
+    if (paused) return;
+    const uint32_t now = millis();
+    if ((int32_t)(now - nextDeadline) < 0) return;
+
+    if (currentMode == MODE_RANDOM && randomStack.empty()) {  // <--- ADDED
+        // Rescan now and then; draws the "please upload" message while empty
+        itemFinished = false;
+        nextDeadline = now + 5 * IMAGE_IDLE_RETRY_MS;
+        displayRandomImage();
         return;
     }
+
+    if (itemFinished) {
+        itemFinished = false;
+        nextDeadline = now + IMAGE_IDLE_RETRY_MS;   // overridden if an item starts
+        nextImage();
+        return;
+    }
+
     if (!currentIsGif) {
-        if (millis() - lastImageChange > 2000) {
-            imgIndex = (imgIndex + 1) % randomStack.size();
-            displayImage(randomStack[imgIndex]);
-        }
-    } else {
-        int ret = gif.playFrame(false, nullptr);
-        if (ret == 0) {
-            imgIndex = (imgIndex + 1) % randomStack.size();
-            displayImage(randomStack[imgIndex]);
-            imageDone = true;
+        finishItem(now);                            // still image dwell over
+        return;
+    }
+
+    int frameDelay = 0;
+    const uint32_t t0 = micros();
+    int ret = gif.playFrame(false, &frameDelay);
+    if (ret >= 0) {
+        Metrics::observe(Metrics::HIST_GIF_FRAME, micros() - t0);
+        Metrics::inc(Metrics::GIF_FRAMES);
+    }
+    if (ret < 0) {
+        finishItem(now);
+        return;
+    }
+    if (ret == 0) {                                 // last frame of a loop drawn
+        if (gifLoopsLeft && --gifLoopsLeft == 0) {
+            finishItem(now + frameDelay);
+            return;
         }
+        gif.reset();
+    }
+    if (!gifLoopsLeft && (int32_t)(now - itemEndAt) >= 0) {
+        finishItem(now + frameDelay);
+        return;
     }
+    nextDeadline = now + (frameDelay > 0 ? frameDelay : 1);
 }
 
 void showIdle() {
@@ -395,6 +511,7 @@ void showIdle() {
 }
 
 void clear() {
+    finishItem(millis() + IMAGE_DEFAULT_DWELL_MS);   // stop any GIF, hold black
     if (_tft) _tft->fillScreen(TFT_BLACK);
 }
 
@@ -15,11 +15,18 @@ namespace ImageDisplay {
 enum Mode {
     MODE_RANDOM,
     MODE_JPG,
-    MODE_GIF
+    MODE_GIF,
+    MODE_PLAYLIST
 };
 
 void begin(LGFX* tft);
 
+// Boot variant of begin() + reloadPlaylist(): indexes FFat and loads the saved
+// playlist on a one-shot task so it overlaps the boot animation. Nothing else
+// may touch ImageDisplay until waitReady() returns true.
+void beginAsync(LGFX* tft);
+bool waitReady(uint32_t timeoutMs);
+
 void setMode(Mode m);
 Mode getMode();
 
@@ -29,10 +36,17 @@ void displayImage(const String& path);
 void displayRandomImage();
 void displayRandomJpg();
 void displayRandomGif();
-void triggerRandomImage();
 
 void nextImage();
 void prevImage();
+void stepImage(int delta);   // net of several next/prev clicks, one decode
+
+// (Re)load /playlist.bin; switches to MODE_PLAYLIST if valid, back to random if
+// the playlist went away. Render loop only (queued via DispQueue from web).
+void reloadPlaylist();
+
+// Continue the slideshow after an overlay: next playlist item or a fresh random pick
+void resume();
 
 void loop();
 void update();
@@ -0,0 +1,46 @@
+// metrics.h
+//
+// Prometheus text exposition on GET /metrics (port 8080) for fleet scraping.
+// Hot paths only bump relaxed atomics (inc() / observe()); everything else
+// (heap, WiFi, Detect counters) is sampled when /metrics is rendered.
+
+#pragma once
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include <atomic>
+
+#define METRICS_MAX_BOUNDS 10          // histogram buckets, +Inf not counted
+
+namespace Metrics {
+
+  enum Counter : uint8_t {
+    UDP_RX_CORE,      // telemetry datagrams accepted, port 50504
+    UDP_RX_EXP,       // ... port 50505
+    UDP_DROP_CORE,    // wrong-size datagrams discarded, port 50504
+    UDP_DROP_EXP,     // ... port 50505
+    GIF_FRAMES,       // slideshow GIF frames drawn
+    UPLOAD_BYTES,     // file manager upload payload written to FFat
+    COUNTER_COUNT
+  };
+
+  enum Hist : uint8_t {
+    HIST_LOOP,        // main loop iteration period
+    HIST_JPG_DECODE,  // slideshow JPG read + decode + draw
+    HIST_GIF_FRAME,   // one GIF frame decode + draw
+    HIST_COUNT
+  };
+
+  extern std::atomic<uint32_t> g_counters[COUNTER_COUNT];
+
+  // Any task
+  inline void inc(Counter c, uint32_t n = 1) {
+    g_counters[c].fetch_add(n, std::memory_order_relaxed);
+  }
+  void observe(Hist h, uint32_t us);
+
+  // Register GET /metrics
+  void begin(AsyncWebServer &server);
+
+  // Main loop, once per iteration: loop period histogram and the GIF fps gauge
+  void loop();
+}
@@ -0,0 +1,40 @@
+// playlist.h
+//
+// Timeline playlist: ordered or weighted items with per-item duration,
+// GIF loop count and time-of-day window. Stored as /playlist.bin in FFat,
+// compiled at load into per-time-segment schedules so next() is O(1).
+
+#pragma once
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+
+namespace Playlist {
+
+  struct Entry {
+    const char *path;
+    uint32_t durationMs;   // still images: dwell; GIFs: minimum play time when loops == 0
+    uint8_t loops;         // GIFs: play this many loops (0 = loop until durationMs)
+  };
+
+  // Registers GET/POST/DELETE /api/playlist and starts SNTP for windows
+  void begin(AsyncWebServer &server);
+
+  // Render loop only: (re)load /playlist.bin and compile it. False if none/invalid.
+  bool load();
+
+  // Render loop only: true if a compiled playlist is active
+  bool isLoaded();
+
+  // Render loop only: O(1) pick of the next/previous item for the current
+  // time of day. False if nothing is eligible right now.
+  bool next(Entry &out);
+  bool prev(Entry &out);
+
+  // Render loop only: the item's file is missing or unreadable. next()/prev()
+  // skip it until the playlist is loaded again.
+  void markMissing(const char *path);
+
+  // Render loop only: true if the current time segment has an item left to play
+  bool hasPlayable();
+
+} // namespace Playlist
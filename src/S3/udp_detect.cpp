@@ -2,6 +2,8 @@
 #include <WiFiUdp.h>
 #include "xbox_status.h"
 #include <cstring>  // memcpy, strncpy
+#include "trace.h"
+#include "metrics.h"
 
 #define UDP_PORT_CORE   50504
 #define UDP_PORT_EXP    50505
@@ -11,6 +13,7 @@ static WiFiUDP udpExp;
 
 static XboxStatus lastStatus;
 static bool gotPacket = false;
+static uint32_t statusSeq = 0;
 
 // --- Wire format for core telemetry (50504) ---
 struct CorePacket {
@@ -42,6 +45,7 @@ void UDPDetect::begin() {
 }
 
 void UDPDetect::loop() {
+    TRACE_SCOPE("UDPDetect::loop");
     // --- Core telemetry (Fan/CPU/Ambient/App) ---
     int sz = udpCore.parsePacket();
     if (sz == (int)sizeof(CorePacket)) {
@@ -55,14 +59,18 @@ void UDPDetect::loop() {
             lastStatus.currentApp[sizeof(lastStatus.currentApp) - 1] = '\0';
 
             gotPacket = true;
+            statusSeq++;
+            Metrics::inc(Metrics::UDP_RX_CORE);
             Serial.printf("[UDPDetect] Core: Fan=%d, CPU=%d, Amb=%d, App='%s'\n",
                           lastStatus.fanSpeed, lastStatus.cpuTemp,
                           lastStatus.ambientTemp, lastStatus.currentApp);
         } else {
             uint8_t tmp[sz]; udpCore.read(tmp, sz);
+            Metrics::inc(Metrics::UDP_DROP_CORE);
         }
     } else if (sz > 0) {
         uint8_t tmp[sz]; udpCore.read(tmp, sz);
+        Metrics::inc(Metrics::UDP_DROP_CORE);
     }
 
     // --- Expansion telemetry (7 x int32_t, little-endian) ---
@@ -92,16 +100,21 @@ void UDPDetect::loop() {
             formatResolution(width, height, lastStatus.resolution, sizeof(lastStatus.resolution));
 
             gotPacket = true;
+            statusSeq++;
+            Metrics::inc(Metrics::UDP_RX_EXP);
             Serial.printf("[UDPDetect] Exp: Tray=%d, AV=%d, PIC=%d, XboxVer=%d, Encoder=%d, Res=%s\n",
                           tray, av, pic, xboxver, encoder, lastStatus.resolution);
         } else {
             uint8_t tmp[sz]; udpExp.read(tmp, sz);
+            Metrics::inc(Metrics::UDP_DROP_EXP);
         }
     } else if (sz > 0) {
         uint8_t tmp[sz]; udpExp.read(tmp, sz);
+        Metrics::inc(Metrics::UDP_DROP_EXP);
     }
 }
 
 bool UDPDetect::hasPacket() { return gotPacket; }
 void UDPDetect::acknowledge() { gotPacket = false; }
 const XboxStatus& UDPDetect::getLatest() { return lastStatus; }
+uint32_t UDPDetect::getSeq() { return statusSeq; }
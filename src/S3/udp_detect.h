@@ -8,4 +8,6 @@ namespace UDPDetect {
     bool hasPacket();
     const XboxStatus& getLatest();
     void acknowledge();
+    // Increments on every decoded packet (core or expansion)
+    uint32_t getSeq();
 }
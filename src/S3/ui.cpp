@@ -4,6 +4,7 @@
 #include "imagedisplay.h"
 #include "ui_set.h"
 #include "ui_about.h"
+#include "trace.h"
 
 static LGFX* _tft = nullptr;
 CST816S touch(TOUCH_SDA, TOUCH_SCL, TOUCH_RST, TOUCH_INT);
@@ -62,6 +63,7 @@ void UI::drawMenu() {
 }
 
 void UI::update() {
+    TRACE_SCOPE("UI::update");
     if (touch.available()) {
         const data_struct& d = touch.data;
 
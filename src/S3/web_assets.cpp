@@ -0,0 +1,256 @@
+// web_assets.cpp
+//
+// GENERATED by script/web_gz.py from script/web/ -- do not edit.
+
+#include "web_assets.h"
+
+static const uint8_t DIAG_CSS_GZ[] PROGMEM = {
+  0x1F, 0x8B, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x95, 0x52, 0x4D, 0x8F, 0x9B, 0x30,
+  0x10, 0xBD, 0xE7, 0x57, 0x58, 0x5A, 0xF5, 0xB6, 0x44, 0x40, 0x68, 0x1A, 0x8C, 0x7A, 0xCC, 0xAF,
+  0xA8, 0x7A, 0x30, 0xF6, 0x10, 0xDC, 0x18, 0x9B, 0xDA, 0x66, 0x37, 0x34, 0xCA, 0x7F, 0xAF, 0xBF,
+  0x92, 0x42, 0xB5, 0x39, 0x2C, 0x08, 0x0B, 0x7B, 0x66, 0xDE, 0xBC, 0xF7, 0xC6, 0xBD, 0x1D, 0xC4,
+  0x2B, 0x6A, 0x15, 0x9B, 0xD1, 0x75, 0x83, 0xDC, 0xD3, 0x03, 0x3F, 0xF5, 0x16, 0xA3, 0x22, 0xCF,
+  0xBF, 0x34, 0xE1, 0x64, 0x20, 0xFA, 0xC4, 0x25, 0x46, 0x79, 0xDC, 0x8E, 0x84, 0x31, 0x2E, 0x4F,
+  0x61, 0x7F, 0xDB, 0x2C, 0x2A, 0x07, 0x2E, 0xB3, 0x45, 0xF5, 0x5B, 0x1F, 0xF3, 0x19, 0x37, 0xA3,
+  0x20, 0x33, 0x46, 0x9D, 0x80, 0x4B, 0x3C, 0xF2, 0x7F, 0x19, 0xE3, 0x1A, 0xA8, 0xE5, 0xCA, 0x21,
+  0x53, 0x25, 0xA6, 0x41, 0xC6, 0xD8, 0xAF, 0xC9, 0x58, 0xDE, 0xCD, 0x19, 0x55, 0xD2, 0x82, 0x74,
+  0x50, 0xD4, 0xAD, 0xA0, 0x63, 0x90, 0x08, 0x7E, 0x92, 0x19, 0xB7, 0x30, 0x98, 0x75, 0xA0, 0x25,
+  0xF4, 0x7C, 0xD2, 0x6A, 0x92, 0x0C, 0xBF, 0x14, 0x95, 0x7F, 0xE3, 0xB9, 0x43, 0x56, 0x1A, 0xBF,
+  0x1C, 0x8F, 0xC7, 0xD4, 0xD9, 0xA1, 0x66, 0x1D, 0x19, 0xB8, 0x98, 0xB1, 0x21, 0xD2, 0x64, 0x06,
+  0x34, 0xEF, 0xBC, 0x90, 0xBE, 0x78, 0x45, 0x7D, 0x89, 0xAE, 0xA9, 0xA2, 0x02, 0xA0, 0xE5, 0xB7,
+  0xE6, 0xB6, 0xD9, 0xC6, 0x36, 0xC0, 0x92, 0xCA, 0x77, 0xCE, 0x6C, 0xBF, 0xB4, 0xE7, 0x93, 0xFA,
+  0x9E, 0x4A, 0x78, 0x2A, 0xDC, 0x71, 0x30, 0x11, 0x29, 0x51, 0x58, 0x8A, 0x2D, 0x77, 0xFE, 0x5D,
+  0x4F, 0xA6, 0xD8, 0x8F, 0x17, 0x54, 0x1C, 0xC6, 0xCB, 0x6A, 0x7E, 0x65, 0xE9, 0x4E, 0xC9, 0x64,
+  0x55, 0x72, 0x4C, 0x69, 0x06, 0x3A, 0xD3, 0x84, 0xF1, 0xC9, 0xE0, 0xA2, 0xBA, 0x67, 0xDF, 0xE5,
+  0x70, 0x29, 0xB8, 0x84, 0xAC, 0x15, 0x8A, 0x9E, 0x03, 0x07, 0xDA, 0x03, 0x3D, 0x0B, 0x6E, 0x2C,
+  0xBA, 0x26, 0xC4, 0x1C, 0xE5, 0xA1, 0x8D, 0xBB, 0x09, 0xC8, 0xC2, 0xC5, 0x66, 0x41, 0x1B, 0x16,
+  0xD0, 0xD9, 0xE6, 0x63, 0x9C, 0x3B, 0x8C, 0x97, 0xFF, 0x80, 0x29, 0x23, 0xC2, 0x9D, 0x7D, 0xDC,
+  0xBA, 0xCC, 0x91, 0x18, 0xF3, 0x6F, 0x1E, 0x35, 0x94, 0x15, 0x34, 0x71, 0x80, 0xEF, 0xF1, 0x96,
+  0xB5, 0x4A, 0x30, 0x9F, 0xD8, 0x11, 0x2E, 0x1E, 0x89, 0xC0, 0x76, 0x74, 0x47, 0x3F, 0x4E, 0xFC,
+  0xDD, 0x5A, 0xF9, 0x68, 0xEB, 0x4D, 0xAA, 0xDD, 0xB7, 0x5F, 0xB7, 0x2F, 0x72, 0xB7, 0x2F, 0xDD,
+  0xD2, 0xAC, 0x7C, 0xAE, 0xAA, 0xAA, 0x49, 0x9E, 0x61, 0xA9, 0xA4, 0x63, 0x92, 0xFA, 0x75, 0x5D,
+  0xD7, 0xFC, 0x67, 0xA6, 0x77, 0x3E, 0xF6, 0x37, 0xFC, 0x0F, 0xE0, 0x62, 0x5B, 0xC0, 0xE0, 0xF2,
+  0x27, 0x6D, 0x5C, 0xC1, 0xA8, 0x78, 0x18, 0xEB, 0x53, 0x83, 0x3C, 0x49, 0xDC, 0xAB, 0x37, 0xD0,
+  0xE8, 0xBA, 0x9A, 0x74, 0x5D, 0x93, 0x92, 0x06, 0xBD, 0x4A, 0x59, 0x1F, 0x4D, 0x42, 0x76, 0x41,
+  0x01, 0x2A, 0x92, 0x8F, 0x89, 0xD7, 0xE1, 0x70, 0x58, 0x92, 0xD8, 0xD6, 0x5F, 0x1D, 0x89, 0xDB,
+  0x46, 0x90, 0x16, 0x9C, 0x59, 0x4B, 0x77, 0xF6, 0xB9, 0xB7, 0x9B, 0xCB, 0x71, 0xB2, 0x3F, 0xEC,
+  0x3C, 0xC2, 0x77, 0x39, 0x0D, 0x2D, 0xE8, 0x9F, 0xE8, 0x1A, 0xEF, 0xFA, 0x3E, 0x98, 0xF1, 0x98,
+  0x79, 0x15, 0xBA, 0x05, 0x8D, 0xCB, 0x91, 0xF9, 0x0B, 0x74, 0xDB, 0xFC, 0x05, 0x84, 0x6C, 0x30,
+  0x41, 0x4F, 0x04, 0x00, 0x00,
+};
+
+static const uint8_t FILEMAN_CSS_GZ[] PROGMEM = {
+  0x1F, 0x8B, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x95, 0x54, 0xCB, 0x92, 0xDB, 0x20,
+  0x10, 0xBC, 0xFB, 0x2B, 0xA8, 0xDA, 0xCA, 0xCD, 0x52, 0x09, 0x45, 0xF6, 0xC6, 0xA8, 0x72, 0xDC,
+  0xAF, 0x48, 0xE5, 0x80, 0x60, 0x24, 0x91, 0x45, 0xA0, 0x00, 0x5A, 0xDB, 0x51, 0xED, 0xBF, 0x07,
+  0x04, 0x7E, 0x68, 0x1F, 0x87, 0xB5, 0xCA, 0x94, 0x19, 0x66, 0x86, 0xEE, 0x9E, 0x96, 0x7B, 0x37,
+  0xC8, 0x2D, 0x6A, 0x34, 0x3F, 0xA3, 0x79, 0x83, 0xFC, 0xA7, 0x07, 0xD1, 0xF5, 0x8E, 0x20, 0x5C,
+  0x14, 0xDF, 0xEA, 0x25, 0x32, 0x50, 0xD3, 0x09, 0x45, 0x50, 0x11, 0xB7, 0x23, 0xE5, 0x5C, 0xA8,
+  0x6E, 0xD9, 0xBF, 0x6E, 0xEE, 0x2A, 0x07, 0xA1, 0xB2, 0xBB, 0xEA, 0x97, 0x3E, 0xE6, 0x73, 0x61,
+  0x47, 0x49, 0xCF, 0x04, 0xB5, 0x12, 0x4E, 0x31, 0x14, 0x7E, 0x65, 0x5C, 0x18, 0x60, 0x4E, 0x68,
+  0xDF, 0x99, 0x69, 0x39, 0x0D, 0x2A, 0x9E, 0xFD, 0x99, 0xAC, 0x13, 0xED, 0x39, 0x63, 0x5A, 0x39,
+  0x50, 0xBE, 0x15, 0xF3, 0x2B, 0x98, 0x78, 0x48, 0xA5, 0xE8, 0x54, 0x26, 0x1C, 0x0C, 0x76, 0x7D,
+  0xD0, 0x50, 0xF6, 0xDC, 0x19, 0x3D, 0x29, 0x4E, 0x1E, 0x70, 0x15, 0x9E, 0x18, 0xF7, 0x9D, 0xB5,
+  0x21, 0x0F, 0x4F, 0x4F, 0x4F, 0xE9, 0x66, 0xDF, 0x35, 0x6B, 0xE9, 0x20, 0xE4, 0x99, 0x58, 0xAA,
+  0x6C, 0x66, 0xC1, 0x88, 0x36, 0x10, 0xE9, 0xF1, 0x16, 0xF5, 0x25, 0x9A, 0x53, 0x45, 0x05, 0xC0,
+  0xCA, 0xC7, 0xFA, 0x75, 0x93, 0xC7, 0x6B, 0x80, 0x27, 0x96, 0x47, 0xC1, 0x5D, 0x7F, 0x2F, 0xCF,
+  0x17, 0xF9, 0x7D, 0x4A, 0xE1, 0x53, 0xE2, 0x1E, 0x83, 0x8D, 0x9D, 0x12, 0x84, 0x7B, 0xB2, 0xE5,
+  0xF7, 0xF0, 0xAC, 0x27, 0x83, 0xF7, 0xE3, 0x09, 0xE1, 0x1F, 0xE3, 0x69, 0x35, 0xBF, 0xB2, 0xF4,
+  0x51, 0x3A, 0x39, 0x9D, 0x14, 0xD3, 0x86, 0x83, 0xC9, 0x0C, 0xE5, 0x62, 0xB2, 0x04, 0x57, 0x97,
+  0xEC, 0x0B, 0x1D, 0xA1, 0xA4, 0x50, 0x90, 0x35, 0x52, 0xB3, 0xE7, 0x05, 0x43, 0x2B, 0x24, 0x64,
+  0x52, 0x58, 0x87, 0xE6, 0xD4, 0x11, 0x17, 0xBE, 0x63, 0x51, 0x7F, 0x5C, 0x82, 0x1C, 0x9C, 0x5C,
+  0xB6, 0xB0, 0x25, 0x12, 0x5A, 0x17, 0xA4, 0xFC, 0xDB, 0x38, 0x75, 0xAD, 0x0E, 0x20, 0x0F, 0xFE,
+  0xBB, 0x8F, 0x4D, 0xAE, 0xE0, 0x43, 0xD3, 0xD2, 0x2F, 0xF5, 0x8A, 0x67, 0x55, 0x55, 0x75, 0xC2,
+  0x4C, 0x94, 0x56, 0x50, 0x5F, 0x46, 0xDB, 0xB6, 0x6D, 0xFD, 0x86, 0x4C, 0x60, 0x1E, 0x27, 0x6D,
+  0xC5, 0x3F, 0x20, 0x38, 0xC7, 0x30, 0xF8, 0xFC, 0xC9, 0x58, 0x5F, 0x30, 0x6A, 0xB1, 0xC8, 0xFA,
+  0x31, 0xEA, 0x04, 0x92, 0xF4, 0xFA, 0x05, 0x0C, 0x9A, 0x57, 0x4A, 0x1F, 0x0E, 0xB4, 0x64, 0x3E,
+  0x43, 0xD2, 0x06, 0x24, 0x9A, 0x97, 0x0B, 0x8E, 0xD1, 0xEF, 0xFB, 0xA2, 0xF0, 0x07, 0x42, 0x8D,
+  0x93, 0xFB, 0xE5, 0xCE, 0x23, 0xFC, 0x0C, 0x62, 0xFD, 0xDE, 0x36, 0x93, 0x73, 0xFA, 0xC6, 0x38,
+  0x7F, 0x84, 0xE1, 0x9E, 0x6A, 0xBE, 0xF3, 0x7B, 0x9C, 0x97, 0x01, 0xDD, 0x3B, 0xB8, 0x6B, 0x4A,
+  0xBB, 0x45, 0x8F, 0x48, 0x1F, 0x7B, 0x81, 0xAC, 0x96, 0x82, 0xA3, 0x87, 0xDD, 0x6E, 0x17, 0x20,
+  0x77, 0xC6, 0x6F, 0xE6, 0x0B, 0xA1, 0xC5, 0x87, 0xD1, 0x83, 0x47, 0x43, 0x47, 0x12, 0x96, 0xFA,
+  0x9D, 0xBD, 0x92, 0xBB, 0xBC, 0x3B, 0x7C, 0xDA, 0xE2, 0xE9, 0x6A, 0x1F, 0x54, 0xF7, 0xED, 0x9C,
+  0x07, 0x8F, 0xE6, 0x18, 0x3C, 0xEC, 0xC3, 0xCD, 0x89, 0x40, 0x30, 0xC9, 0x45, 0x77, 0xC6, 0x58,
+  0x9A, 0x31, 0x07, 0xA6, 0x0D, 0x5D, 0x9C, 0x1E, 0x27, 0x73, 0xE3, 0x92, 0x3F, 0xEE, 0x02, 0x97,
+  0x20, 0x66, 0x2B, 0xF5, 0x91, 0xF4, 0x82, 0x73, 0x50, 0xA9, 0xEE, 0x1A, 0x05, 0x29, 0xC5, 0x68,
+  0x85, 0xAD, 0xD1, 0xB1, 0xF7, 0x2F, 0x46, 0x66, 0x47, 0xCA, 0xC0, 0xF7, 0x5A, 0x80, 0x5F, 0xF0,
+  0x88, 0xA1, 0xDB, 0xA2, 0x5C, 0x69, 0xD7, 0x4F, 0x43, 0x73, 0x23, 0x9B, 0xCC, 0x96, 0x00, 0x16,
+  0x8B, 0xC1, 0xD1, 0xD5, 0xE9, 0xEB, 0xFF, 0x05, 0x8C, 0xDF, 0xCA, 0xBA, 0x5F, 0x08, 0xFF, 0x07,
+  0x27, 0xD7, 0xFF, 0x0B, 0x04, 0x05, 0x00, 0x00,
+};
+
+static const uint8_t PORTAL_HTML_GZ[] PROGMEM = {
+  0x1F, 0x8B, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xA5, 0x57, 0xDB, 0x6E, 0xE3, 0x36,
+  0x10, 0x7D, 0xCF, 0x57, 0x70, 0x15, 0x74, 0x6D, 0x63, 0x63, 0xC9, 0x76, 0xEB, 0x76, 0x57, 0xB6,
+  0x5C, 0xA0, 0x89, 0x83, 0x06, 0xE8, 0x25, 0x68, 0x5C, 0x14, 0x7D, 0xA4, 0x45, 0xDA, 0xE2, 0x86,
+  0x22, 0x55, 0x92, 0xCA, 0xA5, 0x41, 0xFE, 0xBD, 0x43, 0x52, 0x72, 0x64, 0x59, 0x4E, 0xB3, 0xAD,
+  0x5F, 0x74, 0x21, 0xE7, 0xCC, 0x99, 0x99, 0x33, 0x43, 0x79, 0xFE, 0xEE, 0xE2, 0xD7, 0xF3, 0xD5,
+  0x9F, 0xD7, 0x4B, 0x94, 0x99, 0x9C, 0x2F, 0x4E, 0xE6, 0xF5, 0x85, 0x62, 0xB2, 0x38, 0x41, 0xF0,
+  0x9B, 0x1B, 0x66, 0x38, 0x5D, 0xFC, 0xC1, 0x2E, 0x19, 0xBA, 0xA1, 0xA6, 0x2C, 0xE6, 0x91, 0x7F,
+  0xE3, 0x57, 0x73, 0x6A, 0x30, 0x12, 0x38, 0xA7, 0x49, 0x70, 0xC7, 0xE8, 0x7D, 0x21, 0x95, 0x09,
+  0x50, 0x2A, 0x85, 0xA1, 0xC2, 0x24, 0xC1, 0x3D, 0x23, 0x26, 0x4B, 0xBE, 0x9E, 0x8C, 0xCE, 0x98,
+  0x60, 0x86, 0x61, 0x3E, 0xD4, 0x29, 0xE6, 0x34, 0x19, 0x07, 0x95, 0xB9, 0x36, 0x8F, 0x35, 0x94,
+  0xFD, 0xAD, 0x25, 0x79, 0x44, 0x4F, 0x6B, 0x9C, 0xDE, 0x6E, 0x95, 0x2C, 0x05, 0x89, 0x4F, 0xC7,
+  0xE3, 0xF1, 0x2C, 0x95, 0x5C, 0xAA, 0xF8, 0x74, 0xB9, 0x5C, 0xCE, 0x36, 0x80, 0x3C, 0xDC, 0xE0,
+  0x9C, 0xF1, 0xC7, 0x58, 0x63, 0xA1, 0x87, 0x9A, 0x2A, 0xB6, 0x99, 0x3D, 0xEF, 0x10, 0x42, 0xEB,
+  0x1B, 0x33, 0x41, 0x15, 0x7A, 0xCA, 0xF1, 0xC3, 0xD0, 0x31, 0x88, 0x81, 0x41, 0xF1, 0x30, 0xCB,
+  0xB1, 0xDA, 0x32, 0x11, 0x4F, 0xBE, 0x29, 0x1E, 0x10, 0x2E, 0x8D, 0x9C, 0x35, 0x1D, 0x4D, 0x26,
+  0x93, 0x59, 0x81, 0x09, 0x61, 0x62, 0x1B, 0x4F, 0x68, 0x3E, 0x5B, 0x4B, 0x45, 0xA8, 0x1A, 0x2A,
+  0x4C, 0x58, 0xA9, 0xE3, 0x8F, 0x60, 0xBE, 0x96, 0x0F, 0x43, 0x9D, 0x61, 0x22, 0xEF, 0xE3, 0x11,
+  0x1A, 0xA1, 0xF1, 0xB7, 0x00, 0x73, 0x3A, 0x1A, 0x8D, 0x3E, 0x36, 0xDC, 0x33, 0x51, 0x94, 0xE6,
+  0x4C, 0x53, 0x4E, 0x53, 0x73, 0xB6, 0x2E, 0x8D, 0x91, 0x02, 0x3D, 0x79, 0x0E, 0xE3, 0xD1, 0xE8,
+  0x2B, 0x8F, 0xC1, 0xFE, 0xB6, 0x4E, 0x2A, 0x07, 0xF0, 0xA6, 0x26, 0x16, 0x7E, 0x47, 0x73, 0x34,
+  0xDA, 0xB1, 0x08, 0xA7, 0x40, 0xC3, 0x05, 0x0C, 0x16, 0x34, 0x1E, 0x87, 0xE3, 0x03, 0x5A, 0x53,
+  0x47, 0xCB, 0xBE, 0x89, 0xC7, 0xC0, 0x46, 0x4B, 0xCE, 0x08, 0x3A, 0x9D, 0x4E, 0xA7, 0xCD, 0x8C,
+  0xAC, 0x8D, 0x18, 0x16, 0x8A, 0x81, 0x93, 0x56, 0x6E, 0x27, 0x9F, 0x3E, 0xE1, 0x49, 0x5A, 0xA5,
+  0xF7, 0x3E, 0x63, 0x86, 0xB6, 0xCD, 0x08, 0x16, 0x5B, 0x9B, 0xC9, 0xA6, 0x15, 0x86, 0x44, 0x1D,
+  0x31, 0xD1, 0x06, 0x9B, 0x52, 0xDB, 0xC4, 0xDB, 0x78, 0x86, 0x46, 0x16, 0xF1, 0x78, 0x2F, 0x86,
+  0xF0, 0x93, 0x8D, 0xE9, 0xC5, 0x82, 0xE3, 0x35, 0xE5, 0xE8, 0x89, 0x30, 0x5D, 0x70, 0xFC, 0x18,
+  0xAF, 0xB9, 0x4C, 0x6F, 0x67, 0x0D, 0x6B, 0x97, 0x82, 0xEA, 0x79, 0x2D, 0x21, 0x9B, 0x79, 0xEC,
+  0xB2, 0xE0, 0x11, 0xE6, 0x51, 0x25, 0x9F, 0x79, 0xE4, 0xF5, 0x3A, 0xB7, 0xFA, 0xA9, 0x94, 0x45,
+  0xD8, 0x1D, 0x4A, 0x39, 0xD6, 0x3A, 0x09, 0x76, 0x92, 0x08, 0x5E, 0x94, 0xE6, 0xD6, 0x9D, 0x79,
+  0xA5, 0x52, 0x5F, 0x1F, 0x43, 0x1F, 0xCC, 0x10, 0x73, 0xB6, 0x15, 0x71, 0x0A, 0x0A, 0xA6, 0xAA,
+  0xE5, 0x1D, 0x9C, 0x37, 0x40, 0x1C, 0x10, 0xCB, 0xB7, 0x48, 0xAB, 0x34, 0x09, 0x22, 0x45, 0xB5,
+  0x2C, 0x55, 0x4A, 0xA3, 0xD5, 0x45, 0xF8, 0xB9, 0xD8, 0x06, 0x08, 0x73, 0xE8, 0x81, 0xD5, 0x63,
+  0x41, 0xD1, 0x45, 0xD0, 0x72, 0x36, 0xB1, 0x8A, 0xCA, 0x28, 0xDB, 0x66, 0x26, 0x76, 0x5A, 0xEC,
+  0xCA, 0x01, 0xE8, 0xCC, 0xAD, 0x35, 0x79, 0x47, 0x40, 0xBC, 0xF1, 0xB8, 0x91, 0x2A, 0x47, 0x8C,
+  0x58, 0xDC, 0x0D, 0xBB, 0x84, 0x87, 0x00, 0x49, 0xA1, 0xCB, 0x75, 0xCE, 0xC0, 0x35, 0xBD, 0x83,
+  0x18, 0xC2, 0x42, 0xB9, 0xEB, 0x05, 0xDD, 0xE0, 0x92, 0x9B, 0xFE, 0x60, 0x86, 0x34, 0xBE, 0xA3,
+  0x70, 0x6D, 0x47, 0xE2, 0xAA, 0xE1, 0x3B, 0xFD, 0x17, 0x6A, 0xEE, 0xA5, 0xBA, 0x9D, 0x47, 0xFE,
+  0xDD, 0xFE, 0x3E, 0x2F, 0x6F, 0xE7, 0x55, 0x6B, 0x46, 0x2E, 0x94, 0x2C, 0xA0, 0x29, 0x84, 0xF5,
+  0x9C, 0x66, 0x56, 0x31, 0x49, 0x40, 0x64, 0x5A, 0xE6, 0xD6, 0xF9, 0x96, 0x9A, 0x25, 0xA7, 0xF6,
+  0xF6, 0x87, 0xC7, 0x2B, 0xD2, 0xEF, 0x59, 0x83, 0xDE, 0x20, 0xBC, 0xC3, 0xBC, 0xA4, 0x89, 0xC9,
+  0x98, 0xF6, 0xB7, 0xBB, 0xF4, 0x1C, 0xA4, 0xBB, 0xCD, 0xD2, 0x31, 0x90, 0x85, 0x61, 0xD0, 0x59,
+  0x1E, 0x25, 0x08, 0x16, 0xD7, 0x9C, 0x62, 0x4D, 0x51, 0x45, 0x0C, 0x06, 0x52, 0x4D, 0xDF, 0x6F,
+  0x6C, 0xF1, 0x8F, 0xFC, 0xBE, 0x76, 0x1D, 0x6D, 0xEB, 0x22, 0x03, 0xD5, 0x4A, 0x02, 0x2B, 0x83,
+  0x60, 0x17, 0x60, 0x80, 0xA0, 0x32, 0x29, 0xCD, 0x24, 0x87, 0x46, 0x4B, 0x82, 0x9B, 0x9B, 0x2B,
+  0x28, 0xA7, 0xA2, 0x7F, 0x95, 0x4C, 0x51, 0xF2, 0x66, 0xE2, 0x55, 0x7A, 0xAF, 0x41, 0x92, 0xC0,
+  0x8D, 0x74, 0xA7, 0xB6, 0x49, 0xA2, 0xA8, 0x76, 0x7A, 0x22, 0xF6, 0xA9, 0x45, 0xC4, 0x55, 0xAA,
+  0xC6, 0x6B, 0x7B, 0xAB, 0x86, 0x8F, 0x87, 0xF2, 0x0F, 0xAE, 0x40, 0x9C, 0xA5, 0xB7, 0x10, 0x96,
+  0x53, 0x40, 0x50, 0x77, 0x48, 0x63, 0x44, 0x04, 0x8B, 0x73, 0x29, 0x84, 0x4D, 0xE3, 0x7B, 0x74,
+  0x03, 0xBB, 0xE6, 0x91, 0x37, 0xFE, 0x22, 0x78, 0x50, 0x25, 0x14, 0xBE, 0xE5, 0xC0, 0x0F, 0x93,
+  0x60, 0x71, 0xE9, 0x16, 0x91, 0x65, 0x7F, 0x08, 0x3E, 0x8F, 0xAC, 0xA2, 0x5B, 0x7D, 0x5A, 0x81,
+  0xF8, 0xF1, 0x52, 0xD5, 0xC5, 0xDF, 0x2F, 0x6E, 0xDC, 0x35, 0x46, 0x61, 0x18, 0x36, 0x5A, 0xA3,
+  0x79, 0xAB, 0x53, 0xC5, 0x8A, 0x46, 0xB1, 0x37, 0xA5, 0x48, 0x9D, 0x7A, 0xE0, 0x28, 0x12, 0xFD,
+  0x01, 0x7A, 0xDA, 0x0B, 0x6C, 0x43, 0x4D, 0x9A, 0xF5, 0x7B, 0x91, 0x5D, 0x04, 0x9D, 0x9A, 0x8C,
+  0x8A, 0xBE, 0x42, 0xC9, 0xA2, 0xB5, 0xCD, 0xFE, 0xA2, 0x08, 0x4D, 0x46, 0x93, 0x18, 0xC1, 0x1E,
+  0x44, 0xE8, 0x1D, 0x4B, 0x29, 0x62, 0x1A, 0xE4, 0xC0, 0x38, 0x77, 0xD8, 0x02, 0x86, 0x38, 0x1C,
+  0x08, 0x6E, 0xFD, 0x65, 0x80, 0x1E, 0xC0, 0xB0, 0x0D, 0xEA, 0xAB, 0x7A, 0x74, 0x26, 0x89, 0xC5,
+  0x1C, 0x80, 0x92, 0xCD, 0x8A, 0xE5, 0x54, 0x96, 0xA6, 0x6F, 0xA1, 0xCE, 0xD0, 0x78, 0x3A, 0x1A,
+  0x0D, 0x66, 0x07, 0xC6, 0x0A, 0x4E, 0x64, 0x25, 0x90, 0x0A, 0x3F, 0x6B, 0x09, 0xC1, 0xEC, 0x6F,
+  0x78, 0xAE, 0xF8, 0x73, 0xA6, 0x4D, 0x77, 0x08, 0xD6, 0xF7, 0x3B, 0xBB, 0x1C, 0x72, 0x2A, 0xB6,
+  0x26, 0x1B, 0x54, 0x80, 0x87, 0x8E, 0x38, 0x54, 0x8C, 0x54, 0x8D, 0x8E, 0x12, 0xF4, 0x6A, 0x7F,
+  0xD7, 0x03, 0xA1, 0xD7, 0x41, 0xB8, 0xC6, 0x08, 0x19, 0x88, 0x4C, 0xFD, 0xB8, 0xFA, 0xF9, 0x27,
+  0x40, 0xEB, 0xF5, 0xBA, 0x1D, 0x42, 0xF7, 0x36, 0x7D, 0xA5, 0x8A, 0x62, 0x43, 0x2B, 0x77, 0xFD,
+  0x9E, 0xEF, 0xED, 0x2E, 0x27, 0xB0, 0xE2, 0xC7, 0xCA, 0x11, 0x6C, 0xBB, 0x6E, 0x5B, 0xDC, 0x2E,
+  0x1F, 0x19, 0x1D, 0xBD, 0x57, 0xA8, 0xE3, 0xA2, 0xA0, 0x82, 0x9C, 0x67, 0x8C, 0x93, 0x3E, 0x40,
+  0x75, 0x10, 0x70, 0x29, 0x05, 0x21, 0x2F, 0x31, 0x88, 0xC9, 0xA6, 0xA4, 0x3B, 0xFD, 0xBB, 0x38,
+  0xFF, 0x53, 0x94, 0x2E, 0x92, 0x5D, 0x9C, 0xD6, 0xCB, 0xB1, 0x3D, 0x55, 0xAC, 0xC7, 0xB7, 0x74,
+  0x87, 0xD6, 0xE1, 0xF3, 0xF9, 0x40, 0x62, 0x2F, 0xCF, 0xCF, 0x27, 0x1D, 0x3D, 0xE6, 0xE6, 0x4C,
+  0x2B, 0x74, 0x1B, 0xB2, 0xFE, 0x37, 0x11, 0xD5, 0x87, 0x44, 0x68, 0x60, 0x2E, 0xB5, 0x95, 0x6D,
+  0x11, 0x8A, 0xD7, 0x10, 0xEC, 0xB4, 0xAC, 0x11, 0xF6, 0x4D, 0x9D, 0xE4, 0xF5, 0xA0, 0xA3, 0x1A,
+  0xC7, 0xE9, 0xB8, 0xDE, 0x04, 0x38, 0xA7, 0xD9, 0x95, 0x4F, 0x66, 0xB0, 0x2F, 0x1C, 0xA9, 0x90,
+  0xFB, 0x5E, 0x78, 0x51, 0x50, 0x18, 0x1C, 0x6B, 0xD7, 0x56, 0x0A, 0x3B, 0xE7, 0x4F, 0xEA, 0x87,
+  0xF0, 0xF7, 0x36, 0x15, 0x49, 0x0F, 0x7D, 0x00, 0xF4, 0x54, 0x12, 0xFA, 0xFB, 0x6F, 0x57, 0xE7,
+  0x32, 0x2F, 0xA4, 0xB0, 0xDA, 0x80, 0x28, 0x3E, 0xA0, 0xDE, 0x7B, 0x1B, 0xEB, 0xB1, 0x2D, 0xC5,
+  0x60, 0x70, 0x40, 0xA2, 0x31, 0xD4, 0x94, 0x93, 0x46, 0x7F, 0x50, 0x0D, 0x0A, 0x73, 0x5C, 0xA6,
+  0x5F, 0x96, 0x1C, 0xF3, 0xBA, 0x72, 0xBA, 0x94, 0x52, 0x1F, 0x19, 0x47, 0xE6, 0xB1, 0x5F, 0xDE,
+  0x9B, 0xC8, 0x6F, 0x23, 0xFF, 0xBF, 0x89, 0xBF, 0x49, 0xA5, 0x47, 0x06, 0xCD, 0x9B, 0xF4, 0xD9,
+  0x61, 0x7B, 0x24, 0x59, 0xF7, 0x4C, 0x40, 0x97, 0x86, 0x52, 0x70, 0x89, 0x89, 0x6D, 0x68, 0x38,
+  0x1A, 0x66, 0xF5, 0xA7, 0x70, 0x75, 0xCC, 0xC1, 0x91, 0xEA, 0x3E, 0x82, 0xE1, 0x9B, 0xD8, 0xFD,
+  0x95, 0xFB, 0x07, 0xDC, 0x62, 0xCF, 0xA2, 0xE2, 0x0D, 0x00, 0x00,
+};
+
+static const uint8_t UPLOAD_JS_GZ[] PROGMEM = {
+  0x1F, 0x8B, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x9D, 0x56, 0xDB, 0x6E, 0xDB, 0x38,
+  0x10, 0x7D, 0xEF, 0x57, 0x4C, 0x1F, 0x36, 0xA2, 0xD6, 0x8E, 0xEC, 0x24, 0x48, 0xD7, 0x88, 0xEB,
+  0x14, 0x6D, 0x9A, 0x45, 0x17, 0xD8, 0x4B, 0xD1, 0x38, 0x4F, 0x41, 0x0A, 0xD0, 0x12, 0x15, 0x73,
+  0x2D, 0x93, 0x0A, 0x49, 0x25, 0xF1, 0xB6, 0xF9, 0xF7, 0x9D, 0x21, 0x65, 0x4B, 0x96, 0xDD, 0xBD,
+  0x54, 0x80, 0x21, 0x8A, 0x9E, 0x39, 0x3C, 0x9C, 0x39, 0x33, 0xE4, 0x60, 0x00, 0x9F, 0x84, 0xAD,
+  0x96, 0x7C, 0x56, 0x08, 0xA8, 0xCA, 0x42, 0xF3, 0xCC, 0x42, 0xAE, 0x0D, 0xFD, 0x96, 0x16, 0x1E,
+  0xA5, 0x9B, 0x43, 0xC6, 0x1D, 0x3F, 0x5C, 0x48, 0x95, 0x9D, 0x81, 0x9B, 0x0B, 0xC8, 0x25, 0x9A,
+  0xDE, 0x69, 0x61, 0xD1, 0x1E, 0xA4, 0x82, 0x74, 0x5E, 0xA9, 0x85, 0xED, 0x83, 0xE0, 0xE9, 0xFC,
+  0xC5, 0x60, 0x10, 0x7C, 0xA4, 0xB3, 0x70, 0xF1, 0xE9, 0xE2, 0xE4, 0xB8, 0x0F, 0x5C, 0x65, 0xC0,
+  0x21, 0x33, 0xBA, 0x2C, 0x45, 0x06, 0x85, 0x54, 0x0B, 0x30, 0xB4, 0x24, 0x02, 0xE4, 0x46, 0x2F,
+  0x3D, 0xA6, 0xCE, 0x73, 0x2B, 0x9C, 0x1F, 0x66, 0xE2, 0x41, 0xA6, 0x02, 0x4D, 0x4A, 0x6D, 0x9C,
+  0x4D, 0x08, 0x71, 0x8A, 0xD3, 0x8F, 0x73, 0x5D, 0x88, 0x43, 0xBF, 0xB6, 0xC7, 0x05, 0xC5, 0x09,
+  0x81, 0x3C, 0x02, 0xED, 0x3E, 0x58, 0x0D, 0x5A, 0x15, 0x2B, 0x3F, 0x67, 0xF1, 0x5F, 0x48, 0xB5,
+  0x72, 0x42, 0xB9, 0xF5, 0x72, 0xC9, 0x0B, 0x96, 0x57, 0x2A, 0x75, 0x52, 0x2B, 0x60, 0x31, 0x7C,
+  0x79, 0x01, 0xF8, 0xA0, 0x8D, 0x75, 0x30, 0x85, 0x09, 0x28, 0xF1, 0x08, 0xD7, 0x52, 0xB9, 0x93,
+  0xE3, 0xB7, 0xC6, 0xF0, 0x15, 0x3B, 0x3E, 0x7D, 0x15, 0x8F, 0xBD, 0x0D, 0xC5, 0x83, 0x15, 0xC8,
+  0x4F, 0xA1, 0xD9, 0x70, 0x8C, 0xAF, 0xD7, 0x80, 0xFF, 0xE2, 0xA0, 0xD7, 0x5B, 0xE3, 0xD0, 0x43,
+  0x26, 0x29, 0x21, 0x8D, 0x37, 0x53, 0x1B, 0xD7, 0x45, 0x70, 0x5D, 0xA0, 0xEB, 0x08, 0x5F, 0xE4,
+  0x48, 0xA6, 0x29, 0x1C, 0xC0, 0x11, 0xBC, 0x81, 0xE1, 0xD3, 0xE5, 0xFB, 0x77, 0xA3, 0xD1, 0xC9,
+  0xF1, 0x10, 0x3E, 0x03, 0x4B, 0xE1, 0xFC, 0xFC, 0x1C, 0x8E, 0x62, 0x38, 0x83, 0x7A, 0xD8, 0x20,
+  0x4E, 0x6F, 0xD4, 0xAD, 0x77, 0xA4, 0xF9, 0x61, 0x98, 0x7F, 0x0E, 0x34, 0xD7, 0x9B, 0x4B, 0x4D,
+  0x7A, 0x5D, 0x62, 0xD6, 0x04, 0x4B, 0xFB, 0x30, 0x6B, 0x33, 0xDC, 0xD0, 0x91, 0x81, 0x8E, 0x44,
+  0x3A, 0xB3, 0xA4, 0x10, 0xEA, 0xCE, 0xCD, 0xF1, 0x6B, 0xCD, 0x6A, 0x7A, 0x83, 0x14, 0x3E, 0xC3,
+  0xEC, 0x46, 0xDE, 0xC6, 0x48, 0xF0, 0xF8, 0xF4, 0xF4, 0xB6, 0xA1, 0x35, 0x8A, 0x1B, 0x32, 0x46,
+  0xB8, 0xCA, 0xE0, 0x82, 0x6D, 0x1A, 0x21, 0xA2, 0xC8, 0xE1, 0x83, 0x78, 0xF2, 0x44, 0x27, 0xE7,
+  0xC0, 0x3C, 0xDE, 0xF0, 0xE9, 0xE7, 0xFA, 0x89, 0x03, 0xFB, 0x38, 0x71, 0xFA, 0xCA, 0x19, 0xA9,
+  0xEE, 0xD8, 0xD1, 0xAB, 0x38, 0x29, 0x79, 0x76, 0xE5, 0xB8, 0x71, 0x6C, 0xD4, 0x87, 0x68, 0x18,
+  0xD5, 0xEB, 0x6C, 0xF0, 0x30, 0xE9, 0x13, 0x98, 0x11, 0x5C, 0x00, 0x67, 0xCD, 0x3E, 0x1B, 0x64,
+  0xDA, 0x70, 0xED, 0xC8, 0xED, 0x4A, 0xA5, 0x4D, 0x54, 0x48, 0x3B, 0x17, 0x84, 0xC2, 0x68, 0x84,
+  0x72, 0x71, 0xED, 0xC8, 0x84, 0x55, 0xAC, 0x13, 0x25, 0x2E, 0x72, 0x04, 0xAF, 0x31, 0xC3, 0xC3,
+  0xF1, 0x4E, 0x66, 0x9B, 0x75, 0xF6, 0xA4, 0x18, 0x45, 0x1C, 0xA2, 0x4A, 0x83, 0xD7, 0x7E, 0xBD,
+  0xC4, 0xCA, 0xBF, 0x44, 0x98, 0xE8, 0x4D, 0x3C, 0x7A, 0x7B, 0x4D, 0x7A, 0xAC, 0x4B, 0x9C, 0x78,
+  0x72, 0x17, 0xB5, 0x54, 0x27, 0xC1, 0x8D, 0xC4, 0x0D, 0x3D, 0x88, 0x30, 0xFF, 0x73, 0x91, 0x62,
+  0xED, 0xDD, 0x41, 0x84, 0xDF, 0xBF, 0x71, 0x37, 0x4F, 0xF2, 0x42, 0x6B, 0xC3, 0x8E, 0x86, 0x43,
+  0xF8, 0xD1, 0x03, 0x0F, 0x9A, 0x95, 0x62, 0xF2, 0xF9, 0x21, 0x1A, 0x6F, 0xAD, 0xE0, 0x65, 0xD6,
+  0x56, 0xC4, 0x5A, 0xE8, 0xA3, 0xA0, 0x73, 0xFE, 0xC8, 0xA5, 0xAB, 0x31, 0x0A, 0x2C, 0x3D, 0x86,
+  0xA0, 0xFD, 0x40, 0x39, 0x30, 0x4E, 0x38, 0xD9, 0xBD, 0xAB, 0xF2, 0x5C, 0x18, 0x16, 0xC7, 0xAD,
+  0xF4, 0x3F, 0xEF, 0x08, 0xA1, 0x4E, 0x4C, 0xBC, 0x2B, 0x08, 0x5B, 0x08, 0x1F, 0x5B, 0xEC, 0x2A,
+  0x98, 0x41, 0xE2, 0xF0, 0x11, 0xAB, 0x5F, 0x5A, 0xC1, 0x0C, 0x4D, 0x60, 0xF9, 0x4F, 0xE5, 0x52,
+  0xE8, 0xCA, 0x31, 0xD3, 0x47, 0xA3, 0x6F, 0x24, 0x31, 0xE5, 0x45, 0xC1, 0x2A, 0x53, 0x20, 0xC1,
+  0x72, 0x4F, 0xFE, 0x10, 0x0A, 0xEA, 0xFD, 0x08, 0x97, 0xCE, 0x1B, 0xCB, 0x71, 0xC7, 0xD0, 0x6D,
+  0x0C, 0x4D, 0xF2, 0xA7, 0xD5, 0x8A, 0xC5, 0x49, 0xCA, 0xC9, 0x03, 0x1B, 0x03, 0xE9, 0xF5, 0xCB,
+  0x73, 0x7B, 0x9F, 0x2E, 0xB1, 0x8E, 0xBB, 0x0A, 0x99, 0xA3, 0x79, 0x18, 0xEE, 0xD4, 0x80, 0x5B,
+  0x6F, 0x79, 0x1F, 0x6D, 0x2B, 0x54, 0xC6, 0xA8, 0x85, 0xF6, 0xE1, 0xDB, 0xE2, 0xBB, 0x47, 0xF8,
+  0x88, 0x8C, 0x26, 0x94, 0x6B, 0x1A, 0x50, 0x3A, 0x0F, 0x48, 0x0B, 0x7E, 0x46, 0xA8, 0x54, 0x67,
+  0xE2, 0xFA, 0xD3, 0x2F, 0x17, 0x7A, 0x59, 0x6A, 0x85, 0x72, 0x61, 0x1B, 0xB1, 0xF8, 0xCC, 0x1F,
+  0x90, 0x06, 0xBC, 0xE9, 0x46, 0x11, 0xD0, 0xDB, 0xD2, 0x42, 0x78, 0xA2, 0x03, 0xCC, 0x93, 0xB7,
+  0x6B, 0x72, 0xDF, 0xA9, 0x8C, 0x6D, 0xE9, 0xDB, 0x4D, 0xB4, 0x7C, 0xFC, 0xA3, 0x41, 0x68, 0xB9,
+  0x03, 0x4B, 0xD5, 0xFA, 0x86, 0x80, 0xEE, 0xFB, 0xF0, 0x05, 0x96, 0xC2, 0xCD, 0x35, 0x9E, 0x12,
+  0xD1, 0xC7, 0x3F, 0xAE, 0xA6, 0x11, 0x3C, 0xB7, 0x50, 0x64, 0x0E, 0xEC, 0xA5, 0x4D, 0x64, 0x16,
+  0x63, 0x7B, 0x36, 0xFA, 0xD1, 0x0B, 0xE0, 0xD2, 0x18, 0x54, 0xB2, 0x4D, 0x04, 0xBD, 0xE1, 0xEB,
+  0x57, 0x88, 0x3C, 0x20, 0xE4, 0x1C, 0x69, 0x64, 0x51, 0x87, 0x44, 0x28, 0x2F, 0x9B, 0x84, 0xB3,
+  0xA2, 0xEF, 0xAD, 0xAC, 0x2F, 0xB8, 0x4E, 0x1C, 0xFD, 0x81, 0xE4, 0x4D, 0xC3, 0x08, 0x81, 0x4F,
+  0x8E, 0x7F, 0x7A, 0x35, 0x6A, 0xEC, 0x1E, 0xE7, 0x74, 0x8E, 0xB0, 0x4E, 0x9D, 0xFE, 0xDF, 0xD2,
+  0xFC, 0xFE, 0x8A, 0xF4, 0x34, 0x67, 0x55, 0xDE, 0x3A, 0x75, 0xFE, 0x43, 0x31, 0xFA, 0xDD, 0x74,
+  0xAB, 0x71, 0x1B, 0xD9, 0x99, 0x55, 0x67, 0x13, 0xFB, 0x6A, 0x63, 0x3B, 0x89, 0x1E, 0xF6, 0x8D,
+  0x0C, 0xAA, 0xA3, 0x14, 0x79, 0x29, 0x85, 0x28, 0xFB, 0xB9, 0xB0, 0x7A, 0x23, 0x1A, 0xDF, 0x8A,
+  0x19, 0xD2, 0x8F, 0xFB, 0x7B, 0x16, 0xA3, 0x67, 0x5B, 0x08, 0x7D, 0x98, 0x0B, 0x9E, 0x09, 0x63,
+  0xCF, 0x50, 0x23, 0x51, 0x1D, 0xCE, 0xC3, 0xE9, 0xAA, 0x14, 0x14, 0x44, 0x5E, 0x96, 0xB8, 0x51,
+  0x4E, 0x65, 0x32, 0xD0, 0xA9, 0x13, 0xEE, 0xD0, 0x3A, 0x23, 0xF8, 0x12, 0xF5, 0x83, 0xBD, 0x5C,
+  0x67, 0xAB, 0x33, 0x1F, 0xA9, 0xE7, 0xCE, 0x4E, 0xD7, 0xA2, 0x32, 0xB5, 0x1E, 0x60, 0x32, 0x99,
+  0x40, 0xA5, 0x32, 0x91, 0x4B, 0x25, 0xF6, 0xA8, 0xCC, 0x34, 0x2A, 0x63, 0xD1, 0x87, 0xE9, 0xF4,
+  0xA3, 0x4F, 0xDF, 0xBA, 0x9A, 0xE3, 0x3D, 0xE8, 0x41, 0x6F, 0x6B, 0xFC, 0xDD, 0xFF, 0xF7, 0xE8,
+  0xCF, 0x37, 0x00, 0xF0, 0x8D, 0x04, 0xD8, 0x8E, 0x9E, 0xD6, 0x94, 0x7B, 0xBD, 0xE0, 0x4A, 0x47,
+  0x69, 0xCD, 0x53, 0xEC, 0xC2, 0x87, 0x54, 0xF9, 0xAE, 0xC9, 0x4E, 0xBD, 0xB4, 0xBC, 0xD7, 0x1E,
+  0xA2, 0x78, 0x43, 0x7A, 0x6B, 0x17, 0x28, 0x6A, 0x61, 0x44, 0xFB, 0x0A, 0x25, 0x2D, 0x1E, 0xE9,
+  0x2E, 0xDC, 0x89, 0xC4, 0x83, 0x30, 0xB0, 0x40, 0x2C, 0x0B, 0x38, 0x92, 0xB9, 0xC4, 0xAB, 0x58,
+  0xB8, 0xB8, 0x7D, 0x43, 0x2D, 0xFC, 0x8E, 0x4B, 0xF5, 0x9D, 0x65, 0xFF, 0x4F, 0xAD, 0xB4, 0x1D,
+  0x08, 0xBF, 0xC6, 0x3A, 0x7F, 0x2F, 0xB7, 0xF3, 0x17, 0xA2, 0xDF, 0xB6, 0xE8, 0x84, 0xB9, 0x73,
+  0x08, 0xD5, 0x7D, 0x37, 0xD3, 0x29, 0x5E, 0xF5, 0x94, 0x4B, 0xEE, 0x2B, 0x61, 0x56, 0x57, 0xA2,
+  0x10, 0xA9, 0xD3, 0xE6, 0x2D, 0xB1, 0xA7, 0x1B, 0xED, 0xCD, 0xE6, 0x2E, 0x7B, 0x1B, 0xC5, 0x09,
+  0xCE, 0x5C, 0xE2, 0xA5, 0x95, 0xE5, 0xC4, 0x33, 0x4F, 0x78, 0x96, 0x5D, 0x3E, 0xA0, 0xEF, 0xAF,
+  0x12, 0x8F, 0x3D, 0x85, 0xD5, 0x15, 0xD9, 0x6A, 0xB6, 0x94, 0x0E, 0x05, 0x1C, 0xDA, 0xB9, 0x20,
+  0xBB, 0x26, 0xA7, 0x22, 0x29, 0x8D, 0x20, 0x87, 0xF7, 0x22, 0xE7, 0x55, 0xE1, 0x58, 0xB7, 0x6B,
+  0xFA, 0x9E, 0xB1, 0xCD, 0x84, 0x45, 0x49, 0x55, 0x92, 0xE6, 0xA2, 0x9D, 0xE6, 0x48, 0x27, 0x42,
+  0xF0, 0xD9, 0x6C, 0x22, 0xC5, 0x42, 0x70, 0xE2, 0xB2, 0x10, 0xF4, 0xC5, 0xA2, 0x4C, 0x3E, 0xA0,
+  0x1B, 0xF5, 0xA5, 0xB4, 0xE0, 0xD6, 0xFE, 0x4E, 0x9D, 0x08, 0x8F, 0x8C, 0x1A, 0x70, 0x4C, 0x5B,
+  0xC0, 0x3B, 0xB6, 0xCA, 0x2E, 0xB0, 0xBD, 0x65, 0x8C, 0xBA, 0x78, 0x2B, 0x4C, 0xBB, 0xAD, 0xC1,
+  0x5F, 0x5C, 0x42, 0xB6, 0xFD, 0xBD, 0x5A, 0xE7, 0xBB, 0x6C, 0xA5, 0x2A, 0x2B, 0x77, 0xE3, 0xB0,
+  0x56, 0x27, 0x64, 0xE3, 0xA3, 0x86, 0x6F, 0x1B, 0xAF, 0xF5, 0x49, 0x07, 0x5B, 0x9E, 0x50, 0x58,
+  0x31, 0x45, 0x49, 0xE7, 0x88, 0xDB, 0x4E, 0x59, 0xA1, 0x43, 0x99, 0x27, 0x46, 0x90, 0x8C, 0xDA,
+  0xE1, 0x6A, 0x8A, 0xC6, 0x98, 0x7F, 0x6D, 0xC3, 0xD1, 0xB5, 0x97, 0x61, 0x7D, 0x4C, 0x84, 0x3E,
+  0x8C, 0x7E, 0x09, 0x5E, 0xF1, 0x2D, 0xBF, 0x13, 0xDD, 0xEB, 0x89, 0x97, 0xDF, 0x73, 0x4C, 0xCB,
+  0xFD, 0x0D, 0xA4, 0xA7, 0xB5, 0x49, 0xEE, 0x0C, 0x00, 0x00,
+};
+
+namespace WebAssets {
+    const WebAsset DIAG_CSS = { "text/css", DIAG_CSS_GZ, 501, 1103, 0x41306C84 };
+    const WebAsset FILEMAN_CSS = { "text/css", FILEMAN_CSS_GZ, 584, 1284, 0x0BFFD727 };
+    const WebAsset PORTAL_HTML = { "text/html", PORTAL_HTML_GZ, 1259, 3554, 0xA2CF62DC };
+    const WebAsset UPLOAD_JS = { "application/javascript", UPLOAD_JS_GZ, 1338, 3310, 0x49B5A7A4 };
+}
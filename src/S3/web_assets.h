@@ -0,0 +1,21 @@
+// web_assets.h
+//
+// GENERATED by script/web_gz.py from script/web/ -- do not edit.
+
+#pragma once
+#include <Arduino.h>
+
+struct WebAsset {
+    const char    *type;
+    const uint8_t *gz;       // gzip member, 10-byte header (no name, mtime 0)
+    uint32_t       gzLen;
+    uint32_t       rawLen;
+    uint32_t       etag;     // CRC32 of the uncompressed bytes
+};
+
+namespace WebAssets {
+    extern const WebAsset DIAG_CSS;
+    extern const WebAsset FILEMAN_CSS;
+    extern const WebAsset PORTAL_HTML;
+    extern const WebAsset UPLOAD_JS;
+}
@@ -0,0 +1,45 @@
+// webcache.h
+//
+// HTTP caching for the web UI (AsyncTCP task only).
+//
+// - FFat files: ETag (CRC32 of the content, remembered per file; size/mtime
+//   for big files and "weak" callers), If-None-Match -> 304, single-range
+//   "Range:" requests (206, If-Range aware), and <path>.gz served with
+//   Content-Encoding: gzip when the client accepts it.
+// - URLs built with url()/assetUrl() carry "?v=<etag>"; those responses are
+//   cacheable for a year ("immutable"), everything else must revalidate.
+// - Built-in page shells (web_assets.h) go out pre-gzipped from flash.
+// - Generated pages get an ETag of their HTML, so a reload that renders the
+//   same page costs a 304 instead of the full body.
+
+#pragma once
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include "web_assets.h"
+
+namespace WebCache {
+
+  // FFat file with ETag/304/gzip handling (404 if missing). weak = size/mtime
+  // tag without reading the file (many small generated files, e.g. thumbnails).
+  void sendFile(AsyncWebServerRequest *request, const String &path, const String &contentType, bool weak = false);
+
+  // GET <prefix>/* straight from FFat (replaces serveStatic)
+  void serveDir(AsyncWebServer &server, const char *prefix, bool weak = false);
+
+  // "<path>?v=<etag>" for links in generated pages (path unchanged if missing)
+  String url(const String &path, bool weak = false);
+
+  // Forget a file's ETag after it was written or deleted
+  void invalidate(const String &path);
+
+  // Built-in gzipped asset; assetUrl() gives the versioned link for a route
+  void sendAsset(AsyncWebServerRequest *request, const WebAsset &asset);
+  void serveAsset(AsyncWebServer &server, const char *route, const WebAsset &asset);
+  String assetUrl(const char *route, const WebAsset &asset);
+
+  // Generated HTML with a content ETag
+  void sendPage(AsyncWebServerRequest *request, const String &html, const char *contentType = "text/html");
+
+  // Content type from the file extension
+  const char *contentTypeFor(const String &path);
+}
@@ -3,10 +3,20 @@
 #include <Arduino.h>
 
 namespace WiFiMgr {
+    struct ConnectInfo {
+        uint32_t bootMs;        // ms after boot of the first IP (0 = not yet)
+        uint32_t lastMs;        // duration of the last (re)connect
+        uint32_t reconnects;    // links re-established after a drop
+        uint8_t  attempts;      // attempts used by the last connect
+        bool     fastPath;      // last connect used the cached BSSID/channel
+    };
+
     void begin();
     void loop();
     void restartPortal();
     void forgetWiFi();
     bool isConnected();
+    bool isPortalActive();
     String getStatus();
+    ConnectInfo getConnectInfo();
 }
@@ -0,0 +1,36 @@
+// bootprof.h
+//
+// Boot profiler: setup() marks each phase as it finishes, and loop() prints
+// the table once the network is up (or BOOT_PROF_REPORT_MS has passed). The
+// two numbers that matter are "first image" and "network" (first IP).
+
+#pragma once
+#include <Arduino.h>
+
+#ifndef BOOT_PROF_MAX
+#define BOOT_PROF_MAX 16
+#endif
+#ifndef BOOT_PROF_REPORT_MS
+#define BOOT_PROF_REPORT_MS 60000
+#endif
+
+namespace BootProf {
+
+  // Record that a phase finished now; phase must be a string literal
+  void mark(const char *phase);
+
+  // Same, with an explicit millis() timestamp
+  void markAt(const char *phase, uint32_t ms);
+
+  // millis() at which the phase was marked, 0 if it never was
+  uint32_t at(const char *phase);
+
+  // "serial 212, display 401, ..." for /diag
+  String summary();
+
+  // Print the phase table with durations
+  void dump(Print &out);
+
+  // Main loop: picks up network-ready from WiFiMgr and reports once
+  void loop();
+}
@@ -2,12 +2,56 @@
 #include "disp_cfg.h"
 #include <Arduino.h>
 #include "imagedisplay.h"
+#include "disp_queue.h"
 #include "wifimgr.h"
 #include "ui_bright.h"
 #include <Preferences.h>
+#include <stdarg.h>
+#include <atomic>
 
+#define CMD_BATCH_MAX_BODY   2048   // bytes accepted by POST /cmd/batch
+#define CMD_BATCH_MAX_CMDS   32     // commands per batch / binary frame
+#define CMD_SERIAL_LINE_MAX  128    // text line buffer
+#define CMD_REBOOT_DELAY_MS  300    // let replies leave before ESP.restart()
+#define CMD_BRIGHTNESS_PERSIST_MS 1500  // save brightness once it has been stable this long
+
+// Binary serial framing (see Command Reference.md)
+#define CMD_FRAME_MAGIC      0xA5   // host -> device
+#define CMD_REPLY_MAGIC      0x5A   // device -> host
+#define CMD_FRAME_BYTE_TIMEOUT_MS  100    // gap inside a frame that abandons it
+#define CMD_BINARY_QUIET_MS        2000   // no [cmd] text this long after a frame
 
 static LGFX* s_tft = nullptr;
+static unsigned long s_rebootAt = 0;
+static unsigned long s_quietUntil = 0;   // binary session: keep [cmd] text off Serial
+
+// BRIGHTNESS_SET applies at once but reaches NVS only after the value has
+// settled, so a ramp of 50 steps is one flash write, not 50. Written from
+// the AsyncTCP task and the loop, persisted from the loop.
+static std::atomic<int> s_brightnessPending(-1);
+static std::atomic<uint32_t> s_brightnessAt(0);
+
+static void persist_brightness() {
+    const int val = s_brightnessPending.exchange(-1);
+    if (val < 0) return;
+    Preferences prefs;
+    prefs.begin("type_d", false); // read-write mode
+    prefs.putUInt("brightness", val);
+    prefs.end();
+}
+
+// Debug text shares Serial with binary replies, so it is held back while a
+// binary session is active (any frame in the last CMD_BINARY_QUIET_MS).
+static void cmd_log(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+static void cmd_log(const char *fmt, ...) {
+    if (s_quietUntil && (long)(millis() - s_quietUntil) < 0) return;
+    char line[160];
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(line, sizeof(line), fmt, ap);
+    va_end(ap);
+    Serial.print(line);
+}
 
 enum {
     CMD_NEXT_IMAGE      = 0x01,
@@ -28,119 +72,345 @@ enum {
     CMD_DISPLAY_OFF     = 0x61,
 };
 
-static void execute_cmd(uint8_t code, AsyncWebServerRequest* request = nullptr, Stream* serial = nullptr);
+// Per-command result, reported by /cmd, /cmd/batch and binary replies
+enum CmdResult : uint8_t {
+    CMD_OK       = 0,
+    CMD_BUSY     = 1,   // display queue full, retry
+    CMD_UNKNOWN  = 2,   // unknown opcode
+    CMD_BAD_ARG  = 3,   // missing/invalid parameter
+    CMD_SKIPPED  = 4    // not run: an earlier command in the batch was busy
+};
+
+static const char* result_str(CmdResult r) {
+    switch (r) {
+        case CMD_OK:      return "ok";
+        case CMD_BUSY:    return "busy";
+        case CMD_UNKNOWN: return "unknown";
+        case CMD_SKIPPED: return "skipped";
+        default:          return "bad_arg";
+    }
+}
+
+// One parsed command, independent of transport (HTTP, batch, serial text/binary)
+struct CmdArgs {
+    uint8_t code;
+    int val;            // -1 when absent
+    char file[96];
+    char mode[12];
+};
+
+static void args_reset(CmdArgs &a, uint8_t code = 0) {
+    a.code = code;
+    a.val = -1;
+    a.file[0] = '\0';
+    a.mode[0] = '\0';
+}
+
+static CmdResult execute_cmd(const CmdArgs &a);
+
+// Parse a 1- or 2-byte hex opcode ("01" or "0001")
+static uint8_t parse_code(const char *s, size_t len) {
+    if (len == 4) {
+        // Parse big-endian 2-byte hex, keep the low byte
+        char low_byte_str[3] = { s[2], s[3], 0 };
+        return (uint8_t)strtol(low_byte_str, nullptr, 16);
+    }
+    // Fallback to single byte parse for backward compatibility
+    return (uint8_t)strtol(s, nullptr, 16);
+}
+
+// Parse "c=XX&val=N&file=PATH&mode=M" (any order). Modifies nothing outside 'out'.
+static bool parse_cmd_line(const char *line, size_t len, CmdArgs &out) {
+    args_reset(out);
+    bool haveCode = false;
+    size_t i = 0;
+    while (i < len) {
+        size_t end = i;
+        while (end < len && line[end] != '&') end++;
+        const char *eq = (const char *)memchr(line + i, '=', end - i);
+        if (eq) {
+            const size_t klen = eq - (line + i);
+            const char *v = eq + 1;
+            const size_t vlen = (line + end) - v;
+            if (klen == 1 && line[i] == 'c') {
+                char code[5] = {0};
+                memcpy(code, v, vlen < 4 ? vlen : 4);
+                out.code = parse_code(code, strlen(code));
+                haveCode = vlen > 0;
+            } else if (klen == 3 && !strncmp(line + i, "val", 3)) {
+                out.val = atoi(v);
+            } else if (klen == 4 && !strncmp(line + i, "file", 4)) {
+                const size_t n = vlen < sizeof(out.file) - 1 ? vlen : sizeof(out.file) - 1;
+                memcpy(out.file, v, n);
+                out.file[n] = '\0';
+            } else if (klen == 4 && !strncmp(line + i, "mode", 4)) {
+                const size_t n = vlen < sizeof(out.mode) - 1 ? vlen : sizeof(out.mode) - 1;
+                memcpy(out.mode, v, n);
+                out.mode[n] = '\0';
+            }
+        }
+        i = end + 1;
+    }
+    return haveCode;
+}
 
 void handle_cmd(AsyncWebServerRequest *request) {
     if (!request->hasParam("c")) {
         request->send(400, "application/json", "{\"err\":\"Missing command param\"}");
         return;
     }
+    CmdArgs a;
     String cstr = request->getParam("c")->value();
-    // Parse 4-digit hex string into uint16_t command code
-    uint16_t code = 0;
-    if (cstr.length() == 4) {
-        // Parse big-endian 2-byte hex
-        char high_byte_str[3] = { cstr.charAt(0), cstr.charAt(1), 0 };
-        char low_byte_str[3] = { cstr.charAt(2), cstr.charAt(3), 0 };
-       uint8_t high_byte = (uint8_t)strtol(high_byte_str, nullptr, 16);
-        uint8_t low_byte = (uint8_t)strtol(low_byte_str, nullptr, 16);
-        code = ((uint16_t)high_byte << 8) | low_byte;
+    args_reset(a, parse_code(cstr.c_str(), cstr.length()));
+    if (request->hasParam("val")) a.val = request->getParam("val")->value().toInt();
+    if (request->hasParam("file")) strlcpy(a.file, request->getParam("file")->value().c_str(), sizeof(a.file));
+    if (request->hasParam("mode")) strlcpy(a.mode, request->getParam("mode")->value().c_str(), sizeof(a.mode));
+
+    CmdResult r = execute_cmd(a);
+    if (r == CMD_OK) {
+        request->send(200, "application/json", "{\"ok\":1}");
     } else {
-        // Fallback to single byte parse for backward compatibility
-        code = (uint16_t)strtol(cstr.c_str(), nullptr, 16);
+        char body[48];
+        snprintf(body, sizeof(body), "{\"ok\":0,\"err\":\"%s\"}", result_str(r));
+        request->send(r == CMD_BUSY ? 503 : 400, "application/json", body);
     }
-    execute_cmd((uint8_t)code, request, nullptr);
+}
+
+// POST /cmd/batch: body holds one command per line (or ';'-separated), same
+// syntax as serial. Reply: {"n":N,"results":[{"c":"01","ok":1},...]}
+static void handle_cmd_batch(AsyncWebServerRequest *request) {
+    const char *body = (const char *)request->_tempObject;
+    if (!body) {
+        request->send(400, "application/json", "{\"err\":\"Empty or oversized body\"}");
+        return;
+    }
+
+    AsyncResponseStream *response = request->beginResponseStream("application/json");
+    response->print("{\"results\":[");
+    int n = 0;
+    bool busy = false;      // once the queue is full, run nothing after it (keeps order)
+    const char *p = body;
+    while (*p && n < CMD_BATCH_MAX_CMDS) {
+        size_t len = strcspn(p, "\r\n;");
+        if (len) {
+            CmdArgs a;
+            if (n) response->print(',');
+            if (parse_cmd_line(p, len, a)) {
+                CmdResult r = busy ? CMD_SKIPPED : execute_cmd(a);
+                if (r == CMD_BUSY) busy = true;
+                response->printf("{\"c\":\"%02X\",\"ok\":%d", a.code, r == CMD_OK ? 1 : 0);
+                if (r != CMD_OK) response->printf(",\"err\":\"%s\"", result_str(r));
+                response->print('}');
+            } else {
+                response->print("{\"ok\":0,\"err\":\"parse\"}");
+            }
+            n++;
+        }
+        p += len;
+        if (*p) p++;
+    }
+    response->printf("],\"n\":%d}", n);
+    request->send(response);
+}
+
+static void handle_cmd_batch_body(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+    if (total > CMD_BATCH_MAX_BODY) return;    // leaves _tempObject null -> 400
+    if (index == 0) {
+        request->_tempObject = malloc(total + 1);
+        if (!request->_tempObject) return;
+    }
+    char *buf = (char *)request->_tempObject;
+    if (!buf) return;
+    memcpy(buf + index, data, len);
+    if (index + len == total) buf[total] = '\0';
 }
 
 void cmd_init(AsyncWebServer *server, LGFX *tft) {
     s_tft = tft;
     server->on("/cmd", HTTP_GET, handle_cmd);
-    Serial.println("[cmd] /cmd HTTP endpoint registered");
+    server->on("/cmd/batch", HTTP_POST, handle_cmd_batch, nullptr, handle_cmd_batch_body);
+    Serial.println("[cmd] /cmd and /cmd/batch HTTP endpoints registered");
+}
+
+// ---- Serial: text lines and binary frames share one byte-at-a-time parser ----
+//
+// Binary frame: A5 | seq | len | payload[len] | xor(payload)
+//   payload = records: code | argLen | arg[argLen]
+//   arg: code 05 -> file path, otherwise 1..4 bytes little-endian val
+// Reply:        5A | seq | count | result[count] | xor(results)
+
+enum SerialState : uint8_t { SER_TEXT, SER_SEQ, SER_LEN, SER_PAYLOAD, SER_CHECK };
+
+static char serial_line[CMD_SERIAL_LINE_MAX + 1];
+static size_t serial_line_len = 0;
+static SerialState ser_state = SER_TEXT;
+static uint8_t frame_seq = 0;
+static uint8_t frame_len = 0;
+static uint8_t frame_pos = 0;
+static uint8_t frame_xor = 0;
+static uint8_t frame_buf[255];
+static unsigned long s_lastByteAt = 0;
+
+static void run_serial_line() {
+    serial_line[serial_line_len] = '\0';
+    CmdArgs a;
+    if (parse_cmd_line(serial_line, serial_line_len, a)) {
+        CmdResult r = execute_cmd(a);
+        if (r != CMD_OK) cmd_log("[cmd] 0x%02X failed: %s\n", a.code, result_str(r));
+    } else {
+        cmd_log("[cmd] Invalid serial command: %s\n", serial_line);
+    }
+}
+
+static void run_serial_frame() {
+    uint8_t results[CMD_BATCH_MAX_CMDS];
+    uint8_t count = 0;
+    uint8_t pos = 0;
+    bool busy = false;
+    while (pos + 2 <= frame_len && count < CMD_BATCH_MAX_CMDS) {
+        CmdArgs a;
+        args_reset(a, frame_buf[pos]);
+        const uint8_t argLen = frame_buf[pos + 1];
+        pos += 2;
+        if (pos + argLen > frame_len) { results[count++] = CMD_BAD_ARG; break; }
+        if (a.code == CMD_DISPLAY_IMAGE) {
+            const size_t n = argLen < sizeof(a.file) - 1 ? argLen : sizeof(a.file) - 1;
+            memcpy(a.file, frame_buf + pos, n);
+            a.file[n] = '\0';
+        } else if (argLen >= 1 && argLen <= 4) {
+            int32_t v = 0;
+            for (int i = argLen - 1; i >= 0; --i) v = (v << 8) | frame_buf[pos + i];
+            a.val = v;
+        }
+        pos += argLen;
+        results[count] = busy ? CMD_SKIPPED : execute_cmd(a);
+        if (results[count++] == CMD_BUSY) busy = true;
+    }
+
+    uint8_t x = 0;
+    for (uint8_t i = 0; i < count; ++i) x ^= results[i];
+    const uint8_t hdr[3] = { CMD_REPLY_MAGIC, frame_seq, count };
+    Serial.write(hdr, sizeof(hdr));
+    Serial.write(results, count);
+    Serial.write(&x, 1);
+}
+
+void cmd_loop() {
+    if (s_brightnessPending.load() >= 0 &&
+        millis() - s_brightnessAt.load() >= CMD_BRIGHTNESS_PERSIST_MS) {
+        persist_brightness();
+    }
+
+    // Deferred reboot so HTTP/serial replies for the batch get out first
+    if (s_rebootAt && (long)(millis() - s_rebootAt) >= 0) {
+        persist_brightness();
+        ESP.restart();
+    }
 }
 
-static String serial_line;
 void cmd_serial_poll() {
     while (Serial.available()) {
-        char ch = Serial.read();
-        if (ch == '\n' || ch == '\r') {
-            if (serial_line.length() > 0) {
-                int code = -1;
-                int val = -1;
-                char param_key[16] = {0};
-                char param_val_str[32] = {0};
-                String param_file = "";
-                String param_mode = "";
-                if (sscanf(serial_line.c_str(), "c=%x&val=%d", &code, &val) == 2) {
-                    execute_cmd((uint8_t)code, nullptr, &Serial);
-                } else if (sscanf(serial_line.c_str(), "c=%x&file=%31s", &code, param_val_str) == 2) {
-                    param_file = String(param_val_str);
-                    execute_cmd((uint8_t)code, nullptr, &Serial);
-                } else if (sscanf(serial_line.c_str(), "c=%x&mode=%31s", &code, param_val_str) == 2) {
-                    param_mode = String(param_val_str);
-                    execute_cmd((uint8_t)code, nullptr, &Serial);
-                } else if (sscanf(serial_line.c_str(), "c=%x", &code) == 1) {
-                    execute_cmd((uint8_t)code, nullptr, &Serial);
+        const uint8_t ch = (uint8_t)Serial.read();
+        const unsigned long now = millis();
+        // A stalled frame (lost bytes, host restarted) is abandoned, and the
+        // parser goes back to scanning for the next magic byte
+        if (ser_state != SER_TEXT && now - s_lastByteAt >= CMD_FRAME_BYTE_TIMEOUT_MS) {
+            cmd_log("[cmd] Frame timed out (seq %u)\n", frame_seq);
+            ser_state = SER_TEXT;
+        }
+        s_lastByteAt = now;
+
+        switch (ser_state) {
+            case SER_TEXT:
+                if (ch == CMD_FRAME_MAGIC && serial_line_len == 0) {
+                    // Frames start only between lines: 0xA5 inside a line is
+                    // text (UTF-8 file names, e.g. "\xC3\xA5")
+                    s_quietUntil = now + CMD_BINARY_QUIET_MS;
+                    ser_state = SER_SEQ;
+                } else if (ch == '\n' || ch == '\r') {
+                    if (serial_line_len > 0) run_serial_line();
+                    serial_line_len = 0;
+                } else if (serial_line_len < CMD_SERIAL_LINE_MAX) {
+                    serial_line[serial_line_len++] = (char)ch;
                 } else {
-                    Serial.printf("[cmd] Invalid serial command: %s\n", serial_line.c_str());
+                    serial_line_len = 0;    // overlong line: drop it
                 }
-            }
-            serial_line = "";
-        } else {
-            serial_line += ch;
-            if (serial_line.length() > 128) serial_line = "";
+                break;
+            case SER_SEQ:
+                frame_seq = ch;
+                ser_state = SER_LEN;
+                break;
+            case SER_LEN:
+                frame_len = ch;
+                frame_pos = 0;
+                frame_xor = 0;
+                ser_state = frame_len ? SER_PAYLOAD : SER_CHECK;
+                break;
+            case SER_PAYLOAD:
+                frame_buf[frame_pos++] = ch;
+                frame_xor ^= ch;
+                if (frame_pos == frame_len) ser_state = SER_CHECK;
+                break;
+            case SER_CHECK:
+                if (ch == frame_xor) run_serial_frame();
+                else cmd_log("[cmd] Bad frame checksum (seq %u)\n", frame_seq);
+                ser_state = SER_TEXT;
+                break;
         }
     }
 }
 
-static void execute_cmd(uint8_t code, AsyncWebServerRequest* request, Stream* serial) {
-    int val = -1;
-    String param_file, param_mode;
-    if (request) {
-        if (request->hasParam("val")) val = request->getParam("val")->value().toInt();
-        if (request->hasParam("file")) param_file = request->getParam("file")->value();
-        if (request->hasParam("mode")) param_mode = request->getParam("mode")->value();
-    }
+static CmdResult execute_cmd(const CmdArgs &a) {
+    const uint8_t code = a.code;
+    const int val = a.val;
 
-    Serial.printf("[cmd] Executing code 0x%02X", code);
-    if (val != -1) Serial.printf(" val=%d", val);
-    if (param_file.length()) Serial.printf(" file=%s", param_file.c_str());
-    if (param_mode.length()) Serial.printf(" mode=%s", param_mode.c_str());
-    Serial.println();
+    char valStr[16] = "";
+    if (val != -1) snprintf(valStr, sizeof(valStr), " val=%d", val);
+    cmd_log("[cmd] Executing code 0x%02X%s%s%s%s%s\n", code, valStr,
+            a.file[0] ? " file=" : "", a.file, a.mode[0] ? " mode=" : "", a.mode);
 
+    // Display-affecting commands are queued for the render loop; the
+    // reply goes out immediately without waiting for decode/draw.
+    bool queued = true;
     switch (code) {
         case CMD_NEXT_IMAGE:
-            ImageDisplay::nextImage();
+            queued = DispQueue::post(DispQueue::OP_NEXT);
             break;
         case CMD_PREV_IMAGE:
-            ImageDisplay::prevImage();
+            queued = DispQueue::post(DispQueue::OP_PREV);
             break;
         case CMD_RANDOM_IMAGE:
-            ImageDisplay::displayRandomImage();
+            queued = DispQueue::post(DispQueue::OP_RANDOM);
             break;
-        case CMD_DISPLAY_MODE:
-            if (param_mode == "jpg" || val == 0) ImageDisplay::setMode(ImageDisplay::MODE_JPG);
-            else if (param_mode == "gif" || val == 1) ImageDisplay::setMode(ImageDisplay::MODE_GIF);
-            else ImageDisplay::setMode(ImageDisplay::MODE_RANDOM);
+        case CMD_DISPLAY_MODE: {
+            if (!strcmp(a.mode, "playlist") || val == 3) {
+                queued = DispQueue::post(DispQueue::OP_PLAYLIST_RELOAD);
+                break;
+            }
+            ImageDisplay::Mode m = ImageDisplay::MODE_RANDOM;
+            if (!strcmp(a.mode, "jpg") || val == 0) m = ImageDisplay::MODE_JPG;
+            else if (!strcmp(a.mode, "gif") || val == 1) m = ImageDisplay::MODE_GIF;
+            queued = DispQueue::post(DispQueue::OP_SET_MODE, m);
             break;
+        }
         case CMD_DISPLAY_IMAGE:
-            if (param_file.length()) ImageDisplay::displayImage(param_file);
+            if (!a.file[0]) return CMD_BAD_ARG;
+            queued = DispQueue::post(DispQueue::OP_SHOW_FILE, 0, a.file);
             break;
         case CMD_DISPLAY_CLEAR:
-            ImageDisplay::clear();
+            queued = DispQueue::post(DispQueue::OP_CLEAR);
             break;
         case CMD_BRIGHTNESS_SET:
-             if (val >= 5 && val <= 100) {
-                // Set brightness in hardware and preferences just like ui_bright
-                int hwval = (val * 255) / 100;
-                if (s_tft) s_tft->setBrightness(hwval);
-
-                // Also update the saved setting in preferences (persist)
-                Preferences prefs;
-                prefs.begin("type_d", false); // read-write mode
-                prefs.putUInt("brightness", val);
-                prefs.end();
-
-                Serial.printf("[cmd] Set brightness to %d%% (raw %d)\n", val, hwval);
+            if (val < 5 || val > 100) return CMD_BAD_ARG;
+            {
+                // Set brightness in hardware (render loop) now, persist once it settles
+                queued = DispQueue::post(DispQueue::OP_BRIGHTNESS, val);
+                if (queued) {
+                    s_brightnessAt.store(millis());
+                    s_brightnessPending.store(val);
+                }
+
+                cmd_log("[cmd] Set brightness to %d%%\n", val);
             }
             break;
         case CMD_WIFI_RESTART:
@@ -150,18 +420,18 @@ static void execute_cmd(uint8_t code, AsyncWebServerRequest* request, Stream* se
             WiFiMgr::forgetWiFi();
             break;
         case CMD_REBOOT:
-            ESP.restart();
+            s_rebootAt = millis() + CMD_REBOOT_DELAY_MS;
             break;
         case CMD_DISPLAY_ON:
-            if (s_tft) s_tft->powerSave(false);
+            queued = DispQueue::post(DispQueue::OP_POWER, 1);
             break;
         case CMD_DISPLAY_OFF:
-            if (s_tft) s_tft->powerSave(true);
+            queued = DispQueue::post(DispQueue::OP_POWER, 0);
             break;
         default:
-            Serial.printf("[cmd] Unknown code 0x%02X\n", code);
-            break;
+            cmd_log("[cmd] Unknown code 0x%02X\n", code);
+            return CMD_UNKNOWN;
     }
 
-    if (request) request->send(200, "application/json", "{\"ok\":1}");
+    return queued ? CMD_OK : CMD_BUSY;
 }
@@ -9,6 +9,10 @@ class LGFX;
 // Call this in setup after LGFX and server are initialized
 void cmd_init(AsyncWebServer *server, LGFX *tft);
 
+// Call at the top of loop(), ahead of any UI early return: runs a deferred
+// REBOOT and persists a settled brightness
+void cmd_loop();
+
 // Call in loop() to poll for serial commands
 void cmd_serial_poll();
 
@@ -1,27 +1,22 @@
 #include <WiFi.h>
 #include <WiFiUdp.h>
 #include "detect.h"
+#include "trace.h"
 
 // ==== CONFIGURABLES ====
 #define DETECT_DISCOVER_PORT 50501
 #define DETECT_BROADCAST_PORT 50502
-#define DETECT_ID_MIN 1
-#define DETECT_ID_MAX 4
-#define DETECT_DISCOVER_TIMEOUT 3000   // ms to listen for replies after discover
-#define DETECT_PROPOSAL_WINDOW 2000    // ms to send repeated ID claim broadcasts
-#define DETECT_PROPOSAL_BROADCAST_MS 200 // ms between claim broadcasts
-#define DETECT_BROADCAST_INTERVAL 3000 // ms between regular status broadcasts
-#define DETECT_DISCOVER_MSG "TYPE_D_DISCOVER?"
-#define DETECT_ID_MSG_PREFIX "TYPE_D_ID:"
+#define DETECT_MAX_PACKETS_PER_STEP 4  // bound the work done by one loop() call
 
 namespace Detect {
 
-uint8_t deviceId = 1;
-uint32_t lastBroadcast = 0;
+// The election itself lives in detect_elect.cpp; this file only connects it
+// to millis(), WiFiUDP and the Arduino loop.
 WiFiUDP udpDetect;
 WiFiUDP udpBroadcast;
 bool networkReady = false;
-uint8_t knownIds[DETECT_ID_MAX + 1] = {0};
+
+static Election election;
 
 // ---- Helper: Check if WiFi/Ethernet is up ----
 bool isNetworkReady() {
@@ -34,9 +29,41 @@ void debug(const char *msg) {
   Serial.println(msg);
 }
 
+// ---- Io seam: clock + the two broadcast sockets ----
+static uint32_t ioNow(void *) { return millis(); }
+
+static void ioSend(WiFiUDP &udp, uint16_t port, const char *msg) {
+  udp.beginPacket(IPAddress(255, 255, 255, 255), port);
+  udp.write((const uint8_t *)msg, strlen(msg));
+  udp.endPacket();
+}
+
+static void ioSendDetect(void *, const char *msg) { ioSend(udpDetect, DETECT_DISCOVER_PORT, msg); }
+static void ioSendStatus(void *, const char *msg) { ioSend(udpBroadcast, DETECT_BROADCAST_PORT, msg); }
+static void ioLog(void *, const char *line) { debug(line); }
+
+static const Io kIo = { nullptr, ioNow, ioSendDetect, ioSendStatus, ioLog };
+
+// Drain a bounded number of pending datagrams without waiting
+static void pollPackets() {
+  for (int i = 0; i < DETECT_MAX_PACKETS_PER_STEP; ++i) {
+    int packetSize = udpDetect.parsePacket();
+    if (!packetSize) return;
+    char buf[48] = {0};
+    udpDetect.read(buf, sizeof(buf) - 1);
+    if (udpDetect.remoteIP() == WiFi.localIP()) continue;
+    election.onPacket(buf);
+  }
+}
+
 // ---- 1. Initialize module ----
 void begin() {
-  deviceId = 1;
+  uint8_t mac[6];
+  WiFi.macAddress(mac);
+  // Seed from the MAC too, so units powered on together never share a sequence
+  uint32_t seed = (uint32_t)random(1, 0x7FFFFFFF);
+  for (int i = 0; i < 6; ++i) seed = (seed ^ mac[i]) * 16777619u;
+  election.begin(kIo, mac, seed);
   udpDetect.begin(DETECT_DISCOVER_PORT);
   udpBroadcast.begin(DETECT_BROADCAST_PORT);
   networkReady = isNetworkReady();
@@ -48,132 +75,25 @@ void begin() {
   }
 }
 
-// ---- 2. Robust ID assignment with "proposal storm" ----
+// ---- 2. (Re)start the election; returns immediately, loop() drives it ----
 void assignId() {
-  memset(knownIds, 0, sizeof(knownIds));
-  deviceId = 1; // fallback
-
-  delay(random(200, 800)); // jitter
-
-  // ---- Discovery phase ----
-  udpDetect.beginPacket("255.255.255.255", DETECT_DISCOVER_PORT);
-  udpDetect.write((const uint8_t *)DETECT_DISCOVER_MSG, strlen(DETECT_DISCOVER_MSG));
-  udpDetect.endPacket();
-  debug("Sent discover broadcast.");
-
-  uint32_t start = millis();
-  while (millis() - start < DETECT_DISCOVER_TIMEOUT) {
-    int packetSize = udpDetect.parsePacket();
-    if (packetSize) {
-      char buf[32] = {0};
-      udpDetect.read(buf, sizeof(buf) - 1);
-      IPAddress remoteIp = udpDetect.remoteIP();
-
-      if (strcmp(buf, DETECT_DISCOVER_MSG) == 0) {
-        char reply[32];
-        snprintf(reply, sizeof(reply), DETECT_ID_MSG_PREFIX "%d", deviceId);
-        udpDetect.beginPacket(remoteIp, DETECT_DISCOVER_PORT);
-        udpDetect.write((const uint8_t *)reply, strlen(reply));
-        udpDetect.endPacket();
-      }
-      if (strncmp(buf, DETECT_ID_MSG_PREFIX, strlen(DETECT_ID_MSG_PREFIX)) == 0) {
-        int id = atoi(buf + strlen(DETECT_ID_MSG_PREFIX));
-        if (id >= DETECT_ID_MIN && id <= DETECT_ID_MAX)
-          knownIds[id] = 1;
-      }
-    }
-    delay(5);
-  }
-
-  // Wait a random time, then pick an unused ID
-  delay(random(100, 400));
-  for (uint8_t tryId = DETECT_ID_MIN; tryId <= DETECT_ID_MAX; ++tryId) {
-    if (!knownIds[tryId]) {
-      deviceId = tryId;
-      break;
-    }
-  }
-  Serial.printf("[Detect] Proposing candidate ID: %d\n", deviceId);
-
-  // ---- Proposal/claim storm phase ----
-  char msg[32];
-  snprintf(msg, sizeof(msg), DETECT_ID_MSG_PREFIX "%d", deviceId);
-
-  bool seenConflict = false;
-  uint32_t proposalStart = millis();
-  while (millis() - proposalStart < DETECT_PROPOSAL_WINDOW) { // 2 second window
-    // Broadcast our claim every 200ms
-    udpDetect.beginPacket("255.255.255.255", DETECT_DISCOVER_PORT);
-    udpDetect.write((const uint8_t *)msg, strlen(msg));
-    udpDetect.endPacket();
-
-    // Listen for conflicting claims for 200ms
-    uint32_t listenUntil = millis() + DETECT_PROPOSAL_BROADCAST_MS;
-    while (millis() < listenUntil) {
-      int packetSize = udpDetect.parsePacket();
-      if (packetSize) {
-        char buf[32] = {0};
-        udpDetect.read(buf, sizeof(buf) - 1);
-        IPAddress remoteIp = udpDetect.remoteIP();
-        if (strncmp(buf, DETECT_ID_MSG_PREFIX, strlen(DETECT_ID_MSG_PREFIX)) == 0) {
-          int id = atoi(buf + strlen(DETECT_ID_MSG_PREFIX));
-          if (id == deviceId && remoteIp != WiFi.localIP()) {
-            // Collision detected!
-            seenConflict = true;
-            Serial.printf("[Detect] Proposal conflict! Saw my ID (%d) from %s. Will retry.\n", id, remoteIp.toString().c_str());
-            break;
-          }
-        }
-      }
-      delay(5);
-    }
-    if (seenConflict) break;
-  }
-
-  if (seenConflict) {
-    delay(random(300, 1200)); // backoff before retry
-    assignId();
-    return;
-  }
-
-  // If we reach here, no conflicts were seen
-  Serial.printf("[Detect] Final assigned ID: %d\n", deviceId);
-  debug("ID assignment complete.");
+  election.start();
 }
 
-// ---- 3. Periodic ID broadcast on port 50502 ----
+// ---- 3. Status ID broadcast on port 50502 (for viewer apps) ----
 void broadcastId() {
   if (!networkReady) return;
-  char msg[32];
-  snprintf(msg, sizeof(msg), DETECT_ID_MSG_PREFIX "%d", deviceId);
-  udpBroadcast.beginPacket("255.255.255.255", DETECT_BROADCAST_PORT);
-  udpBroadcast.write((const uint8_t *)msg, strlen(msg));
-  udpBroadcast.endPacket();
-  Serial.printf("[Detect] Status broadcast: %s\n", msg);
+  election.sendStatus();
 }
 
-// ---- 4. Conflict detection during runtime ----
+// ---- 4. Conflict detection: drain pending packets now ----
 void checkIdConflict() {
-  int packetSize = udpDetect.parsePacket();
-  if (packetSize) {
-    char buf[32] = {0};
-    udpDetect.read(buf, sizeof(buf) - 1);
-    IPAddress remoteIp = udpDetect.remoteIP();
-    Serial.printf("[Detect] (runtime conflict) Packet from %s: %s\n", remoteIp.toString().c_str(), buf);
-    if (strncmp(buf, DETECT_ID_MSG_PREFIX, strlen(DETECT_ID_MSG_PREFIX)) == 0) {
-      int id = atoi(buf + strlen(DETECT_ID_MSG_PREFIX));
-      if (id == deviceId && remoteIp != WiFi.localIP()) {
-        Serial.printf("[Detect] Runtime ID conflict! Saw my ID (%d) from %s. Will reassign.\n", id, remoteIp.toString().c_str());
-        delay(random(300, 1000));
-        assignId();
-        return;
-      }
-    }
-  }
+  pollPackets();
 }
 
 // ---- 5. Loop: call frequently in main loop ----
 void loop() {
+  TRACE_SCOPE("Detect::loop");
   // Update network status
   bool prev = networkReady;
   networkReady = isNetworkReady();
@@ -183,23 +103,21 @@ void loop() {
     assignId();
   }
   if (!networkReady) {
-    if (deviceId != 1) {
-      deviceId = 1;
+    if (prev) {
+      election.stop();
       debug("Lost network. Fallback to ID 1.");
     }
     return;
   }
 
-  // Periodically broadcast ID for status
-  if (millis() - lastBroadcast > DETECT_BROADCAST_INTERVAL) {
-    lastBroadcast = millis();
-    broadcastId();
-  }
-
-  // Conflict detection
-  checkIdConflict();
+  pollPackets();
+  election.step();
 }
 
-uint8_t getId() { return deviceId; }
+uint8_t getId() { return election.id(); }
+
+bool isAssigned() { return election.assigned(); }
+
+Stats getStats() { return election.stats(); }
 
 } // namespace Detect
@@ -2,6 +2,7 @@
 
 #pragma once
 #include <Arduino.h>
+#include "detect_elect.h"
 
 namespace Detect {
 
@@ -11,16 +12,23 @@ namespace Detect {
   // Call periodically in loop()
   void loop();
 
-  // Returns currently assigned device ID (1–4)
+  // Returns currently assigned device ID (1–64, 6 is reserved for the EXP board)
   uint8_t getId();
 
-  // Optionally triggers immediate ID re-assignment (e.g., external event)
+  // Restarts the ID election (e.g., external event). Non-blocking:
+  // the election runs as a timer-driven state machine stepped by loop().
   void assignId();
 
+  // True once the election has settled on an ID
+  bool isAssigned();
+
+  // Discovery/lease counters snapshot
+  Stats getStats();
+
   // (Advanced) Manually force status broadcast now
   void broadcastId();
 
-  // (Advanced) Manually check for ID conflict now
+  // (Advanced) Drain pending detect packets and check for ID conflict now
   void checkIdConflict();
 
 } // namespace Detect
@@ -0,0 +1,102 @@
+// detect_elect.h
+//
+// Detect ID election / lease state machine without Arduino or WiFi
+// dependencies. detect.cpp drives one instance from millis() and WiFiUDP;
+// the host tests (test/host) run many instances over a loopback medium.
+
+#pragma once
+#include <stdint.h>
+
+#define DETECT_ID_MIN 1
+#ifndef DETECT_ID_MAX
+#define DETECT_ID_MAX 64
+#endif
+#ifndef DETECT_ID_RESERVED
+#define DETECT_ID_RESERVED 6           // fixed ID of the Type D EXP board (udp_stat.cpp)
+#endif
+
+namespace Detect {
+
+  // Discovery counters (for diagnostics / telemetry)
+  struct Stats {
+    uint32_t txPackets;        // detect + status datagrams sent
+    uint32_t rxPackets;        // detect datagrams parsed
+    uint32_t conflicts;        // same-ID collisions resolved by MAC tie-break
+    uint8_t  livePeers;        // peers holding an unexpired lease
+    uint32_t beaconIntervalMs; // current (fleet-scaled) renewal interval
+  };
+
+  // Clock and socket seam. All callbacks get ctx back; log may be null.
+  struct Io {
+    void *ctx;
+    uint32_t (*now)(void *ctx);                      // milliseconds, wraps like millis()
+    void (*sendDetect)(void *ctx, const char *msg);  // broadcast on the detect port
+    void (*sendStatus)(void *ctx, const char *msg);  // broadcast on the status port
+    void (*log)(void *ctx, const char *line);
+  };
+
+  class Election {
+  public:
+    // mac breaks ID ties; seed feeds the jitter/pick PRNG (mix the MAC in)
+    void begin(const Io &io, const uint8_t mac[6], uint32_t seed);
+
+    void start();                     // (re)start the election, returns at once
+    void stop();                      // network gone: OFFLINE, ID 1
+    void onPacket(const char *buf);   // one datagram from the detect port
+    void step();                      // advance timers; at most one send
+    void sendStatus();                // "TYPE_D_ID:<id>" on the status port
+
+    uint8_t id() const { return deviceId; }
+    bool assigned() const { return state == State::ASSIGNED; }
+    Stats stats() const;
+
+  private:
+    enum class State {
+      OFFLINE,     // no network, ID forced to 1
+      JITTER,      // random wait before discovery (spreads simultaneous boots)
+      DISCOVER,    // discover sent, collecting lease beacons
+      PICK,        // short random wait, then pick one of the lowest free IDs
+      CLAIM,       // candidate announced; lower MAC on the same ID makes us yield
+      ASSIGNED     // steady state: lease renewal + tie-breaking
+    };
+
+    struct Lease {
+      uint8_t mac[6];
+      uint32_t seenAt;    // clock of last beacon
+      uint32_t leaseMs;   // validity announced by the holder
+      bool active;
+    };
+
+    uint32_t now() const { return io.now(io.ctx); }
+    uint32_t rand(uint32_t lo, uint32_t hi);
+    void logf(const char *fmt, ...);
+    void enterState(State s, uint32_t waitMs = 0);
+    bool stateExpired() const;
+    void send(const char *msg);
+    bool leaseLive(uint8_t id, uint32_t t) const;
+    uint8_t livePeers() const;
+    uint32_t beaconInterval() const;
+    uint32_t jittered(uint32_t iv);
+    void beaconSoon(uint32_t withinMs);
+    bool sendLease(uint8_t id);
+    bool peerWins(const uint8_t peerMac[6]) const;
+    void yieldTo(uint8_t id);
+    void handleClaim(uint8_t id, const uint8_t mac[6], uint32_t leaseMs);
+
+    Io io = {};
+    uint8_t selfMac[6] = {0};
+    uint32_t rng = 1;
+    Lease leases[DETECT_ID_MAX + 1] = {};
+    Stats counters = {};
+
+    State state = State::OFFLINE;
+    uint8_t deviceId = 1;
+    uint8_t candidateId = 1;
+    uint32_t stateStart = 0;     // clock when current state was entered
+    uint32_t stateWait = 0;      // duration of the current state
+    uint32_t lastClaim = 0;      // last claim beacon in CLAIM
+    uint32_t lastBeacon = 0;     // last lease beacon of any kind (rate limit)
+    uint32_t nextBeaconAt = 0;   // when the next lease renewal is due
+  };
+
+} // namespace Detect
@@ -4,7 +4,10 @@
 #include <esp_system.h>
 #include <esp_heap_caps.h>
 #include "disp_cfg.h"
-#include <Update.h>
+#include "ota.h"
+#include "webcache.h"
+#include "wifimgr.h"
+#include "bootprof.h"
 #include <ESPAsyncWebServer.h>
 
 extern "C" {
@@ -33,38 +36,21 @@ static void handleFormatFS(AsyncWebServerRequest *request) {
 }
 
 // --- OTA Firmware Update Handler ---
+// (the reboot happens from OTA::loop() once this reply has gone out)
 static void handleUpdate(AsyncWebServerRequest *request) {
-    bool hasError = Update.hasError();
-    String message = hasError ? "Update Failed!" : "Update Success! Rebooting...";
+    const bool ok = OTA::ok();
+    String message = ok ? "Update verified! Rebooting..." : String("Update Failed: ") + OTA::lastError();
     String html = "<!DOCTYPE html><html><head><title>OTA Result</title></head><body>";
     html += "<h2>" + message + "</h2>";
     html += "<a href='/diag'>Return to Diagnostics</a>";
     html += "</body></html>";
-    request->send(200, "text/html", html);
-    if (!hasError) {
-        delay(1200);
-        ESP.restart();
-    }
+    request->send(ok ? 200 : 400, "text/html", html);
 }
 
 static void handleUpdateUpload(AsyncWebServerRequest *request, String filename, size_t index, uint8_t *data, size_t len, bool final) {
-    if (!index) {
-        // Start update
-        Serial.printf("[OTA] Start firmware upload: %s\n", filename.c_str());
-        Update.begin(UPDATE_SIZE_UNKNOWN);
-    }
-    if (Update.write(data, len) != len) {
-        Serial.printf("[OTA] Write failed!\n");
-        Update.abort();
-    }
-    yeild();
-    if (final) {
-        if (Update.end(true)) {
-            Serial.println("[OTA] Update finished. Rebooting...");
-        } else {
-            Serial.printf("[OTA] Update error #%u\n", Update.getError());
-        }
-    }
+    if (!index) OTA::uploadBegin(filename.c_str());
+    if (len) OTA::uploadWrite(data, len);
+    if (final) OTA::uploadEnd();
 }
 
 // --- Main Diagnostics Page Handler ---
@@ -82,47 +68,7 @@ static void handleDiag(AsyncWebServerRequest *request) {
     <head>
     <title>Type D Diagnostics</title>
     <meta name="viewport" content="width=480">
-    <style>
-html, body {
-    height: 100%;
-    margin: 0;
-    padding: 0;
-}
-body {
-    min-height: 100vh;
-    display: flex;
-    flex-direction: column;
-    justify-content: center;
-    align-items: center;
-    background:#141414;
-    color:#EEE;
-    font-family:sans-serif;
-}
-h1, h2 {color:#4eec27;}
-.centered {
-    width: 100%;
-    display: flex;
-    flex-direction: column;
-    align-items: center;
-    justify-content: center;
-}
-.section {
-    background:#232323;
-    padding:16px 18px;
-    margin:22px auto;
-    border-radius:14px;
-    display:inline-block;
-}
-.checklist {margin:0 0 18px 0; text-align:left; display:inline-block;}
-.checkitem {margin:2px 0; padding:2px 0;}
-.pass {color:#49e24e; font-weight:bold;}
-.fail {color:#ed3c3c; font-weight:bold;}
-.qbtn {margin:6px 9px 6px 0; padding:10px 20px; background:#444; border:none; color:#fff; border-radius:8px; font-size:1.1em; cursor:pointer; display:inline-block;}
-.qbtn:hover {background:#299a2c;}
-.footer {margin:36px 0 12px 0; color:#888; font-size:.95em;}
-label {font-weight:600;}
-input[type=number] {width:60px; margin:0 4px 0 8px; padding:2px 4px;}
-</style>
+    <link rel="stylesheet" href=")" + WebCache::assetUrl("/ui/diag.css", WebAssets::DIAG_CSS) + R"(">
 
     </head>
     <body>
@@ -156,7 +102,17 @@ input[type=number] {width:60px; margin:0 4px 0 8px; padding:2px 4px;}
     String ip = WiFi.isConnected() ? WiFi.localIP().toString() : "(none)";
     html += "<b>WiFi SSID:</b> " + ssid + "<br>";
     html += "<b>IP Address:</b> " + ip + "<br>";
-    html += "</div></div>";
+    WiFiMgr::ConnectInfo wi = WiFiMgr::getConnectInfo();
+    html += "<b>WiFi Connect:</b> ";
+    html += wi.bootMs ? String(wi.bootMs) + " ms after boot" : String("(not yet)");
+    if (wi.lastMs)
+        html += " &mdash; last " + String(wi.lastMs) + " ms via " + (wi.fastPath ? "cached BSSID" : "scan")
+             + ", " + String(wi.attempts) + " attempt(s), " + String(wi.reconnects) + " reconnect(s)";
+    html += "<br>";
+    html += "<b>Boot (ms):</b> " + BootProf::summary() + "<br>";
+    html += "</div>";
+    html += "<br><a class='qbtn' href='/live'>Live Telemetry</a>";
+    html += "</div>";
 
     // --- RESOURCE CHECK ---
     html += "<div class='section'><h2>Resource Check</h2>";
@@ -238,7 +194,7 @@ input[type=number] {width:60px; margin:0 4px 0 8px; padding:2px 4px;}
 <hr style='margin:16px 0; border:0; border-top:1px solid #333;'>
 <h2>OTA Firmware Update</h2>
 <form method='POST' action='/update' enctype='multipart/form-data' style='margin:0;display:inline-block;'>
-  <input type='file' name='firmware' accept='.bin,.bin.gz' required style='margin-bottom:12px;'><br>
+  <input type='file' name='firmware' accept='.bin,.ota' required style='margin-bottom:12px;'><br>
   <button class='qbtn' type='submit' style='background:#1e90ff;'>Upload & Update</button>
 </form>
 )";
@@ -258,12 +214,13 @@ input[type=number] {width:60px; margin:0 4px 0 8px; padding:2px 4px;}
     )";
     html += "</div></body></html>";
 
-    request->send(200, "text/html", html);
+    WebCache::sendPage(request, html);
 }
 
 namespace Diag {
 void begin(AsyncWebServer &server) {
     server.on("/diag", HTTP_GET, handleDiag);
+    WebCache::serveAsset(server, "/ui/diag.css", WebAssets::DIAG_CSS);
     // OTA endpoints:
     server.on("/update", HTTP_POST, handleUpdate, handleUpdateUpload);
 }
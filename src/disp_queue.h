@@ -0,0 +1,39 @@
+// disp_queue.h
+//
+// Display command queue: web handlers (AsyncTCP task) and serial post here,
+// the render loop drains. Only the render loop ever touches LGFX/ImageDisplay.
+
+#pragma once
+#include <Arduino.h>
+
+class LGFX;
+
+namespace DispQueue {
+
+  enum Op : uint8_t {
+    OP_NEXT,          // ImageDisplay::nextImage()
+    OP_PREV,          // ImageDisplay::prevImage()
+    OP_RANDOM,        // ImageDisplay::displayRandomImage()
+    OP_RANDOM_JPG,    // ImageDisplay::displayRandomJpg()
+    OP_RANDOM_GIF,    // ImageDisplay::displayRandomGif()
+    OP_SHOW_FILE,     // ImageDisplay::displayImage(path)
+    OP_CLEAR,         // ImageDisplay::clear()
+    OP_SET_MODE,      // arg = ImageDisplay::Mode
+    OP_BRIGHTNESS,    // arg = percent (5..100)
+    OP_POWER,         // arg = 1 on, 0 off (power save)
+    OP_PLAYLIST_RELOAD // reload /playlist.bin (ImageDisplay::reloadPlaylist())
+  };
+
+  // Call in setup() before any producer can post
+  void begin(LGFX *tft);
+
+  // Any task/ISR-free context. Never blocks; returns false if the queue is full.
+  bool post(Op op, int32_t arg = 0, const char *path = nullptr);
+
+  // Render loop only: apply pending commands (bounded per call)
+  void drain();
+
+  // Commands rejected because the queue was full
+  uint32_t dropped();
+
+} // namespace DispQueue
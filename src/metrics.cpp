@@ -0,0 +1,173 @@
+// metrics.cpp
+
+#include "metrics.h"
+#include "wifimgr.h"
+#include "detect.h"
+#include "disp_cfg.h"
+#include <WiFi.h>
+#include <esp_heap_caps.h>
+
+#define METRICS_FPS_WINDOW_MS 2000
+
+namespace Metrics {
+
+std::atomic<uint32_t> g_counters[COUNTER_COUNT];
+
+struct HistDef {
+  const char *name;
+  const char *help;
+  uint32_t    boundsUs[METRICS_MAX_BOUNDS];
+  uint8_t     nBounds;
+};
+
+static const HistDef kHist[HIST_COUNT] = {
+  {"typed_loop_seconds", "Main loop iteration period",
+   {250, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000}, 9},
+  {"typed_jpg_decode_seconds", "Slideshow JPG read, decode and draw time",
+   {10000, 25000, 50000, 100000, 250000, 500000, 1000000}, 7},
+  {"typed_gif_frame_seconds", "GIF frame decode and draw time",
+   {2500, 5000, 10000, 20000, 40000, 80000, 160000}, 7},
+};
+
+struct HistData {
+  std::atomic<uint32_t> bucket[METRICS_MAX_BOUNDS + 1];   // not cumulative; last = +Inf
+  std::atomic<uint64_t> sumUs;
+};
+static HistData s_hist[HIST_COUNT];
+
+static uint32_t s_last_loop_us = 0;
+static uint32_t s_fps_at_ms = 0;
+static uint32_t s_fps_frames = 0;
+static std::atomic<uint32_t> s_fps_x100{0};
+
+void observe(Hist h, uint32_t us) {
+  const HistDef &d = kHist[h];
+  uint8_t b = 0;
+  while (b < d.nBounds && us > d.boundsUs[b]) ++b;
+  s_hist[h].bucket[b].fetch_add(1, std::memory_order_relaxed);
+  s_hist[h].sumUs.fetch_add(us, std::memory_order_relaxed);
+}
+
+void loop() {
+  const uint32_t nowUs = micros();
+  if (s_last_loop_us) observe(HIST_LOOP, nowUs - s_last_loop_us);
+  s_last_loop_us = nowUs;
+
+  const uint32_t now = millis();
+  if (now - s_fps_at_ms >= METRICS_FPS_WINDOW_MS) {
+    const uint32_t frames = g_counters[GIF_FRAMES].load(std::memory_order_relaxed);
+    s_fps_x100 = (uint32_t)((uint64_t)(frames - s_fps_frames) * 100000 / (now - s_fps_at_ms));
+    s_fps_frames = frames;
+    s_fps_at_ms = now;
+  }
+}
+
+// ---- Rendering ----
+
+static void header(String &out, const char *name, const char *type, const char *help) {
+  out += "# HELP "; out += name; out += ' '; out += help; out += '\n';
+  out += "# TYPE "; out += name; out += ' '; out += type; out += '\n';
+}
+
+static void sample(String &out, const char *name, const char *labels, uint64_t v) {
+  char line[160];
+  snprintf(line, sizeof(line), "%s%s%s%s %llu\n", name, labels ? "{" : "", labels ? labels : "",
+           labels ? "}" : "", (unsigned long long)v);
+  out += line;
+}
+
+static void gauge(String &out, const char *name, const char *help, uint64_t v) {
+  header(out, name, "gauge", help);
+  sample(out, name, nullptr, v);
+}
+
+static void counter(String &out, const char *name, const char *help, uint64_t v) {
+  header(out, name, "counter", help);
+  sample(out, name, nullptr, v);
+}
+
+static void histogram(String &out, Hist h) {
+  const HistDef &d = kHist[h];
+  header(out, d.name, "histogram", d.help);
+  char line[160];
+  uint64_t acc = 0;
+  for (uint8_t b = 0; b <= d.nBounds; ++b) {
+    acc += s_hist[h].bucket[b].load(std::memory_order_relaxed);
+    if (b < d.nBounds)
+      snprintf(line, sizeof(line), "%s_bucket{le=\"%lu.%06lu\"} %llu\n", d.name,
+               (unsigned long)(d.boundsUs[b] / 1000000), (unsigned long)(d.boundsUs[b] % 1000000),
+               (unsigned long long)acc);
+    else
+      snprintf(line, sizeof(line), "%s_bucket{le=\"+Inf\"} %llu\n", d.name, (unsigned long long)acc);
+    out += line;
+  }
+  const uint64_t sum = s_hist[h].sumUs.load(std::memory_order_relaxed);
+  snprintf(line, sizeof(line), "%s_sum %llu.%06lu\n%s_count %llu\n", d.name,
+           (unsigned long long)(sum / 1000000), (unsigned long)(sum % 1000000), d.name,
+           (unsigned long long)acc);
+  out += line;
+}
+
+static String render() {
+  String out;
+  out.reserve(4096);
+  auto c = [](Counter k) { return (uint64_t)g_counters[k].load(std::memory_order_relaxed); };
+
+  char labels[96];
+  header(out, "typed_info", "gauge", "Firmware and device identity");
+  snprintf(labels, sizeof(labels), "board=\"display\",version=\"%s\",id=\"%u\"", VERSION_TEXT, (unsigned)Detect::getId());
+  sample(out, "typed_info", labels, 1);
+  gauge(out, "typed_uptime_seconds", "Seconds since boot", millis() / 1000);
+
+  histogram(out, HIST_LOOP);
+  histogram(out, HIST_JPG_DECODE);
+  histogram(out, HIST_GIF_FRAME);
+  counter(out, "typed_gif_frames_total", "GIF frames drawn", c(GIF_FRAMES));
+  header(out, "typed_gif_fps", "gauge", "GIF frames per second over the last 2 s");
+  char fps[64];
+  const uint32_t f = s_fps_x100.load();
+  snprintf(fps, sizeof(fps), "typed_gif_fps %lu.%02lu\n", (unsigned long)(f / 100), (unsigned long)(f % 100));
+  out += fps;
+
+  const Detect::Stats ds = Detect::getStats();
+  header(out, "typed_udp_packets_total", "counter", "UDP datagrams by direction and source");
+  sample(out, "typed_udp_packets_total", "dir=\"in\",src=\"core\"", c(UDP_RX_CORE));
+  sample(out, "typed_udp_packets_total", "dir=\"in\",src=\"exp\"", c(UDP_RX_EXP));
+  sample(out, "typed_udp_packets_total", "dir=\"in\",src=\"detect\"", ds.rxPackets);
+  sample(out, "typed_udp_packets_total", "dir=\"out\",src=\"detect\"", ds.txPackets);
+  header(out, "typed_udp_dropped_total", "counter", "UDP datagrams discarded (bad size)");
+  sample(out, "typed_udp_dropped_total", "src=\"core\"", c(UDP_DROP_CORE));
+  sample(out, "typed_udp_dropped_total", "src=\"exp\"", c(UDP_DROP_EXP));
+
+  header(out, "typed_heap_free_bytes", "gauge", "Free heap by region");
+  sample(out, "typed_heap_free_bytes", "region=\"internal\"", heap_caps_get_free_size(MALLOC_CAP_INTERNAL));
+  sample(out, "typed_heap_free_bytes", "region=\"psram\"", heap_caps_get_free_size(MALLOC_CAP_SPIRAM));
+  header(out, "typed_heap_largest_block_bytes", "gauge", "Largest allocatable block by region");
+  sample(out, "typed_heap_largest_block_bytes", "region=\"internal\"", heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL));
+  sample(out, "typed_heap_largest_block_bytes", "region=\"psram\"", heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM));
+  gauge(out, "typed_heap_min_free_bytes", "Lowest free internal heap since boot", ESP.getMinFreeHeap());
+
+  const bool up = WiFi.isConnected();
+  gauge(out, "typed_wifi_connected", "1 when associated", up ? 1 : 0);
+  if (up) {
+    header(out, "typed_wifi_rssi_dbm", "gauge", "Signal strength of the current AP");
+    char rssi[48];
+    snprintf(rssi, sizeof(rssi), "typed_wifi_rssi_dbm %d\n", (int)WiFi.RSSI());
+    out += rssi;
+  }
+  counter(out, "typed_wifi_reconnects_total", "Links re-established after a drop",
+          WiFiMgr::getConnectInfo().reconnects);
+
+  counter(out, "typed_upload_bytes_total", "File manager upload bytes written", c(UPLOAD_BYTES));
+  return out;
+}
+
+void begin(AsyncWebServer &server) {
+  server.on("/metrics", HTTP_GET, [](AsyncWebServerRequest *request) {
+    AsyncWebServerResponse *r = request->beginResponse(200, "text/plain; version=0.0.4", render());
+    r->addHeader("Cache-Control", "no-store");
+    request->send(r);
+  });
+}
+
+} // namespace Metrics
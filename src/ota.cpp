@@ -0,0 +1,300 @@
+// ota.cpp
+
+#include "ota.h"
+#include <WiFi.h>
+#include <Update.h>
+#include <FFat.h>
+#include <Preferences.h>
+#include <esp_ota_ops.h>
+#include <mbedtls/sha256.h>
+#include <algorithm>
+#if CONFIG_IDF_TARGET_ESP32S3
+#include "esp32s3/rom/miniz.h"
+#else
+#include "esp32/rom/miniz.h"
+#endif
+
+#ifndef OTA_MAX_TRIAL_BOOTS
+#define OTA_MAX_TRIAL_BOOTS      3
+#endif
+#ifndef OTA_SELFTEST_MS
+#define OTA_SELFTEST_MS          30000UL  // minimum uptime before the image counts as good
+#endif
+#ifndef OTA_SELFTEST_MIN_HEAP
+#define OTA_SELFTEST_MIN_HEAP    32768
+#endif
+#ifndef OTA_REBOOT_DELAY_MS
+#define OTA_REBOOT_DELAY_MS      1500     // let the HTTP reply go out first
+#endif
+#ifndef OTA_ALLOW_RAW
+#define OTA_ALLOW_RAW            1        // accept plain .bin uploads
+#endif
+
+#define OTA_NVS_NS      "ota"
+#define OTA_MAGIC       "TDOT"
+#define OTA_HDR_VER     1
+#define OTA_COMP_NONE   0
+#define OTA_COMP_ZLIB   1
+
+struct __attribute__((packed)) OtaHeader {
+  char     magic[4];     // "TDOT"
+  uint8_t  version;      // OTA_HDR_VER
+  uint8_t  comp;         // OTA_COMP_*
+  uint16_t hdrLen;       // sizeof(OtaHeader); larger = newer fields to skip
+  uint32_t imageLen;     // uncompressed app image
+  uint32_t payloadLen;   // bytes after the header
+  uint8_t  sha256[32];   // of the uncompressed image
+};
+static_assert(sizeof(OtaHeader) == 48, "OTA header layout");
+
+namespace OTA {
+
+enum State : uint8_t { ST_IDLE, ST_HEADER, ST_SKIP, ST_BODY, ST_RAW, ST_FAILED, ST_DONE };
+
+// ---- upload state (AsyncTCP task) ----
+static State     s_state = ST_IDLE;
+static OtaHeader s_hdr;
+static size_t    s_hdr_got = 0;
+static uint32_t  s_payload_got = 0;
+static uint32_t  s_written = 0;
+static bool      s_inflate_done = false;
+static mbedtls_sha256_context s_sha;
+static tinfl_decompressor *s_inf  = nullptr;
+static uint8_t  *s_dict  = nullptr;     // TINFL_LZ_DICT_SIZE ring
+static size_t    s_dict_ofs = 0;
+static const char *s_err = "";
+
+// ---- boot / self-test state (loop task) ----
+static bool     s_trial    = false;
+static bool     s_bl_trial = false;     // bootloader rollback is active for this image
+static uint32_t s_reboot_at = 0;
+
+static void release() {
+  free(s_inf);  s_inf  = nullptr;
+  free(s_dict); s_dict = nullptr;
+  mbedtls_sha256_free(&s_sha);
+}
+
+static void fail(const char *why) {
+  if (s_state == ST_FAILED) return;
+  s_err = why;
+  s_state = ST_FAILED;
+  if (Update.isRunning()) Update.abort();
+  release();
+  Serial.printf("[OTA] Aborted: %s\n", why);
+}
+
+// Inflated/raw image bytes -> hash + flash
+static bool emit(const uint8_t *p, size_t n) {
+  if (!n) return true;
+  if (s_state == ST_BODY && s_written + n > s_hdr.imageLen) { fail("image longer than header"); return false; }
+  mbedtls_sha256_update(&s_sha, p, n);
+  if (Update.write(const_cast<uint8_t *>(p), n) != n) { fail(Update.errorString()); return false; }
+  s_written += n;
+  return true;
+}
+
+static void start_body() {
+  if (s_hdr.version != OTA_HDR_VER || s_hdr.hdrLen < sizeof(OtaHeader)) { fail("unsupported header"); return; }
+  if (s_hdr.comp != OTA_COMP_NONE && s_hdr.comp != OTA_COMP_ZLIB)      { fail("unsupported compression"); return; }
+  if (!Update.begin(s_hdr.imageLen))                                 { fail(Update.errorString()); return; }
+
+  if (s_hdr.comp == OTA_COMP_ZLIB) {
+    s_inf  = (tinfl_decompressor *)malloc(sizeof(tinfl_decompressor));
+    s_dict = (uint8_t *)malloc(TINFL_LZ_DICT_SIZE);
+    if (!s_inf || !s_dict) { fail("out of memory"); return; }
+    tinfl_init(s_inf);
+    s_dict_ofs = 0;
+  }
+  Serial.printf("[OTA] Packed image: %lu -> %lu bytes (%s)\n",
+                (unsigned long)s_hdr.payloadLen, (unsigned long)s_hdr.imageLen,
+                s_hdr.comp == OTA_COMP_ZLIB ? "zlib" : "stored");
+  s_state = (s_hdr.hdrLen > sizeof(OtaHeader)) ? ST_SKIP : ST_BODY;
+}
+
+static void inflate(const uint8_t *in, size_t len) {
+  const bool more = s_payload_got < s_hdr.payloadLen;
+  for (;;) {
+    size_t inSz  = len;
+    size_t outSz = TINFL_LZ_DICT_SIZE - s_dict_ofs;
+    const tinfl_status st = tinfl_decompress(s_inf, in, &inSz, s_dict, s_dict + s_dict_ofs, &outSz,
+                                             TINFL_FLAG_PARSE_ZLIB_HEADER | (more ? TINFL_FLAG_HAS_MORE_INPUT : 0));
+    in += inSz;
+    len -= inSz;
+    if (!emit(s_dict + s_dict_ofs, outSz)) return;
+    s_dict_ofs = (s_dict_ofs + outSz) & (TINFL_LZ_DICT_SIZE - 1);
+
+    if (st == TINFL_STATUS_DONE) { s_inflate_done = true; return; }
+    if (st < 0)                  { fail("corrupt compressed stream"); return; }
+    if (st == TINFL_STATUS_NEEDS_MORE_INPUT && !len) return;
+  }
+}
+
+static void body(const uint8_t *data, size_t len) {
+  if (s_payload_got + len > s_hdr.payloadLen) { fail("upload longer than header"); return; }
+  s_payload_got += len;
+  if (s_hdr.comp == OTA_COMP_ZLIB) {
+    if (s_inflate_done) { fail("data after end of stream"); return; }
+    inflate(data, len);
+  } else {
+    emit(data, len);
+  }
+}
+
+void uploadBegin(const char *filename) {
+  if (Update.isRunning()) Update.abort();   // a previous upload that never finished
+  release();
+  s_state = ST_HEADER;
+  s_err = "";
+  s_hdr_got = 0;
+  s_payload_got = 0;
+  s_written = 0;
+  s_inflate_done = false;
+  mbedtls_sha256_init(&s_sha);
+  mbedtls_sha256_starts(&s_sha, 0);
+  Serial.printf("[OTA] Start firmware upload: %s\n", filename ? filename : "");
+}
+
+void uploadWrite(const uint8_t *data, size_t len) {
+  while (len) {
+    switch (s_state) {
+      case ST_HEADER: {
+        if (s_hdr_got == 0 && data[0] == 0xE9) {
+#if OTA_ALLOW_RAW
+          if (!Update.begin(UPDATE_SIZE_UNKNOWN)) { fail(Update.errorString()); return; }
+          Serial.println("[OTA] Plain image (no header): IDF image check only");
+          s_state = ST_RAW;
+          continue;
+#else
+          fail("plain images disabled; use ota_pack.py");
+          return;
+#endif
+        }
+        const size_t n = std::min(len, sizeof(OtaHeader) - s_hdr_got);
+        memcpy(reinterpret_cast<uint8_t *>(&s_hdr) + s_hdr_got, data, n);
+        s_hdr_got += n; data += n; len -= n;
+        if (s_hdr_got == sizeof(OtaHeader)) {
+          if (memcmp(s_hdr.magic, OTA_MAGIC, 4) != 0) { fail("not a firmware image"); return; }
+          start_body();
+        }
+        break;
+      }
+      case ST_SKIP: {
+        const size_t n = std::min(len, (size_t)s_hdr.hdrLen - s_hdr_got);
+        s_hdr_got += n; data += n; len -= n;
+        if (s_hdr_got == s_hdr.hdrLen) s_state = ST_BODY;
+        break;
+      }
+      case ST_BODY:
+        body(data, len);
+        return;
+      case ST_RAW:
+        emit(data, len);
+        return;
+      default:
+        return;   // failed / idle: ignore the rest of the upload
+    }
+  }
+}
+
+bool uploadEnd() {
+  if (s_state == ST_HEADER) fail("upload too short");
+  if (s_state == ST_BODY) {
+    uint8_t digest[32];
+    mbedtls_sha256_finish(&s_sha, digest);
+    if (s_payload_got != s_hdr.payloadLen)                             fail("upload truncated");
+    else if (s_hdr.comp == OTA_COMP_ZLIB && !s_inflate_done)           fail("compressed stream truncated");
+    else if (s_written != s_hdr.imageLen)                              fail("image length mismatch");
+    else if (memcmp(digest, s_hdr.sha256, sizeof(digest)) != 0)        fail("SHA-256 mismatch");
+  }
+  if (s_state != ST_BODY && s_state != ST_RAW) { release(); return false; }
+
+  // Record the fallback before the switch, so a crash right after it still rolls back
+  const esp_partition_t *run = esp_ota_get_running_partition();
+  Preferences p;
+  p.begin(OTA_NVS_NS, false);
+  p.putString("prev", run ? run->label : "");
+  p.putUChar("tries", 0);
+  p.putUChar("pend", 1);
+
+  if (!Update.end(s_state == ST_RAW)) {
+    p.putUChar("pend", 0);
+    p.end();
+    fail(Update.errorString());
+    return false;
+  }
+  p.end();
+  release();
+  s_state = ST_DONE;
+  s_reboot_at = millis() + OTA_REBOOT_DELAY_MS;
+  Serial.printf("[OTA] Update verified (%lu bytes). Rebooting...\n", (unsigned long)s_written);
+  return true;
+}
+
+bool ok()              { return s_state == ST_DONE; }
+const char *lastError(){ return s_err; }
+bool onTrial()         { return s_trial; }
+
+void bootCheck() {
+  const esp_partition_t *run = esp_ota_get_running_partition();
+  esp_ota_img_states_t st;
+  s_bl_trial = run && esp_ota_get_state_partition(run, &st) == ESP_OK && st == ESP_OTA_IMG_PENDING_VERIFY;
+
+  Preferences p;
+  p.begin(OTA_NVS_NS, false);
+  if (p.getUChar("pend", 0)) {
+    const String prev = p.getString("prev", "");
+    if (!run || prev == run->label) {
+      p.putUChar("pend", 0);            // switch never happened, or already rolled back
+    } else {
+      const uint8_t tries = p.getUChar("tries", 0) + 1;
+      p.putUChar("tries", tries);
+      s_trial = true;
+      Serial.printf("[OTA] Trial boot %u/%u of new image\n", tries, OTA_MAX_TRIAL_BOOTS);
+      if (tries > OTA_MAX_TRIAL_BOOTS) {
+        p.putUChar("pend", 0);
+        p.end();
+        Serial.printf("[OTA] Self-test never passed; rolling back to %s\n", prev.c_str());
+        if (s_bl_trial) esp_ota_mark_app_invalid_rollback_and_reboot();
+        const esp_partition_t *back =
+            esp_partition_find_first(ESP_PARTITION_TYPE_APP, ESP_PARTITION_SUBTYPE_ANY, prev.c_str());
+        if (back && esp_ota_set_boot_partition(back) == ESP_OK) ESP.restart();
+        Serial.println("[OTA] Rollback target missing; keeping this image");
+        s_trial = false;
+        return;
+      }
+    }
+  }
+  p.end();
+  s_trial |= s_bl_trial;
+}
+
+void loop() {
+  if (s_reboot_at && (int32_t)(millis() - s_reboot_at) >= 0) {
+    ESP.restart();
+  }
+
+  if (!s_trial || millis() < OTA_SELFTEST_MS) return;
+  if (FFat.totalBytes() == 0)                  return;
+  if (ESP.getFreeHeap() < OTA_SELFTEST_MIN_HEAP) return;
+  // Local health only: the WiFi driver must have started (connecting,
+  // connected or portal), but an AP that is down for a few boots must not
+  // roll a good image back
+  if (WiFi.getMode() == WIFI_OFF)              return;
+
+  if (s_bl_trial) esp_ota_mark_app_valid_cancel_rollback();
+  Preferences p;
+  p.begin(OTA_NVS_NS, false);
+  p.putUChar("pend", 0);
+  p.end();
+  s_trial = false;
+  Serial.println("[OTA] Self-test passed; new image marked valid");
+}
+
+} // namespace OTA
+
+// Arduino core hook: keep a bootloader-trial image pending until OTA::loop()
+// has run the self-test (instead of marking it valid at startup)
+extern "C" bool verifyRollbackLater() {
+  return true;
+}
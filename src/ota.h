@@ -0,0 +1,39 @@
+// ota.h
+//
+// Verified, streaming firmware update. Uploads are either
+//   - a packed image from script/ota_pack.py: 48-byte "TDOT" header
+//     (image length, SHA-256 of the image) + zlib payload, inflated on the
+//     fly straight into the OTA partition, or
+//   - a plain .bin (ESP image magic 0xE9), written as-is; the IDF's own
+//     image check at end() still applies.
+// The boot partition only switches after the length and SHA-256 match.
+//
+// A new image boots "on trial": it is marked valid once the post-boot
+// self-test passes (loop() running for OTA_SELFTEST_MS, FFat mounted, heap
+// OK, WiFi driver started). The test is local on purpose: whether the AP is
+// reachable says nothing about the image, so a router outage never causes
+// a rollback. An image that can't even start WiFi still fails.
+// After OTA_MAX_TRIAL_BOOTS boots without passing, the previous image is
+// restored (bootloader rollback when enabled, otherwise via NVS).
+
+#pragma once
+#include <Arduino.h>
+
+namespace OTA {
+
+  // First thing in setup(): count trial boots, roll back if needed
+  void bootCheck();
+
+  // Main loop: post-boot self-test and the deferred post-update reboot
+  void loop();
+
+  // Upload path (AsyncTCP task); chunks must arrive in order.
+  // After the first failure every further chunk is ignored.
+  void uploadBegin(const char *filename);
+  void uploadWrite(const uint8_t *data, size_t len);
+  bool uploadEnd();             // verify + switch boot partition; reboots from loop()
+
+  bool        ok();             // last upload verified and committed
+  const char *lastError();      // "" when ok
+  bool        onTrial();        // running image not yet marked valid
+}
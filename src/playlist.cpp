@@ -0,0 +1,444 @@
+// playlist.cpp
+//
+// /playlist.bin layout (little-endian):
+//   "TDPL" | ver u8 | flags u8 (bit0 weighted) | tz i16 (minutes) | count u16
+//   count x { dur_ms u32 | from u16 | to u16 | loops u8 | weight u8 | len u8 | path[len] }
+// from/to are minutes of day; from == to means "always".
+//
+// At load the day is split into segments at every window edge. Each segment
+// gets a precomputed play order (list order, or smooth weighted round-robin),
+// so next() is a cursor increment. The segment is re-resolved only when the
+// clock leaves it.
+//
+// The web handlers never touch the compiled schedule. They read/write the file
+// and queue a reload for the render loop (DispQueue::OP_PLAYLIST_RELOAD).
+
+#include "playlist.h"
+#include "disp_queue.h"
+#include <FFat.h>
+#include <vector>
+#include <algorithm>
+#include <time.h>
+
+#define PLAYLIST_PATH        "/playlist.bin"
+#define PLAYLIST_TMP_PATH    "/playlist.tmp"
+#define PLAYLIST_MAGIC       "TDPL"
+#define PLAYLIST_VERSION     1
+#define PLAYLIST_MAX_ITEMS   64
+#define PLAYLIST_MAX_WEIGHT  8
+#define PLAYLIST_MAX_SLOTS   4096   // sum of all segment schedules
+#define PLAYLIST_MAX_BODY    8192
+#define PLAYLIST_PATH_LEN    96
+#define PLAYLIST_FLAG_WEIGHTED 0x01
+#define MINUTES_PER_DAY      1440
+
+namespace Playlist {
+
+struct Item {
+  String path;
+  uint32_t durationMs;
+  uint16_t fromMin;
+  uint16_t toMin;
+  uint8_t loops;
+  uint8_t weight;
+  bool missing;                   // file failed to open; skipped until the next load()
+};
+
+struct Segment {
+  uint16_t startMin;              // inclusive
+  uint16_t endMin;                // exclusive
+  std::vector<uint8_t> order;     // item indices, in play order
+};
+
+static std::vector<Item> items;
+static std::vector<Segment> segments;
+static Segment allDay;            // used while the clock is not set
+static int16_t tzMinutes = 0;
+static bool weighted = false;
+static bool loaded = false;
+
+static const Segment *curSeg = nullptr;
+static size_t cursor = 0;         // next position in curSeg->order
+
+// ---- Little-endian helpers ----
+static uint16_t rd16(const uint8_t *p) { return p[0] | (p[1] << 8); }
+static uint32_t rd32(const uint8_t *p) { return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24); }
+static void wr16(File &f, uint16_t v) { uint8_t b[2] = { (uint8_t)v, (uint8_t)(v >> 8) }; f.write(b, 2); }
+static void wr32(File &f, uint32_t v) {
+  uint8_t b[4] = { (uint8_t)v, (uint8_t)(v >> 8), (uint8_t)(v >> 16), (uint8_t)(v >> 24) };
+  f.write(b, 4);
+}
+
+static bool inWindow(const Item &it, uint16_t minute) {
+  if (it.fromMin == it.toMin) return true;
+  if (it.fromMin < it.toMin) return minute >= it.fromMin && minute < it.toMin;
+  return minute >= it.fromMin || minute < it.toMin;   // wraps midnight
+}
+
+// Build the play order for the items eligible at 'minute' (or all if minute < 0)
+static void buildOrder(Segment &seg, int minute) {
+  seg.order.clear();
+  std::vector<uint8_t> eligible;
+  for (size_t i = 0; i < items.size(); ++i)
+    if (minute < 0 || inWindow(items[i], (uint16_t)minute)) eligible.push_back((uint8_t)i);
+  if (eligible.empty()) return;
+
+  if (!weighted) {
+    seg.order = eligible;
+    return;
+  }
+
+  // Smooth weighted round-robin: spreads heavy items instead of clumping them
+  int total = 0;
+  std::vector<int> current(eligible.size(), 0);
+  for (uint8_t idx : eligible) total += items[idx].weight;
+  for (int n = 0; n < total; ++n) {
+    size_t best = 0;
+    for (size_t k = 0; k < eligible.size(); ++k) {
+      current[k] += items[eligible[k]].weight;
+      if (current[k] > current[best]) best = k;
+    }
+    current[best] -= total;
+    seg.order.push_back(eligible[best]);
+  }
+}
+
+static bool compile() {
+  segments.clear();
+  curSeg = nullptr;
+  cursor = 0;
+
+  std::vector<uint16_t> edges;
+  edges.push_back(0);
+  for (const Item &it : items) {
+    if (it.fromMin == it.toMin) continue;
+    edges.push_back(it.fromMin);
+    edges.push_back(it.toMin);
+  }
+  std::sort(edges.begin(), edges.end());
+  edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+  size_t slots = 0;
+  for (size_t i = 0; i < edges.size(); ++i) {
+    Segment seg;
+    seg.startMin = edges[i];
+    seg.endMin = (i + 1 < edges.size()) ? edges[i + 1] : MINUTES_PER_DAY;
+    buildOrder(seg, seg.startMin);
+    slots += seg.order.size();
+    segments.push_back(std::move(seg));
+  }
+  buildOrder(allDay, -1);
+  slots += allDay.order.size();
+
+  if (slots > PLAYLIST_MAX_SLOTS) {
+    Serial.printf("[Playlist] Schedule too large (%u slots)\n", (unsigned)slots);
+    segments.clear();
+    allDay.order.clear();
+    return false;
+  }
+  Serial.printf("[Playlist] Compiled %u items into %u segments (%u slots)\n",
+                (unsigned)items.size(), (unsigned)segments.size(), (unsigned)slots);
+  return true;
+}
+
+// Minute of day in playlist local time, or -1 if the clock is not set yet
+static int minuteOfDay() {
+  time_t now = time(nullptr);
+  if (now < 1600000000) return -1;
+  long m = (long)((now / 60) % MINUTES_PER_DAY) + tzMinutes;
+  m %= MINUTES_PER_DAY;
+  if (m < 0) m += MINUTES_PER_DAY;
+  return (int)m;
+}
+
+// Resolve the active segment; cheap when still inside the current one
+static const Segment *activeSegment() {
+  const int minute = minuteOfDay();
+  if (minute < 0) {
+    if (curSeg != &allDay) { curSeg = &allDay; cursor = 0; }
+    return curSeg;
+  }
+  if (curSeg && curSeg != &allDay && minute >= curSeg->startMin && minute < curSeg->endMin)
+    return curSeg;
+  for (const Segment &s : segments) {
+    if (minute >= s.startMin && minute < s.endMin) {
+      curSeg = &s;
+      cursor = 0;
+      return curSeg;
+    }
+  }
+  return nullptr;
+}
+
+static bool pick(Entry &out, int step) {
+  if (!loaded) return false;
+  const Segment *seg = activeSegment();
+  if (!seg || seg->order.empty()) return false;
+  const size_t n = seg->order.size();
+  if (step < 0) cursor = (cursor + 2 * n - 2) % n;   // back to the one before current
+  for (size_t tries = 0; tries < n; ++tries) {
+    const Item &it = items[seg->order[cursor % n]];
+    if (it.missing) {
+      cursor = (step < 0) ? (cursor + n - 1) % n : (cursor + 1) % n;
+      continue;
+    }
+    cursor = (cursor + 1) % n;
+    out.path = it.path.c_str();
+    out.durationMs = it.durationMs;
+    out.loops = it.loops;
+    return true;
+  }
+  return false;                   // every item in this segment is missing
+}
+
+void markMissing(const char *path) {
+  for (Item &it : items) {
+    if (!it.missing && it.path == path) {
+      it.missing = true;
+      Serial.printf("[Playlist] Skipping missing item %s\n", path);
+    }
+  }
+}
+
+bool hasPlayable() {
+  if (!loaded) return false;
+  const Segment *seg = activeSegment();
+  if (!seg) return false;
+  for (uint8_t idx : seg->order)
+    if (!items[idx].missing) return true;
+  return false;
+}
+
+bool next(Entry &out) { return pick(out, 1); }
+bool prev(Entry &out) { return pick(out, -1); }
+
+bool isLoaded() { return loaded; }
+
+bool load() {
+  loaded = false;
+  items.clear();
+  segments.clear();
+  allDay.order.clear();
+  curSeg = nullptr;
+
+  File f = FFat.open(PLAYLIST_PATH, "r");
+  if (!f) return false;
+
+  uint8_t hdr[10];
+  if (f.read(hdr, sizeof(hdr)) != sizeof(hdr) || memcmp(hdr, PLAYLIST_MAGIC, 4) != 0 ||
+      hdr[4] != PLAYLIST_VERSION) {
+    Serial.println("[Playlist] Bad header, ignoring " PLAYLIST_PATH);
+    f.close();
+    return false;
+  }
+  weighted = hdr[5] & PLAYLIST_FLAG_WEIGHTED;
+  tzMinutes = (int16_t)rd16(hdr + 6);
+  uint16_t count = rd16(hdr + 8);
+  if (count > PLAYLIST_MAX_ITEMS) count = PLAYLIST_MAX_ITEMS;
+
+  for (uint16_t i = 0; i < count; ++i) {
+    uint8_t rec[11];
+    if (f.read(rec, sizeof(rec)) != sizeof(rec)) break;
+    char path[PLAYLIST_PATH_LEN];
+    const uint8_t len = rec[10] < sizeof(path) - 1 ? rec[10] : sizeof(path) - 1;
+    if (f.read((uint8_t *)path, len) != len) break;
+    if (len < rec[10]) f.seek(rec[10] - len, SeekCur);
+    path[len] = '\0';
+
+    Item it;
+    it.path = path;
+    it.durationMs = rd32(rec);
+    it.fromMin = rd16(rec + 4) % MINUTES_PER_DAY;
+    it.toMin = rd16(rec + 6) % MINUTES_PER_DAY;
+    it.loops = rec[8];
+    it.weight = constrain(rec[9], 1, PLAYLIST_MAX_WEIGHT);
+    it.missing = false;
+    items.push_back(it);
+  }
+  f.close();
+
+  if (items.empty() || !compile()) return false;
+  loaded = true;
+  return true;
+}
+
+// ---- Crude JSON helpers (flat objects, no escapes beyond \" in strings) ----
+static const char *findKey(const char *p, const char *end, const char *key) {
+  const size_t klen = strlen(key);
+  for (; p + klen + 2 <= end; ++p) {
+    if (*p == '"' && !strncmp(p + 1, key, klen) && p[klen + 1] == '"') {
+      p += klen + 2;
+      while (p < end && (*p == ' ' || *p == ':' || *p == '\t' || *p == '\n' || *p == '\r')) ++p;
+      return p;
+    }
+  }
+  return nullptr;
+}
+
+static bool getNum(const char *p, const char *end, const char *key, long &out) {
+  const char *v = findKey(p, end, key);
+  if (!v || v >= end) return false;
+  out = strtol(v, nullptr, 10);
+  return true;
+}
+
+static bool getStr(const char *p, const char *end, const char *key, char *out, size_t outSize) {
+  const char *v = findKey(p, end, key);
+  if (!v || v >= end || *v != '"') return false;
+  ++v;
+  size_t n = 0;
+  while (v < end && *v != '"' && n + 1 < outSize) {
+    if (*v == '\\' && v + 1 < end) ++v;
+    out[n++] = *v++;
+  }
+  out[n] = '\0';
+  return true;
+}
+
+static uint16_t parseHHMM(const char *s) {
+  int h = 0, m = 0;
+  if (sscanf(s, "%d:%d", &h, &m) < 1) return 0;
+  return (uint16_t)(((h * 60 + m) % MINUTES_PER_DAY + MINUTES_PER_DAY) % MINUTES_PER_DAY);
+}
+
+// Parse the JSON body and write /playlist.bin (via temp file + rename)
+static bool writeFromJson(const char *json, String &err) {
+  const char *end = json + strlen(json);
+  const char *arr = findKey(json, end, "items");
+  if (!arr || *arr != '[') { err = "missing items"; return false; }
+
+  char order[16] = "ordered";
+  long tz = 0;
+  // Top-level keys are looked up only before "items" so item fields don't shadow them
+  getStr(json, arr, "order", order, sizeof(order));
+  getNum(json, arr, "tz", tz);
+
+  File f = FFat.open(PLAYLIST_TMP_PATH, "w");
+  if (!f) { err = "fs"; return false; }
+  f.write((const uint8_t *)PLAYLIST_MAGIC, 4);
+  const uint8_t verFlags[2] = { PLAYLIST_VERSION, (uint8_t)(!strcmp(order, "weighted") ? PLAYLIST_FLAG_WEIGHTED : 0) };
+  f.write(verFlags, 2);
+  wr16(f, (uint16_t)(int16_t)tz);
+  const size_t countPos = f.position();
+  wr16(f, 0);
+
+  uint16_t count = 0;
+  const char *p = arr + 1;
+  while (count < PLAYLIST_MAX_ITEMS) {
+    const char *ob = strchr(p, '{');
+    if (!ob || ob >= end) break;
+    // Find the matching '}' outside of strings
+    const char *cb = ob + 1;
+    bool inStr = false;
+    for (; cb < end; ++cb) {
+      if (*cb == '\\' && inStr) { ++cb; continue; }
+      if (*cb == '"') inStr = !inStr;
+      else if (*cb == '}' && !inStr) break;
+    }
+    if (cb >= end) break;
+
+    char path[PLAYLIST_PATH_LEN] = {0};
+    char from[8] = "", to[8] = "";
+    long dur = 5000, loops = 1, weight = 1;
+    if (!getStr(ob, cb, "file", path, sizeof(path)) || !path[0]) { p = cb + 1; continue; }
+    getNum(ob, cb, "dur", dur);
+    getNum(ob, cb, "loops", loops);
+    getNum(ob, cb, "weight", weight);
+    getStr(ob, cb, "from", from, sizeof(from));
+    getStr(ob, cb, "to", to, sizeof(to));
+
+    wr32(f, (uint32_t)constrain(dur, 100L, 86400000L));
+    wr16(f, from[0] ? parseHHMM(from) : 0);
+    wr16(f, to[0] ? parseHHMM(to) : 0);
+    const uint8_t tail[3] = { (uint8_t)constrain(loops, 0L, 255L),
+                              (uint8_t)constrain(weight, 1L, (long)PLAYLIST_MAX_WEIGHT),
+                              (uint8_t)strlen(path) };
+    f.write(tail, 3);
+    f.write((const uint8_t *)path, tail[2]);
+    count++;
+    p = cb + 1;
+  }
+  f.seek(countPos);
+  wr16(f, count);
+  f.close();
+
+  if (!count) { FFat.remove(PLAYLIST_TMP_PATH); err = "no valid items"; return false; }
+  FFat.remove(PLAYLIST_PATH);
+  if (!FFat.rename(PLAYLIST_TMP_PATH, PLAYLIST_PATH)) { err = "rename"; return false; }
+  return true;
+}
+
+static void fmtHHMM(char *out, uint16_t m) {
+  snprintf(out, 6, "%02u:%02u", m / 60, m % 60);
+}
+
+// GET: decode the file (not the live schedule, which belongs to the render loop)
+static void handleGet(AsyncWebServerRequest *request) {
+  File f = FFat.open(PLAYLIST_PATH, "r");
+  uint8_t hdr[10];
+  if (!f || f.read(hdr, sizeof(hdr)) != sizeof(hdr) || memcmp(hdr, PLAYLIST_MAGIC, 4) != 0) {
+    if (f) f.close();
+    request->send(404, "application/json", "{\"err\":\"no playlist\"}");
+    return;
+  }
+  AsyncResponseStream *response = request->beginResponseStream("application/json");
+  response->printf("{\"order\":\"%s\",\"tz\":%d,\"items\":[",
+                   (hdr[5] & PLAYLIST_FLAG_WEIGHTED) ? "weighted" : "ordered", (int16_t)rd16(hdr + 6));
+  const uint16_t count = rd16(hdr + 8);
+  for (uint16_t i = 0; i < count; ++i) {
+    uint8_t rec[11];
+    char path[256];
+    if (f.read(rec, sizeof(rec)) != sizeof(rec) || f.read((uint8_t *)path, rec[10]) != rec[10]) break;
+    path[rec[10]] = '\0';
+    char from[6], to[6];
+    fmtHHMM(from, rd16(rec + 4));
+    fmtHHMM(to, rd16(rec + 6));
+    response->printf("%s{\"file\":\"%s\",\"dur\":%lu,\"loops\":%u,\"weight\":%u,\"from\":\"%s\",\"to\":\"%s\"}",
+                     i ? "," : "", path, (unsigned long)rd32(rec), rec[8], rec[9], from, to);
+  }
+  f.close();
+  response->print("]}");
+  request->send(response);
+}
+
+static void handlePost(AsyncWebServerRequest *request) {
+  const char *body = (const char *)request->_tempObject;
+  if (!body) {
+    request->send(400, "application/json", "{\"err\":\"empty or oversized body\"}");
+    return;
+  }
+  String err;
+  if (!writeFromJson(body, err)) {
+    request->send(400, "application/json", "{\"err\":\"" + err + "\"}");
+    return;
+  }
+  DispQueue::post(DispQueue::OP_PLAYLIST_RELOAD);
+  request->send(200, "application/json", "{\"ok\":1}");
+}
+
+static void handleBody(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+  if (total > PLAYLIST_MAX_BODY) return;
+  if (index == 0) request->_tempObject = malloc(total + 1);
+  char *buf = (char *)request->_tempObject;
+  if (!buf) return;
+  memcpy(buf + index, data, len);
+  if (index + len == total) buf[total] = '\0';
+}
+
+static void handleDelete(AsyncWebServerRequest *request) {
+  FFat.remove(PLAYLIST_PATH);
+  DispQueue::post(DispQueue::OP_PLAYLIST_RELOAD);
+  request->send(200, "application/json", "{\"ok\":1}");
+}
+
+void begin(AsyncWebServer &server) {
+  // UTC from SNTP; the playlist's own tz offset is applied in minuteOfDay()
+  configTime(0, 0, "pool.ntp.org");
+
+  server.on("/api/playlist", HTTP_GET, handleGet);
+  server.on("/api/playlist", HTTP_POST, handlePost, nullptr, handleBody);
+  server.on("/api/playlist", HTTP_DELETE, handleDelete);
+  Serial.println("[Playlist] /api/playlist registered");
+}
+
+} // namespace Playlist
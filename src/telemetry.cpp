@@ -0,0 +1,192 @@
+// telemetry.cpp
+//
+// Live telemetry push for browsers on port 8080.
+// - /events is a Server-Sent Events stream ("status" and "perf" events).
+// - Each decoded XboxStatus change is serialized ONCE into a shared frame
+//   buffer and handed to AsyncEventSource::send(), which fans the same
+//   payload out to every client. No per-viewer String building.
+// - Device performance counters (loop period, heap, PSRAM, RSSI) are pushed
+//   on a fixed cadence, and only while someone is watching.
+// - /live is a small static dashboard that listens to /events.
+
+#include "telemetry.h"
+#include "udp_detect.h"
+#include "detect.h"
+#include <WiFi.h>
+#include <esp_heap_caps.h>
+#include <atomic>
+#include "trace.h"
+
+#define TELEMETRY_PERF_INTERVAL_MS 1000  // perf counter push cadence
+#define TELEMETRY_MAX_BACKLOG      8     // skip perf frames if clients lag this far behind
+#define TELEMETRY_FRAME_SIZE       384
+
+static AsyncEventSource events("/events");
+
+// Shared, reused serialization buffer (one frame for all clients)
+static char s_frame[TELEMETRY_FRAME_SIZE];
+static uint32_t s_eventId = 0;
+
+static uint32_t s_lastStatusSeq = 0;          // loop() only
+static std::atomic<bool> s_resendStatus{false}; // set from the AsyncTCP task on connect
+static unsigned long s_lastPerf = 0;
+
+// Loop period accounting (time between successive Telemetry::loop() calls)
+static uint32_t s_lastLoopUs = 0;
+static uint32_t s_loopSumUs = 0;
+static uint32_t s_loopCount = 0;
+static uint32_t s_loopMaxUs = 0;
+
+static const char LIVE_PAGE[] PROGMEM = R"rawliteral(
+<!DOCTYPE html>
+<html>
+<head>
+<title>Type D Live</title>
+<meta charset='UTF-8'>
+<meta name="viewport" content="width=480">
+<style>
+body {background:#141414;color:#EEE;font-family:sans-serif;display:flex;flex-direction:column;align-items:center;}
+h1, h2 {color:#4eec27;}
+.section {background:#232323;padding:16px 18px;margin:16px auto;border-radius:14px;min-width:320px;}
+.row {display:flex;justify-content:space-between;margin:4px 0;}
+.val {color:#49e24e;font-weight:bold;}
+.dim {color:#888;font-size:.9em;}
+</style>
+</head>
+<body>
+<h1>Type D Live</h1>
+<div class='section'><h2>Xbox Status</h2><div id='status'></div></div>
+<div class='section'><h2>Device</h2><div id='perf'></div></div>
+<div class='dim' id='conn'>Connecting...</div>
+<script>
+const labels = {fan:'Fan %',cpu:'CPU C',amb:'Ambient C',app:'App',tray:'Tray',av:'AV Pack',pic:'PIC',xboxver:'Xbox Ver',
+  enc:'Encoder',res:'Resolution',up:'Uptime s',heap:'Heap free',heap_min:'Heap min',psram:'PSRAM free',
+  loop_avg_us:'Loop avg us',loop_max_us:'Loop max us',rssi:'RSSI dBm',viewers:'Viewers',id:'Device ID',peers:'Peers'};
+function render(el, obj){
+  const box = document.getElementById(el);
+  box.replaceChildren();
+  for (const k in obj) {
+    const row = document.createElement('div'), name = document.createElement('span'), val = document.createElement('span');
+    row.className = 'row';
+    val.className = 'val';
+    name.textContent = labels[k]||k;
+    val.textContent = obj[k];
+    row.append(name, val);
+    box.appendChild(row);
+  }
+}
+const es = new EventSource('/events');
+es.onopen = () => document.getElementById('conn').innerText = 'Live';
+es.onerror = () => document.getElementById('conn').innerText = 'Reconnecting...';
+es.addEventListener('status', e => render('status', JSON.parse(e.data)));
+es.addEventListener('perf', e => render('perf', JSON.parse(e.data)));
+</script>
+</body>
+</html>
+)rawliteral";
+
+// Copy a C string into a JSON string body, escaping quotes/backslashes/control chars
+static size_t jsonEscape(char *out, size_t outSize, const char *in) {
+    size_t o = 0;
+    for (size_t i = 0; in[i] && o + 2 < outSize; ++i) {
+        char c = in[i];
+        if (c == '"' || c == '\\') {
+            out[o++] = '\\';
+            out[o++] = c;
+        } else if ((uint8_t)c < 0x20) {
+            out[o++] = ' ';
+        } else {
+            out[o++] = c;
+        }
+    }
+    out[o] = '\0';
+    return o;
+}
+
+static void pushStatus(const XboxStatus &st) {
+    char app[2 * sizeof(st.currentApp)];
+    char res[2 * sizeof(st.resolution)];
+    jsonEscape(app, sizeof(app), st.currentApp);
+    jsonEscape(res, sizeof(res), st.resolution);
+
+    snprintf(s_frame, sizeof(s_frame),
+             "{\"fan\":%d,\"cpu\":%d,\"amb\":%d,\"app\":\"%s\","
+             "\"tray\":%d,\"av\":%d,\"pic\":%d,\"xboxver\":%d,\"enc\":%d,"
+             "\"w\":%d,\"h\":%d,\"res\":\"%s\"}",
+             st.fanSpeed, st.cpuTemp, st.ambientTemp, app,
+             st.trayState, st.avPack, st.picVersion, st.xboxVersion, st.encoder,
+             st.videoWidth, st.videoHeight, res);
+    events.send(s_frame, "status", ++s_eventId);
+}
+
+static void pushPerf() {
+    const uint32_t avg = s_loopCount ? (s_loopSumUs / s_loopCount) : 0;
+    snprintf(s_frame, sizeof(s_frame),
+             "{\"up\":%lu,\"heap\":%u,\"heap_min\":%u,\"psram\":%u,"
+             "\"loop_avg_us\":%u,\"loop_max_us\":%u,\"rssi\":%d,\"viewers\":%u,\"id\":%u,\"peers\":%u}",
+             (unsigned long)(millis() / 1000),
+             (unsigned)ESP.getFreeHeap(),
+             (unsigned)ESP.getMinFreeHeap(),
+             (unsigned)heap_caps_get_free_size(MALLOC_CAP_SPIRAM),
+             (unsigned)avg, (unsigned)s_loopMaxUs,
+             WiFi.isConnected() ? (int)WiFi.RSSI() : 0,
+             (unsigned)events.count(),
+             (unsigned)Detect::getId(),
+             (unsigned)Detect::getStats().livePeers);
+    events.send(s_frame, "perf", ++s_eventId);
+
+    s_loopSumUs = 0;
+    s_loopCount = 0;
+    s_loopMaxUs = 0;
+}
+
+namespace Telemetry {
+
+void begin(AsyncWebServer &server) {
+    events.onConnect([](AsyncEventSourceClient *client) {
+        // Send the latest known status on the next loop() so a new page isn't blank.
+        // Runs on the AsyncTCP task: only raise a flag, loop() owns s_lastStatusSeq.
+        s_resendStatus.store(true, std::memory_order_relaxed);
+    });
+    server.addHandler(&events);
+
+    server.on("/live", HTTP_GET, [](AsyncWebServerRequest *request) {
+        request->send_P(200, "text/html", LIVE_PAGE);
+    });
+
+    s_lastLoopUs = micros();
+    Serial.println("[Telemetry] /events and /live registered");
+}
+
+void loop() {
+    TRACE_SCOPE("Telemetry::loop");
+    const uint32_t nowUs = micros();
+    const uint32_t period = nowUs - s_lastLoopUs;
+    s_lastLoopUs = nowUs;
+    s_loopSumUs += period;
+    s_loopCount++;
+    if (period > s_loopMaxUs) s_loopMaxUs = period;
+
+    if (events.count() == 0) {
+        // Nobody listening: keep counters fresh but never serialize
+        s_lastStatusSeq = UDPDetect::getSeq();
+        return;
+    }
+
+    const uint32_t seq = UDPDetect::getSeq();
+    const bool resend = s_resendStatus.exchange(false, std::memory_order_relaxed);
+    if (resend || seq != s_lastStatusSeq) {
+        s_lastStatusSeq = seq;
+        pushStatus(UDPDetect::getLatest());
+    }
+
+    const unsigned long now = millis();
+    if (now - s_lastPerf >= TELEMETRY_PERF_INTERVAL_MS) {
+        s_lastPerf = now;
+        if (events.avgPacketsWaiting() < TELEMETRY_MAX_BACKLOG) pushPerf();
+    }
+}
+
+size_t clientCount() { return events.count(); }
+
+} // namespace Telemetry
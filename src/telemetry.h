@@ -0,0 +1,15 @@
+// telemetry.h
+#pragma once
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+
+namespace Telemetry {
+    // Registers /events (Server-Sent Events) and the /live dashboard page
+    void begin(AsyncWebServer &server);
+
+    // Call once per loop(); pushes status changes and periodic perf counters
+    void loop();
+
+    // Number of connected /events viewers
+    size_t clientCount();
+}
@@ -0,0 +1,195 @@
+// thumbs.cpp
+
+#include "thumbs.h"
+#include "imagedisplay.h"
+#include "webcache.h"
+#include <FFat.h>
+#include <LovyanGFX.hpp>
+#include <AnimatedGIF.h>
+#include <esp_heap_caps.h>
+#include "trace.h"
+
+#define THUMB_DIR          "/thumb"
+#define THUMB_SRC_SIZE     240        // gallery images are 240x240 (script/gif_convert.py)
+#define THUMB_QUEUE_LEN    16
+#define THUMB_PATH_MAX     96
+
+// Don't stall the slideshow: render between items, or at least this far apart
+#ifndef THUMB_MIN_GAP_MS
+#define THUMB_MIN_GAP_MS   250
+#endif
+#ifndef THUMB_MAX_WAIT_MS
+#define THUMB_MAX_WAIT_MS  5000
+#endif
+
+namespace Thumbs {
+
+static char     s_queue[THUMB_QUEUE_LEN][THUMB_PATH_MAX];
+static uint8_t  s_head = 0, s_count = 0;
+static portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED;   // guards s_queue
+
+static uint32_t s_last_ms = 0;
+static size_t   s_backfill = 0;       // next index into jpg list, then gif list
+static bool     s_backfill_done = false;
+
+String pathFor(const String &imagePath) {
+  String p = imagePath;
+  if (p.startsWith("/")) p.remove(0, 1);
+  p.replace("/", "_");
+  return String(THUMB_DIR "/") + p + ".png";
+}
+
+void queue(const String &imagePath) {
+  if (imagePath.length() >= THUMB_PATH_MAX) return;
+  portENTER_CRITICAL(&s_mux);
+  if (s_count < THUMB_QUEUE_LEN) {
+    strcpy(s_queue[(s_head + s_count) % THUMB_QUEUE_LEN], imagePath.c_str());
+    s_count++;
+  }
+  portEXIT_CRITICAL(&s_mux);
+  // A full queue is fine: the backfill pass picks the image up later
+}
+
+void remove(const String &imagePath) {
+  const String t = pathFor(imagePath);
+  if (FFat.exists(t)) FFat.remove(t);
+  WebCache::invalidate(t);
+}
+
+static bool pop(String &out) {
+  char buf[THUMB_PATH_MAX];
+  bool ok = false;
+  portENTER_CRITICAL(&s_mux);
+  if (s_count) {
+    strcpy(buf, s_queue[s_head]);
+    s_head = (s_head + 1) % THUMB_QUEUE_LEN;
+    s_count--;
+    ok = true;
+  }
+  portEXIT_CRITICAL(&s_mux);
+  if (ok) out = buf;
+  return ok;
+}
+
+static uint8_t *load_file(const String &path, size_t &len) {
+  File f = FFat.open(path, "r");
+  if (!f || f.size() == 0) return nullptr;
+  len = f.size();
+  uint8_t *buf = (uint8_t *)heap_caps_malloc(len, MALLOC_CAP_SPIRAM);
+  if (buf && (size_t)f.read(buf, len) != len) { heap_caps_free(buf); buf = nullptr; }
+  f.close();
+  return buf;
+}
+
+// ---- GIF first frame, nearest-neighbour downscale into the sprite ----
+struct GifCtx {
+  LGFX_Sprite *spr;
+  int canvasW, canvasH;
+  int lastRow;
+};
+
+static void gif_thumb_draw(GIFDRAW *pDraw) {
+  GifCtx *c = (GifCtx *)pDraw->pUser;
+  if (!c || !pDraw->pPalette || !pDraw->pPixels || c->canvasW <= 0 || c->canvasH <= 0) return;
+  const int srcY = pDraw->iY + pDraw->y;
+  const int dy = srcY * THUMB_SIZE / c->canvasH;
+  if (dy == c->lastRow || dy >= THUMB_SIZE) return;   // one source line per thumb row
+  c->lastRow = dy;
+
+  uint16_t line[THUMB_SIZE];
+  int x0 = THUMB_SIZE, x1 = 0;
+  for (int dx = 0; dx < THUMB_SIZE; ++dx) {
+    const int sx = dx * c->canvasW / THUMB_SIZE - pDraw->iX;
+    if (sx < 0 || sx >= pDraw->iWidth) continue;
+    line[dx] = pDraw->pPalette[pDraw->pPixels[sx]];
+    if (dx < x0) x0 = dx;
+    x1 = dx + 1;
+  }
+  if (x1 > x0) c->spr->pushImage(x0, dy, x1 - x0, 1, line + x0);
+}
+
+static bool render(const String &imagePath, LGFX_Sprite &spr) {
+  size_t len = 0;
+  uint8_t *buf = load_file(imagePath, len);
+  if (!buf) return false;
+
+  String lower = imagePath;
+  lower.toLowerCase();
+  bool ok = false;
+  if (lower.endsWith(".jpg") || lower.endsWith(".jpeg")) {
+    const float scale = (float)THUMB_SIZE / THUMB_SRC_SIZE;
+    ok = spr.drawJpg(buf, len, 0, 0, THUMB_SIZE, THUMB_SIZE, 0, 0, scale, scale);
+  } else if (lower.endsWith(".gif")) {
+    AnimatedGIF *gif = new AnimatedGIF();
+    gif->begin(GIF_PALETTE_RGB565_BE);
+    if (gif->open(buf, (int)len, gif_thumb_draw)) {
+      GifCtx ctx = { &spr, gif->getCanvasWidth(), gif->getCanvasHeight(), -1 };
+      ok = gif->playFrame(false, nullptr, &ctx) >= 0;
+      gif->close();
+    }
+    delete gif;
+  }
+  heap_caps_free(buf);
+  return ok;
+}
+
+static void make(const String &imagePath) {
+  if (!FFat.exists(imagePath)) return;
+  if (!FFat.exists(THUMB_DIR)) FFat.mkdir(THUMB_DIR);
+
+  LGFX_Sprite spr;
+  spr.setColorDepth(16);
+  spr.setPsram(true);
+  if (!spr.createSprite(THUMB_SIZE, THUMB_SIZE)) return;
+  spr.fillScreen(TFT_BLACK);
+
+  const uint32_t t0 = millis();
+  if (render(imagePath, spr)) {
+    size_t pngLen = 0;
+    void *png = spr.createPng(&pngLen);
+    if (png) {
+      const String out = pathFor(imagePath);
+      File f = FFat.open(out, FILE_WRITE);
+      if (f) {
+        f.write((const uint8_t *)png, pngLen);
+        f.close();
+        WebCache::invalidate(out);
+        Serial.printf("[Thumbs] %s (%u bytes, %lu ms)\n", out.c_str(), (unsigned)pngLen,
+                      (unsigned long)(millis() - t0));
+      }
+      free(png);
+    }
+  } else {
+    Serial.printf("[Thumbs] Could not decode %s\n", imagePath.c_str());
+  }
+  spr.deleteSprite();
+}
+
+// One existence check per call until every gallery image has a thumbnail
+static bool next_missing(String &out) {
+  if (s_backfill_done) return false;
+  const std::vector<String> &jpgs = ImageDisplay::getJpgList();
+  const std::vector<String> &gifs = ImageDisplay::getGifList();
+  while (s_backfill < jpgs.size() + gifs.size()) {
+    const String &p = s_backfill < jpgs.size() ? jpgs[s_backfill] : gifs[s_backfill - jpgs.size()];
+    s_backfill++;
+    if (!FFat.exists(pathFor(p))) { out = p; return true; }
+    return false;
+  }
+  s_backfill_done = true;
+  return false;
+}
+
+void loop() {
+  TRACE_SCOPE("Thumbs::loop");
+  const uint32_t now = millis();
+  if (now - s_last_ms < THUMB_MIN_GAP_MS) return;
+  if (!ImageDisplay::isDone() && now - s_last_ms < THUMB_MAX_WAIT_MS) return;
+
+  String path;
+  if (!pop(path) && !next_missing(path)) return;
+  make(path);
+  s_last_ms = millis();
+}
+
+} // namespace Thumbs
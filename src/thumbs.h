@@ -0,0 +1,28 @@
+// thumbs.h
+//
+// Gallery thumbnails: THUMB_SIZE px PNGs in the hidden /thumb folder, one per
+// /jpg and /gif image (GIFs: first frame). Uploads queue their image; loop()
+// renders one thumbnail at a time off-screen (sprite) between slideshow items,
+// and backfills any image that has none.
+
+#pragma once
+#include <Arduino.h>
+
+#ifndef THUMB_SIZE
+#define THUMB_SIZE 80
+#endif
+
+namespace Thumbs {
+
+  // Any task: render a thumbnail for this image soon (e.g. after an upload)
+  void queue(const String &imagePath);
+
+  // Any task: drop the thumbnail of a deleted image
+  void remove(const String &imagePath);
+
+  // "/jpg/a.jpg" -> "/thumb/jpg_a.jpg.png"
+  String pathFor(const String &imagePath);
+
+  // Render loop only
+  void loop();
+}
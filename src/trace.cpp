@@ -0,0 +1,187 @@
+// trace.cpp
+
+#include "trace.h"
+#include <atomic>
+#include <memory>
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+
+#define TRACE_CORES   2
+#define TRACE_ANCHORS 8                      // ring of cycle -> us anchors per core
+#define TRACE_ANCHOR_CYCLES (1UL << 30)      // re-anchor well before CCOUNT wraps (~4.5 s at 240 MHz)
+#define TRACE_ANCHOR_US     4000000LL        // ...and by wall time: an idle core may have wrapped
+
+namespace Trace {
+
+#if TRACE_ENABLED
+
+struct Event {
+  const char *name;
+  uint32_t    cycles;
+  void       *task;
+  uint16_t    epoch;                         // anchor this event is relative to
+  char        phase;                         // 'B' / 'E'; 0 = slot never written
+  uint8_t     pad;
+};
+
+struct Anchor {
+  uint32_t cycles;
+  int64_t  us;
+  uint16_t epoch;
+};
+
+// One writer core per ring. Tasks sharing a core reserve slots with fetch_add,
+// so preemption between them never tears an event.
+struct Ring {
+  Event                *ev = nullptr;
+  std::atomic<uint32_t> head{0};
+  Anchor                anchors[TRACE_ANCHORS];
+  uint16_t              epoch = 0;
+  bool                  anchored = false;
+};
+
+static Ring s_ring[TRACE_CORES];
+static std::atomic<bool> s_paused{false};        // set while /api/trace streams
+static portMUX_TYPE s_anchor_mux = portMUX_INITIALIZER_UNLOCKED;
+
+// The cycle delta alone can't tell: after 2^32 idle cycles it has wrapped and
+// looks small again, so the anchor's age in microseconds is checked as well
+static inline bool stale(const Ring &r, uint32_t cycles, int64_t us) {
+  const Anchor &a = r.anchors[r.epoch % TRACE_ANCHORS];
+  return !r.anchored || cycles - a.cycles > TRACE_ANCHOR_CYCLES || us - a.us > TRACE_ANCHOR_US;
+}
+
+static void anchor(Ring &r, uint32_t cycles, int64_t us) {
+  portENTER_CRITICAL(&s_anchor_mux);
+  if (stale(r, cycles, us)) {
+    if (r.anchored) r.epoch++;
+    r.anchors[r.epoch % TRACE_ANCHORS] = {cycles, us, r.epoch};
+    r.anchored = true;
+  }
+  portEXIT_CRITICAL(&s_anchor_mux);
+}
+
+void record(const char *name, char phase) {
+  const uint32_t cycles = ESP.getCycleCount();
+  const int64_t us = esp_timer_get_time();
+  Ring &r = s_ring[xPortGetCoreID()];
+  if (!r.ev || s_paused.load(std::memory_order_relaxed)) return;
+  if (stale(r, cycles, us)) anchor(r, cycles, us);
+  Event &e = r.ev[r.head.fetch_add(1, std::memory_order_relaxed) % TRACE_EVENTS];
+  e.name   = name;
+  e.cycles = cycles;
+  e.task   = xTaskGetCurrentTaskHandle();
+  e.epoch  = r.epoch;
+  e.phase  = phase;
+}
+
+// Streaming state for one /api/trace response
+struct Dump {
+  uint8_t  core = 0;
+  uint32_t pos = 0, end = 0;                 // head-relative range of this core
+  uint32_t mhz = 240;
+  bool     first = true, started = false, done = false;
+};
+
+static void dump_seek(Dump &d) {
+  while (d.core < TRACE_CORES) {
+    Ring &r = s_ring[d.core];
+    const uint32_t head = r.head.load();
+    d.end = head;
+    d.pos = head > TRACE_EVENTS ? head - TRACE_EVENTS : 0;
+    if (r.ev && d.pos < d.end) return;
+    d.core++;
+  }
+}
+
+// One event as JSON into out; 0 if the event is skipped (stale anchor)
+static int dump_event(const Dump &d, const Event &e, char *out, size_t cap) {
+  const Ring &r = s_ring[d.core];
+  const Anchor &a = r.anchors[e.epoch % TRACE_ANCHORS];
+  if (!e.phase || !e.name || a.epoch != e.epoch) return 0;
+  const uint64_t ns = (uint64_t)(uint32_t)(e.cycles - a.cycles) * 1000 / d.mhz;
+  const uint64_t us = (uint64_t)a.us + ns / 1000;
+  return snprintf(out, cap,
+                  "%s{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%llu.%03u,\"pid\":%u,\"tid\":%lu}",
+                  d.first ? "" : ",", e.name, e.phase, (unsigned long long)us,
+                  (unsigned)(ns % 1000), d.core, (unsigned long)(uintptr_t)e.task);
+}
+
+static size_t dump_fill(Dump &d, uint8_t *buf, size_t maxLen) {
+  char *out = (char *)buf;
+  size_t n = 0;
+  if (!d.started) {
+    n += snprintf(out, maxLen, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    d.started = true;
+    dump_seek(d);
+  }
+  char line[160];
+  while (d.core < TRACE_CORES) {
+    if (d.pos >= d.end) {
+      d.core++;
+      dump_seek(d);
+      continue;
+    }
+    const int len = dump_event(d, s_ring[d.core].ev[d.pos % TRACE_EVENTS], line, sizeof(line));
+    if (len > 0) {
+      if (n + len > maxLen) return n;      // next chunk
+      memcpy(out + n, line, len);
+      n += len;
+      d.first = false;
+    }
+    d.pos++;
+  }
+  if (!d.done) {
+    if (n + 2 > maxLen) return n;
+    memcpy(out + n, "]}", 2);
+    n += 2;
+    d.done = true;
+    s_paused = false;
+  }
+  return n;
+}
+
+void begin(AsyncWebServer &server) {
+  for (int c = 0; c < TRACE_CORES; c++) {
+    s_ring[c].ev = (Event *)heap_caps_calloc(TRACE_EVENTS, sizeof(Event), MALLOC_CAP_SPIRAM);
+  }
+  if (!s_ring[0].ev || !s_ring[1].ev) {
+    Serial.println("[Trace] PSRAM alloc failed, tracing off");
+    for (int c = 0; c < TRACE_CORES; c++) { heap_caps_free(s_ring[c].ev); s_ring[c].ev = nullptr; }
+  } else {
+    Serial.printf("[Trace] %u events/core (%u KB PSRAM)\n", (unsigned)TRACE_EVENTS,
+                  (unsigned)(TRACE_CORES * TRACE_EVENTS * sizeof(Event) / 1024));
+  }
+
+  server.on("/api/trace", HTTP_GET, [](AsyncWebServerRequest *request) {
+    if (request->hasArg("clear")) {
+      for (int c = 0; c < TRACE_CORES; c++) s_ring[c].head = 0;
+      request->send(200, "application/json", "{\"cleared\":true}");
+      return;
+    }
+    // Freeze the rings while they stream; recording resumes at the end
+    s_paused = true;
+    auto d = std::make_shared<Dump>();
+    d->mhz = getCpuFrequencyMhz();
+    AsyncWebServerResponse *r = request->beginChunkedResponse("application/json",
+        [d](uint8_t *buf, size_t maxLen, size_t) -> size_t { return dump_fill(*d, buf, maxLen); });
+    r->addHeader("Content-Disposition", "attachment; filename=trace.json");
+    r->addHeader("Cache-Control", "no-store");
+    request->onDisconnect([]() { s_paused = false; });
+    request->send(r);
+  });
+}
+
+#else // !TRACE_ENABLED
+
+void record(const char *, char) {}
+
+void begin(AsyncWebServer &server) {
+  server.on("/api/trace", HTTP_GET, [](AsyncWebServerRequest *request) {
+    request->send(501, "text/plain", "Built without TRACE_ENABLED");
+  });
+}
+
+#endif
+
+} // namespace Trace
@@ -0,0 +1,46 @@
+// trace.h
+//
+// Hot-path span recorder. TRACE_SCOPE("name") (or TRACE_BEGIN/TRACE_END pairs)
+// stamps ESP.getCycleCount() into a per-core ring in PSRAM; GET /api/trace
+// returns the rings as Chrome Trace Event JSON (chrome://tracing, Perfetto).
+//
+// Built with TRACE_ENABLED 0 (the default) every macro compiles to nothing and
+// /api/trace answers 501. Names must be string literals (only the pointer is kept).
+
+#pragma once
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+
+#ifndef TRACE_ENABLED
+#define TRACE_ENABLED 0
+#endif
+#ifndef TRACE_EVENTS
+#define TRACE_EVENTS 4096            // per core, 16 bytes each
+#endif
+
+namespace Trace {
+
+  // Allocate the rings and register GET /api/trace (?clear=1 empties them)
+  void begin(AsyncWebServer &server);
+
+  // Any task, any core; never blocks. Prefer the macros.
+  void record(const char *name, char phase);
+
+  struct Scope {
+    const char *name;
+    explicit Scope(const char *n) : name(n) { record(n, 'B'); }
+    ~Scope() { record(name, 'E'); }
+  };
+}
+
+#if TRACE_ENABLED
+#define TRACE_CAT2(a, b) a##b
+#define TRACE_CAT(a, b)  TRACE_CAT2(a, b)
+#define TRACE_SCOPE(name) Trace::Scope TRACE_CAT(_trace_, __LINE__)(name)
+#define TRACE_BEGIN(name) Trace::record(name, 'B')
+#define TRACE_END(name)   Trace::record(name, 'E')
+#else
+#define TRACE_SCOPE(name) do {} while (0)
+#define TRACE_BEGIN(name) do {} while (0)
+#define TRACE_END(name)   do {} while (0)
+#endif
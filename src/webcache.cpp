@@ -0,0 +1,316 @@
+// webcache.cpp
+
+#include "webcache.h"
+#include "trace.h"
+#include <FFat.h>
+#include <esp_rom_crc.h>
+#include <algorithm>
+#if CONFIG_IDF_TARGET_ESP32S3
+#include "esp32s3/rom/miniz.h"
+#else
+#include "esp32/rom/miniz.h"
+#endif
+
+// Files up to this size get a content-hash ETag; larger ones size/mtime
+#ifndef WEBCACHE_HASH_MAX
+#define WEBCACHE_HASH_MAX     (256 * 1024)
+#endif
+#ifndef WEBCACHE_ENTRIES
+#define WEBCACHE_ENTRIES      32
+#endif
+
+#define CACHE_IMMUTABLE  "public, max-age=31536000, immutable"
+#define CACHE_REVALIDATE "no-cache"
+
+namespace WebCache {
+
+struct Entry {
+  uint32_t pathCrc;   // 0 = free
+  uint32_t size;
+  time_t   mtime;
+  uint32_t etag;
+  bool     weak;
+};
+
+static Entry   s_tab[WEBCACHE_ENTRIES];
+static uint8_t s_next = 0;     // round-robin victim
+
+static uint32_t path_crc(const String &path) {
+  const uint32_t c = esp_rom_crc32_le(0, (const uint8_t *)path.c_str(), path.length());
+  return c ? c : 1;
+}
+
+static String fmt_etag(const Entry &e) {
+  char buf[32];
+  if (e.weak) snprintf(buf, sizeof(buf), "W/\"%lx-%lx\"", (unsigned long)e.size, (unsigned long)e.mtime);
+  else        snprintf(buf, sizeof(buf), "\"%08lx\"", (unsigned long)e.etag);
+  return String(buf);
+}
+
+// ETag for an open file; hashes the content once per (path, size, mtime)
+static const Entry *lookup(const String &path, File &f, bool weak) {
+  if (weak) {
+    static Entry w;                               // AsyncTCP task only
+    w.size  = f.size();
+    w.mtime = f.getLastWrite();
+    w.weak  = true;
+    return &w;
+  }
+  const uint32_t pc = path_crc(path);
+  const uint32_t size = f.size();
+  const time_t mtime = f.getLastWrite();
+
+  Entry *slot = nullptr;
+  for (Entry &e : s_tab) {
+    if (e.pathCrc != pc) continue;
+    if (e.size == size && e.mtime == mtime) return &e;
+    slot = &e;                                    // stale: reuse its slot
+    break;
+  }
+  if (!slot) {
+    slot = &s_tab[s_next];
+    s_next = (s_next + 1) % WEBCACHE_ENTRIES;
+  }
+
+  slot->pathCrc = pc;
+  slot->size    = size;
+  slot->mtime   = mtime;
+  slot->weak    = size > WEBCACHE_HASH_MAX;
+  slot->etag    = 0;
+  if (!slot->weak) {
+    uint8_t buf[512];
+    uint32_t crc = 0;
+    size_t n;
+    while ((n = f.read(buf, sizeof(buf))) > 0) crc = esp_rom_crc32_le(crc, buf, n);
+    f.seek(0);
+    slot->etag = crc;
+  }
+  return slot;
+}
+
+static bool matches(AsyncWebServerRequest *request, const String &etag) {
+  if (!request->hasHeader("If-None-Match")) return false;
+  const String inm = request->header("If-None-Match");
+  return inm == "*" || inm.indexOf(etag) >= 0;
+}
+
+static bool accepts_gzip(AsyncWebServerRequest *request) {
+  return request->hasHeader("Accept-Encoding") && request->header("Accept-Encoding").indexOf("gzip") >= 0;
+}
+
+static void send_304(AsyncWebServerRequest *request, const String &etag, const char *cacheControl) {
+  AsyncWebServerResponse *r = request->beginResponse(304);
+  r->addHeader("ETag", etag);
+  r->addHeader("Cache-Control", cacheControl);
+  request->send(r);
+}
+
+const char *contentTypeFor(const String &path) {
+  if (path.endsWith(".jpg") || path.endsWith(".jpeg")) return "image/jpeg";
+  if (path.endsWith(".gif"))  return "image/gif";
+  if (path.endsWith(".png"))  return "image/png";
+  if (path.endsWith(".css"))  return "text/css";
+  if (path.endsWith(".js"))   return "application/javascript";
+  if (path.endsWith(".html")) return "text/html";
+  if (path.endsWith(".json")) return "application/json";
+  return "application/octet-stream";
+}
+
+// Single "bytes=a-b" / "a-" / "-n" range. 1 = ok, 0 = none/unsupported
+// (serve everything), -1 = unsatisfiable.
+static int parse_range(const String &hdr, size_t size, size_t &start, size_t &end) {
+  if (!hdr.startsWith("bytes=") || hdr.indexOf(',') >= 0) return 0;
+  const int dash = hdr.indexOf('-');
+  if (dash < 0) return 0;
+  const String a = hdr.substring(6, dash);
+  const String b = hdr.substring(dash + 1);
+  if (a.length() == 0) {                          // suffix: last n bytes
+    const size_t n = strtoul(b.c_str(), nullptr, 10);
+    if (n == 0 || size == 0) return -1;
+    start = n >= size ? 0 : size - n;
+    end   = size - 1;
+    return 1;
+  }
+  start = strtoul(a.c_str(), nullptr, 10);
+  end   = b.length() ? strtoul(b.c_str(), nullptr, 10) : size - 1;
+  if (start >= size || end < start) return -1;
+  if (end >= size) end = size - 1;
+  return 1;
+}
+
+static void send_range(AsyncWebServerRequest *request, File &f, const String &contentType,
+                       const String &etag, const char *cc) {
+  const size_t size = f.size();
+  size_t start = 0, end = 0;
+  const int rc = parse_range(request->header("Range"), size, start, end);
+  if (rc < 0) {
+    AsyncWebServerResponse *r = request->beginResponse(416);
+    r->addHeader("Content-Range", "bytes */" + String((unsigned long)size));
+    request->send(r);
+    return;
+  }
+  if (rc == 0) { start = 0; end = size - 1; }
+
+  // The File copy in the filler keeps it open until the response is done
+  const size_t len = end - start + 1;
+  AsyncWebServerResponse *r = request->beginResponse(contentType, len,
+      [f, start, len](uint8_t *buf, size_t maxLen, size_t index) mutable -> size_t {
+        if (index >= len) return 0;
+        if (f.position() != start + index) f.seek(start + index);
+        return f.read(buf, std::min(maxLen, len - index));
+      });
+  if (rc > 0) {
+    r->setCode(206);
+    char cr[64];
+    snprintf(cr, sizeof(cr), "bytes %lu-%lu/%lu", (unsigned long)start, (unsigned long)end, (unsigned long)size);
+    r->addHeader("Content-Range", cr);
+  }
+  r->addHeader("Accept-Ranges", "bytes");
+  r->addHeader("ETag", etag);
+  r->addHeader("Cache-Control", cc);
+  request->send(r);
+}
+
+void sendFile(AsyncWebServerRequest *request, const String &path, const String &contentType, bool weak) {
+  TRACE_SCOPE("WebCache::sendFile");
+  const bool immutable = request->hasParam("v");
+  const char *cc = immutable ? CACHE_IMMUTABLE : CACHE_REVALIDATE;
+  const bool ranged = request->hasHeader("Range");
+
+  String servePath = path;
+  bool gz = false;
+  if (!ranged && accepts_gzip(request) && FFat.exists(path + ".gz")) {
+    servePath = path + ".gz";
+    gz = true;
+  }
+
+  File f = FFat.open(servePath);
+  if (!f || f.isDirectory()) {
+    request->send(404, "text/plain", "File not found");
+    return;
+  }
+
+  const String etag = fmt_etag(*lookup(servePath, f, weak));
+  if (matches(request, etag)) {
+    f.close();
+    send_304(request, etag, cc);
+    return;
+  }
+
+  // Range (resumed download); If-Range with a stale tag means "send it all"
+  if (ranged && (!request->hasHeader("If-Range") || request->header("If-Range") == etag)) {
+    send_range(request, f, contentType, etag, cc);
+    return;
+  }
+
+  AsyncWebServerResponse *r = request->beginResponse(f, contentType, false);
+  if (!gz) r->addHeader("Accept-Ranges", "bytes");
+  r->addHeader("ETag", etag);
+  r->addHeader("Cache-Control", cc);
+  if (gz) r->addHeader("Content-Encoding", "gzip");
+  r->addHeader("Vary", "Accept-Encoding");
+  request->send(r);
+}
+
+void serveDir(AsyncWebServer &server, const char *prefix, bool weak) {
+  String route = prefix;
+  if (!route.endsWith("/")) route += "/";
+  route += "*";
+  server.on(route.c_str(), HTTP_GET, [weak](AsyncWebServerRequest *request) {
+    const String path = request->url();
+    if (path.indexOf("..") >= 0) { request->send(400, "text/plain", "Bad path"); return; }
+    sendFile(request, path, contentTypeFor(path), weak);
+  });
+}
+
+String url(const String &path, bool weak) {
+  File f = FFat.open(path);
+  if (!f) return path;
+  const String etag = fmt_etag(*lookup(path, f, weak));
+  f.close();
+  // strip quotes / W/ so the tag is a plain query value
+  String v;
+  for (size_t i = 0; i < etag.length(); ++i) {
+    const char c = etag[i];
+    if (isxdigit((unsigned char)c) || c == '-') v += c;
+  }
+  return path + "?v=" + v;
+}
+
+void invalidate(const String &path) {
+  const uint32_t pcs[2] = { path_crc(path), path_crc(path + ".gz") };
+  for (Entry &e : s_tab) {
+    if (e.pathCrc == pcs[0] || e.pathCrc == pcs[1]) e.pathCrc = 0;
+  }
+}
+
+// Clients that refuse gzip (rare) get the shell inflated into RAM
+static void send_inflated(AsyncWebServerRequest *request, const WebAsset &asset, const char *cc, const String &etag) {
+  tinfl_decompressor *inf = (tinfl_decompressor *)malloc(sizeof(tinfl_decompressor));
+  uint8_t *out = (uint8_t *)malloc(asset.rawLen + 1);
+  bool ok = false;
+  if (inf && out) {
+    tinfl_init(inf);
+    size_t inSz  = asset.gzLen - 10 - 8;      // skip gzip header / CRC32+ISIZE trailer
+    size_t outSz = asset.rawLen;
+    ok = tinfl_decompress(inf, asset.gz + 10, &inSz, out, out, &outSz,
+                          TINFL_FLAG_USING_NON_WRAPPING_OUTPUT_BUF) == TINFL_STATUS_DONE &&
+         outSz == asset.rawLen;
+  }
+  if (ok) {
+    out[asset.rawLen] = 0;                    // text shells: no embedded NULs
+    AsyncWebServerResponse *r = request->beginResponse(200, asset.type, String((const char *)out));
+    r->addHeader("ETag", etag);
+    r->addHeader("Cache-Control", cc);
+    r->addHeader("Vary", "Accept-Encoding");
+    request->send(r);
+  } else {
+    request->send(500, "text/plain", "Out of memory");
+  }
+  free(inf);
+  free(out);
+}
+
+void sendAsset(AsyncWebServerRequest *request, const WebAsset &asset) {
+  const char *cc = request->hasParam("v") ? CACHE_IMMUTABLE : CACHE_REVALIDATE;
+  char buf[16];
+  snprintf(buf, sizeof(buf), "\"%08lx\"", (unsigned long)asset.etag);
+  const String etag = buf;
+
+  if (matches(request, etag)) { send_304(request, etag, cc); return; }
+  if (!accepts_gzip(request)) { send_inflated(request, asset, cc, etag); return; }
+
+  AsyncWebServerResponse *r = request->beginResponse_P(200, asset.type, asset.gz, asset.gzLen);
+  r->addHeader("Content-Encoding", "gzip");
+  r->addHeader("ETag", etag);
+  r->addHeader("Cache-Control", cc);
+  r->addHeader("Vary", "Accept-Encoding");
+  request->send(r);
+}
+
+void serveAsset(AsyncWebServer &server, const char *route, const WebAsset &asset) {
+  const WebAsset *a = &asset;
+  server.on(route, HTTP_GET, [a](AsyncWebServerRequest *request) { sendAsset(request, *a); });
+}
+
+String assetUrl(const char *route, const WebAsset &asset) {
+  char buf[16];
+  snprintf(buf, sizeof(buf), "?v=%08lx", (unsigned long)asset.etag);
+  return String(route) + buf;
+}
+
+void sendPage(AsyncWebServerRequest *request, const String &html, const char *contentType) {
+  TRACE_SCOPE("WebCache::sendPage");
+  char buf[16];
+  snprintf(buf, sizeof(buf), "\"%08lx\"",
+           (unsigned long)esp_rom_crc32_le(0, (const uint8_t *)html.c_str(), html.length()));
+  const String etag = buf;
+  if (matches(request, etag)) { send_304(request, etag, CACHE_REVALIDATE); return; }
+
+  AsyncWebServerResponse *r = request->beginResponse(200, contentType, html);
+  r->addHeader("ETag", etag);
+  r->addHeader("Cache-Control", CACHE_REVALIDATE);
+  request->send(r);
+}
+
+} // namespace WebCache
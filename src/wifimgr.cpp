@@ -5,6 +5,9 @@
 #include <FFat.h>
 #include <DNSServer.h>
 #include <esp_wifi.h>
+#include "webcache.h"
+#include <algorithm>
+#include "trace.h"
 
 static AsyncWebServer server(80);
 namespace WiFiMgr {
@@ -16,10 +19,130 @@ static DNSServer dnsServer;
 enum class State { IDLE, CONNECTING, CONNECTED, PORTAL };
 static State state = State::PORTAL;
 
+// Fast path: the last good BSSID/channel (and lease) are kept in the "wifi"
+// namespace, so a reconnect skips the full scan. Set WIFI_FAST_STATIC to 1 to
+// also reuse the cached DHCP lease as a static config (skips DHCP; only safe
+// if the router reserves the address).
+#ifndef WIFI_FAST_TIMEOUT_MS
+#define WIFI_FAST_TIMEOUT_MS 2000
+#endif
+#ifndef WIFI_FAST_STATIC
+#define WIFI_FAST_STATIC 0
+#endif
+#ifndef WIFI_RETRY_MAX_MS
+#define WIFI_RETRY_MAX_MS 8000
+#endif
+
 static int connectAttempts = 0;
-static const int maxAttempts = 10;
+static const int maxAttempts = 6;            // ~30 s of backoff before the portal (boot only)
 static unsigned long lastAttempt = 0;
-static unsigned long retryDelay = 3000;
+static unsigned long retryDelay = 2000;      // first scan attempt; doubles up to WIFI_RETRY_MAX_MS
+static unsigned long attemptWindow = 0;
+
+// Portal network list: scanned in the background, served from cache
+#ifndef WIFI_SCAN_REFRESH_MS
+#define WIFI_SCAN_REFRESH_MS 30000
+#endif
+#ifndef WIFI_SCAN_MAX
+#define WIFI_SCAN_MAX 24
+#endif
+#define SCAN_JSON_MAX (WIFI_SCAN_MAX * 70 + 4)   // 32-char SSID, escaped
+
+// Double-banked like UDPMux: loop() fills the idle bank, then flips scanBank,
+// so /scan (AsyncTCP task) always copies a complete list without locking.
+static char scanJson[2][SCAN_JSON_MAX];
+static volatile uint8_t scanBank = 0;
+static volatile bool scanReady = false;
+static volatile bool scanWanted = false;   // a client asked before the first result
+static bool portalActive = false;
+static bool scanRunning = false;
+static unsigned long lastScan = 0;
+
+struct FastCache {
+    uint8_t  bssid[6];
+    uint8_t  channel;
+    uint32_t ip, gw, mask, dns;
+    bool     valid;
+};
+static FastCache fast = {};
+static bool fastTried = false;       // fast path already used in this connect round
+static int  scanAttempts = 0;        // full-scan attempts in this round (backoff exponent)
+static bool attemptFast = false;     // current attempt is the fast path
+static bool staticApplied = false;
+static bool reconnecting = false;    // lost link after being connected: never fall back to the portal
+static volatile uint32_t firstIpMs = 0;   // millis() of the first GOT_IP since boot
+static unsigned long roundStart = 0;
+static ConnectInfo info = {};
+
+// Collapse the raw scan to one entry per SSID (strongest BSSID), strongest first
+static void publishScan(int n) {
+    struct Net { int16_t idx; int8_t rssi; };
+    Net nets[WIFI_SCAN_MAX];
+    int count = 0;
+    for (int i = 0; i < n; ++i) {
+        String ss = WiFi.SSID(i);
+        if (!ss.length()) continue;                  // hidden
+        int8_t rssi = (int8_t)WiFi.RSSI(i);
+        int j = 0;
+        while (j < count && WiFi.SSID(nets[j].idx) != ss) ++j;
+        if (j < count) {
+            if (rssi > nets[j].rssi) nets[j] = {(int16_t)i, rssi};
+        } else if (count < WIFI_SCAN_MAX) {
+            nets[count++] = {(int16_t)i, rssi};
+        } else {
+            // Full: replace the weakest if this one is stronger
+            int w = 0;
+            for (int k = 1; k < count; ++k) if (nets[k].rssi < nets[w].rssi) w = k;
+            if (rssi > nets[w].rssi) nets[w] = {(int16_t)i, rssi};
+        }
+    }
+    std::sort(nets, nets + count, [](const Net& a, const Net& b) { return a.rssi > b.rssi; });
+
+    char *out = scanJson[scanBank ^ 1];
+    size_t len = 0;
+    out[len++] = '[';
+    for (int i = 0; i < count; ++i) {
+        String ss = WiFi.SSID(nets[i].idx);
+        if (len + ss.length() * 2 + 4 > SCAN_JSON_MAX) break;
+        if (i) out[len++] = ',';
+        out[len++] = '"';
+        for (size_t k = 0; k < ss.length(); ++k) {
+            char c = ss[k];
+            if ((uint8_t)c < 0x20) continue;
+            if (c == '"' || c == '\\') out[len++] = '\\';
+            out[len++] = c;
+        }
+        out[len++] = '"';
+    }
+    out[len++] = ']';
+    out[len] = 0;
+    scanBank ^= 1;
+    scanReady = true;
+    Serial.printf("[WiFiMgr] Scan: %d BSSIDs, %d networks\n", n, count);
+}
+
+// Drive the async scan; at most one is ever in flight
+static void scanLoop() {
+    if (scanRunning) {
+        int n = WiFi.scanComplete();
+        if (n == WIFI_SCAN_RUNNING) return;
+        scanRunning = false;
+        lastScan = millis();
+        if (n >= 0) publishScan(n);
+        WiFi.scanDelete();
+        return;
+    }
+    if (!portalActive) return;
+    bool due = scanWanted || !scanReady || millis() - lastScan > WIFI_SCAN_REFRESH_MS;
+    // A scan takes the radio off-channel: don't start one on top of a connect attempt
+    if (!due || (state == State::CONNECTING && !scanWanted)) return;
+    scanWanted = false;
+    if (WiFi.scanNetworks(true) == WIFI_SCAN_FAILED) {
+        lastScan = millis();        // try again next interval
+        return;
+    }
+    scanRunning = true;
+}
 
 static void setAPConfig() {
     WiFi.softAPConfig(
@@ -43,11 +166,98 @@ void saveCreds(const String& s, const String& p) {
     prefs.end();
 }
 
+static void loadFast() {
+    prefs.begin("wifi", true);
+    fast.valid = prefs.getBytes("bssid", fast.bssid, sizeof(fast.bssid)) == sizeof(fast.bssid);
+    fast.channel = prefs.getUChar("chan", 0);
+    fast.ip   = prefs.getULong("ip", 0);
+    fast.gw   = prefs.getULong("gw", 0);
+    fast.mask = prefs.getULong("mask", 0);
+    fast.dns  = prefs.getULong("dns", 0);
+    prefs.end();
+    if (fast.channel == 0) fast.valid = false;
+}
+
+// Persist only what changed (NVS writes wear flash)
+static void saveFast() {
+    FastCache now = {};
+    memcpy(now.bssid, WiFi.BSSID(), sizeof(now.bssid));
+    now.channel = (uint8_t)WiFi.channel();
+    now.ip   = (uint32_t)WiFi.localIP();
+    now.gw   = (uint32_t)WiFi.gatewayIP();
+    now.mask = (uint32_t)WiFi.subnetMask();
+    now.dns  = (uint32_t)WiFi.dnsIP(0);
+    now.valid = true;
+    if (fast.valid && !memcmp(now.bssid, fast.bssid, 6) && now.channel == fast.channel &&
+        now.ip == fast.ip && now.gw == fast.gw && now.mask == fast.mask && now.dns == fast.dns)
+        return;
+    prefs.begin("wifi", false);
+    prefs.putBytes("bssid", now.bssid, sizeof(now.bssid));
+    prefs.putUChar("chan", now.channel);
+    prefs.putULong("ip", now.ip);
+    prefs.putULong("gw", now.gw);
+    prefs.putULong("mask", now.mask);
+    prefs.putULong("dns", now.dns);
+    prefs.end();
+    fast = now;
+    Serial.printf("[WiFiMgr] Cached BSSID %s ch %u\n", WiFi.BSSIDstr().c_str(), now.channel);
+}
+
+static void clearFast() {
+    prefs.begin("wifi", false);
+    prefs.remove("bssid");
+    prefs.remove("chan");
+    prefs.remove("ip");
+    prefs.remove("gw");
+    prefs.remove("mask");
+    prefs.remove("dns");
+    prefs.end();
+    fast = {};
+}
+
 void clearCreds() {
     prefs.begin("wifi", false);
     prefs.remove("ssid");
     prefs.remove("pass");
     prefs.end();
+    clearFast();
+}
+
+// One connect attempt: the cached BSSID/channel first, then full scans with backoff
+static void startAttempt() {
+    WiFi.disconnect();
+    attemptFast = fast.valid && !fastTried;
+    if (attemptFast) {
+        fastTried = true;
+#if WIFI_FAST_STATIC
+        if (fast.ip && fast.gw && fast.mask) {
+            WiFi.config(IPAddress(fast.ip), IPAddress(fast.gw), IPAddress(fast.mask), IPAddress(fast.dns));
+            staticApplied = true;
+        }
+#endif
+        WiFi.begin(ssid.c_str(), password.c_str(), fast.channel, fast.bssid);
+        attemptWindow = WIFI_FAST_TIMEOUT_MS;
+    } else {
+        if (staticApplied) {
+            // Back to DHCP for scans: the cached lease may be why the fast path failed
+            WiFi.config(IPAddress((uint32_t)0), IPAddress((uint32_t)0), IPAddress((uint32_t)0));
+            staticApplied = false;
+        }
+        WiFi.begin(ssid.c_str(), password.c_str());
+        attemptWindow = std::min<unsigned long>(retryDelay << std::min(scanAttempts, 4), WIFI_RETRY_MAX_MS);
+        scanAttempts++;
+    }
+    lastAttempt = millis();
+}
+
+// Begin a connect round (boot, new credentials or a lost link)
+static void startConnecting(bool useFast) {
+    state = State::CONNECTING;
+    fastTried = !useFast;
+    connectAttempts = 0;
+    scanAttempts = 0;
+    roundStart = millis();
+    startAttempt();
 }
 
 void startPortal() {
@@ -75,88 +285,9 @@ void startPortal() {
     IPAddress apIP = WiFi.softAPIP();
     dnsServer.start(53, "*", apIP);
 
+    // Static shell (script/web/portal.html), pre-gzipped in flash
     server.on("/", HTTP_GET, [](AsyncWebServerRequest *request){
-    String page = R"rawliteral(
-<!DOCTYPE html>
-<html>
-<head>
-    <title>WiFi Setup</title>
-    <meta name="viewport" content="width=320,initial-scale=1">
-    <style>
-        body {background:#111;color:#EEE;font-family:sans-serif;}
-        .container {max-width:320px;margin:24px auto;background:#222;padding:2em;border-radius:8px;box-shadow:0 0 16px #0008;}
-        input,select,button {width:100%;box-sizing:border-box;margin:.7em 0;padding:.5em;font-size:1.1em;border-radius:5px;border:1px solid #555;}
-        .btn-primary {background:#299a2c;color:white;}
-        .btn-danger {background:#a22;color:white;}
-        .status {margin-top:1em;font-size:.95em;}
-        label {display:block;margin-top:.5em;margin-bottom:.1em;}
-    </style>
-</head>
-<body>
-    <div class="container">
-        <div style="width:100%;text-align:center;margin-bottom:1em">
-            <img src="/resource/TD.jpg" alt="Type D" style="width:128px;height:auto;display:block;margin:0 auto;">
-        </div>
-        <form id="wifiForm" onsubmit="event.preventDefault(); save();">
-            <label>WiFi Network</label>
-            <select id="ssidDropdown" onchange="document.getElementById('ssid').value=this.value" style="margin-bottom:1em;">
-                <option value="">Please select a network</option>
-            </select>
-            <input type="text" id="ssid" placeholder="SSID" required style="margin-bottom:1em;">
-            <label>Password</label>
-            <input type="password" id="pass" placeholder="WiFi Password">
-            <button type="button" onclick="save()" class="btn-primary">Connect & Save</button>
-            <button type="button" onclick="forget()" class="btn-danger">Forget WiFi</button>
-        </form>
-        <div class="status" id="status">Status: ...</div>
-    </div>
-    <script>
-        function scan() {
-            fetch('/scan').then(r => r.json()).then(list => {
-                let dropdown = document.getElementById('ssidDropdown');
-                dropdown.innerHTML = '';
-                let opt = document.createElement('option');
-                opt.value = '';
-                opt.text = 'Please select a network';
-                dropdown.appendChild(opt);
-                list.forEach(ssid => {
-                    let o = document.createElement('option');
-                    o.value = ssid;
-                    o.text = ssid;
-                    dropdown.appendChild(o);
-                });
-            });
-        }
-
-        function save() {
-            let s = document.getElementById('ssid').value.trim();
-            let p = document.getElementById('pass').value;
-            if (!s) {
-                document.getElementById('status').innerText = "Please select or enter a network.";
-                return;
-            }
-            fetch('/connect?ssid=' + encodeURIComponent(s) + '&pass=' + encodeURIComponent(p))
-                .then(r => r.text()).then(t => {
-                    document.getElementById('status').innerText = t;
-                });
-        }
-
-        function forget() {
-            fetch('/forget').then(r => r.text()).then(t => {
-                document.getElementById('status').innerText = t;
-                document.getElementById('ssid').value = '';
-                document.getElementById('pass').value = '';
-            });
-        }
-
-        window.onload = scan;
-    </script>
-</body>
-</html>
-
-    )rawliteral";
-
-        request->send(200, "text/html", page);
+        WebCache::sendAsset(request, WebAssets::PORTAL_HTML);
     });
 
     server.on("/status", HTTP_GET, [](AsyncWebServerRequest *request){
@@ -179,11 +310,11 @@ void startPortal() {
             return;
         }
         saveCreds(ss, pw);
+        clearFast();
         ssid = ss;
         password = pw;
-        state = State::CONNECTING;
-        connectAttempts = 1;
-        WiFi.begin(ssid.c_str(), password.c_str());
+        reconnecting = false;
+        startConnecting(false);
         request->send(200, "text/plain", "Connecting to: " + ssid);
     });
 
@@ -205,16 +336,14 @@ void startPortal() {
         request->send(200, "text/plain", "WiFi credentials cleared (debug).");
     });
 
+    // Cached list from scanLoop(); 202 + [] until the first scan lands
     server.on("/scan", HTTP_GET, [](AsyncWebServerRequest *request){
-        WiFi.mode(WIFI_AP_STA);
-        int n = WiFi.scanNetworks();
-        String json = "[";
-        for (int i = 0; i < n; ++i) {
-            if (i) json += ",";
-            json += "\"" + WiFi.SSID(i) + "\"";
+        if (!scanReady) {
+            scanWanted = true;
+            request->send(202, "application/json", "[]");
+            return;
         }
-        json += "]";
-        request->send(200, "application/json", json);
+        request->send(200, "application/json", String(scanJson[scanBank]));
     });
 
     auto cp = [](AsyncWebServerRequest *r){
@@ -229,53 +358,91 @@ void startPortal() {
 
     server.begin();
     state = State::PORTAL;
+    portalActive = true;
 }
 
 void stopPortal() {
     dnsServer.stop();
+    portalActive = false;
 }
 
 void tryConnect() {
     if (ssid.length() > 0) {
         WiFi.mode(WIFI_AP_STA);
         delay(100);
-        WiFi.begin(ssid.c_str(), password.c_str());
-        state = State::CONNECTING;
-        connectAttempts = 1;
-        lastAttempt = millis();
+        startConnecting(!fastTried);   // begin() may already have spent the fast path
     } else {
         startPortal();
     }
 }
 
+static void onConnected() {
+    unsigned long now = millis();
+    state = State::CONNECTED;
+    info.lastMs = now - roundStart;
+    info.fastPath = attemptFast;
+    info.attempts = connectAttempts + 1;
+    if (reconnecting) info.reconnects++;
+    else if (!info.bootMs) info.bootMs = firstIpMs ? firstIpMs : now;
+    reconnecting = false;
+    saveFast();
+}
+
+// Stamped from the WiFi event task, so it is exact even while setup() blocks
+static void onGotIp(arduino_event_id_t) {
+    if (!firstIpMs) firstIpMs = millis();
+}
+
 void begin() {
     loadCreds();
+    loadFast();
+    WiFi.setAutoReconnect(false);   // loop() reconnects, using the fast path
+    WiFi.onEvent(onGotIp, ARDUINO_EVENT_WIFI_STA_GOT_IP);
+    if (ssid.length() > 0 && fast.valid) {
+        // Known AP: join it without the portal, whose softAP would pin the
+        // radio to channel 1. Returns at once; the association runs in the
+        // WiFi task and loop() opens the portal if it fails.
+        WiFi.mode(WIFI_STA);
+        startConnecting(true);
+        return;
+    }
     startPortal();
     if (ssid.length() > 0)
         tryConnect();
 }
 
 void loop() {
+    TRACE_SCOPE("WiFiMgr::loop");
     dnsServer.processNextRequest();
+    scanLoop();
     if (state == State::CONNECTING) {
         if (WiFi.status() == WL_CONNECTED) {
-            state = State::CONNECTED;
-            dnsServer.stop();
+            onConnected();
+            stopPortal();
             WiFi.softAPdisconnect(true);
-            Serial.println("[WiFiMgr] WiFi connected.");
+            Serial.printf("[WiFiMgr] WiFi connected in %lu ms (%s, %u attempts).\n",
+                          info.lastMs, info.fastPath ? "fast" : "scan", info.attempts);
             Serial.print("[WiFiMgr] IP Address: ");
             Serial.println(WiFi.localIP());
-        } else if (millis() - lastAttempt > retryDelay) {
+        } else if (millis() - lastAttempt > attemptWindow) {
             connectAttempts++;
-            if (connectAttempts >= maxAttempts) {
+            if (attemptFast && !portalActive && !reconnecting) {
+                // Boot fast path failed: the normal portal + scan flow
+                Serial.println("[WiFiMgr] Fast connect failed, scanning.");
+                startPortal();
+                tryConnect();
+            } else if (connectAttempts >= maxAttempts && !reconnecting) {
                 state = State::PORTAL;
                 startPortal();
             } else {
-                WiFi.disconnect();
-                WiFi.begin(ssid.c_str(), password.c_str());
-                lastAttempt = millis();
+                startAttempt();
             }
         }
+    } else if (state == State::CONNECTED && WiFi.status() != WL_CONNECTED) {
+        // AP blip: rejoin the same BSSID first, keep retrying without the portal
+        Serial.println("[WiFiMgr] WiFi lost, reconnecting.");
+        reconnecting = true;
+        startConnecting(true);
     }
 }
 
@@ -297,10 +464,18 @@ void forgetWiFiFromSerial() {
     startPortal();
 }
 
+bool isPortalActive() {
+    return portalActive;
+}
+
 bool isConnected() {
     return WiFi.status() == WL_CONNECTED;
 }
 
+ConnectInfo getConnectInfo() {
+    return info;
+}
+
 String getStatus() {
     if (isConnected()) return "Connected to: " + ssid;
     if (state == State::CONNECTING) return "Connecting to: " + ssid;
@@ -2,6 +2,7 @@
 #include <FFat.h>
 #include "disp_cfg.h"
 #include <esp_heap_caps.h>   // for heap_caps_malloc/free
+#include "trace.h"
 
 static void drawShadowedText(LGFX* tft, const String& text, int x, int y,
                              uint16_t color, uint16_t shadow, int font) {
@@ -53,6 +54,7 @@ static uint32_t s_lastFlip = 0;
 static bool s_showPrimary = true;
 
 void show(LGFX* tft, const XboxStatus& packet) {
+    TRACE_SCOPE("xbox_status::show");
     // flip page if interval elapsed
     uint32_t now = millis();
     if (now - s_lastFlip >= PAGE_MS) {
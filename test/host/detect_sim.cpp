@@ -0,0 +1,220 @@
+// detect_sim.cpp
+//
+// Runs N Detect::Election instances against one virtual clock and a
+// loopback "LAN" that delivers every detect broadcast to all other nodes
+// after 1-3 ms (optionally dropping some). Each node is polled like
+// Detect::loop(): up to four datagrams, then one step().
+//
+// Passes when every node ends up ASSIGNED with a unique ID (never the
+// reserved EXP ID) and keeps it until the end of the run. Reports the
+// convergence time and packets per node, both while electing and in the
+// steady state, so the beacon budget can be checked for large fleets.
+//
+//   detect_sim --nodes 8 --spread 5000 --loss 50 --seed 7 --run 60000
+
+#include "detect_elect.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Packet {
+  uint32_t at;
+  std::string msg;
+};
+
+struct Node {
+  int index = 0;
+  uint8_t mac[6] = {0};
+  uint32_t bootAt = 0;
+  bool booted = false;
+  std::deque<Packet> inbox;
+  Detect::Election election;
+  bool lastAssigned = false;
+  uint8_t lastId = 0;
+  uint32_t tx = 0;          // datagrams sent, detect + status
+  uint32_t txAtSettle = 0;  // tx when the fleet last changed an ID
+};
+
+uint32_t g_now = 0;
+uint32_t g_rng = 12345;
+int g_lossPermille = 0;
+bool g_verbose = false;
+std::vector<Node> g_nodes;
+
+uint32_t simRand(uint32_t n) {
+  g_rng ^= g_rng << 13;
+  g_rng ^= g_rng >> 17;
+  g_rng ^= g_rng << 5;
+  return n ? g_rng % n : 0;
+}
+
+uint32_t ioNow(void *) { return g_now; }
+
+void ioSendDetect(void *ctx, const char *msg) {
+  Node *from = static_cast<Node *>(ctx);
+  from->tx++;
+  for (Node &n : g_nodes) {
+    if (&n == from || !n.booted) continue;   // detect.cpp drops its own echo
+    if ((int)simRand(1000) < g_lossPermille) continue;
+    n.inbox.push_back({ g_now + 1 + simRand(3), msg });
+  }
+}
+
+void ioSendStatus(void *ctx, const char *) { static_cast<Node *>(ctx)->tx++; }
+
+// Out-of-range IDs must be rejected before narrowing to uint8_t
+int checkMalformed() {
+  Node probe;
+  const Detect::Io io = { &probe, ioNow, ioSendDetect, ioSendStatus, nullptr };
+  const uint8_t mac[6] = { 0x24, 0x6F, 0x28, 0xFF, 0xFF, 0xFF };
+  probe.election.begin(io, mac, 1);
+  probe.election.onPacket("TYPE_D_LEASE:257:000000000001:60000");
+  probe.election.onPacket("TYPE_D_LEASE:4294967297:000000000001:60000");
+  probe.election.onPacket("TYPE_D_ID:258");
+  probe.election.onPacket("TYPE_D_ID:-255");
+  probe.election.onPacket("TYPE_D_ID:");
+  if (probe.election.stats().livePeers != 0) {
+    printf("FAIL out-of-range IDs were recorded as leases\n");
+    return 1;
+  }
+  probe.election.onPacket("TYPE_D_LEASE:2:000000000001:60000");
+  if (probe.election.stats().livePeers != 1) {
+    printf("FAIL a valid lease was not recorded\n");
+    return 1;
+  }
+  // A huge announced lease is capped, so the ID frees up once the holder goes quiet
+  probe.election.onPacket("TYPE_D_LEASE:3:000000000002:4294967295");
+  const uint32_t saved = g_now;
+  g_now += 16000 * 4 + 1;
+  const uint8_t live = probe.election.stats().livePeers;
+  g_now = saved;
+  if (live != 0) {
+    printf("FAIL an oversized lease outlived the lease cap\n");
+    return 1;
+  }
+  return 0;
+}
+
+void ioLog(void *ctx, const char *line) {
+  if (!g_verbose) return;
+  printf("%8u  node %2d  %s\n", (unsigned)g_now, static_cast<Node *>(ctx)->index, line);
+}
+
+void usage() {
+  fprintf(stderr, "usage: detect_sim [--nodes N] [--spread MS] [--loss PERMILLE]"
+                  " [--seed S] [--run MS] [-v]\n");
+  exit(2);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  int nodes = 4;
+  uint32_t spreadMs = 0;
+  uint32_t runMs = 60000;
+  for (int i = 1; i < argc; ++i) {
+    const char *a = argv[i];
+    auto next = [&]() -> long { if (i + 1 >= argc) usage(); return strtol(argv[++i], nullptr, 0); };
+    if (!strcmp(a, "--nodes")) nodes = (int)next();
+    else if (!strcmp(a, "--spread")) spreadMs = (uint32_t)next();
+    else if (!strcmp(a, "--loss")) g_lossPermille = (int)next();
+    else if (!strcmp(a, "--seed")) g_rng = (uint32_t)next() | 1;
+    else if (!strcmp(a, "--run")) runMs = (uint32_t)next();
+    else if (!strcmp(a, "-v")) g_verbose = true;
+    else usage();
+  }
+  // IDs 1..DETECT_ID_MAX minus the reserved EXP ID: at most 63 displays
+  if (nodes < 1 || nodes > DETECT_ID_MAX - 1) usage();
+
+  g_nodes.resize(nodes);
+  for (int i = 0; i < nodes; ++i) {
+    Node &n = g_nodes[i];
+    n.index = i;
+    // Same OUI, random NIC part: tie-breaks depend on the MAC, not the index
+    const uint8_t oui[3] = { 0x24, 0x6F, 0x28 };
+    memcpy(n.mac, oui, 3);
+    for (int b = 3; b < 6; ++b) n.mac[b] = (uint8_t)simRand(256);
+    n.mac[5] = (uint8_t)((n.mac[5] & 0xC0) | i);   // keep MACs distinct
+    n.bootAt = 1000 + (spreadMs ? simRand(spreadMs) : 0);
+  }
+
+  const uint32_t endAt = 1000 + spreadMs + runMs;
+  uint32_t lastChange = 0;
+  bool settleDirty = false;
+  for (g_now = 1; g_now <= endAt; ++g_now) {
+    for (Node &n : g_nodes) {
+      if (!n.booted && g_now >= n.bootAt) {
+        const Detect::Io io = { &n, ioNow, ioSendDetect, ioSendStatus, ioLog };
+        n.election.begin(io, n.mac, simRand(0xFFFFFFFF) | 1);
+        n.election.start();
+        n.booted = true;
+      }
+      if (!n.booted) continue;
+
+      for (int k = 0; k < 4 && !n.inbox.empty() && n.inbox.front().at <= g_now; ++k) {
+        const std::string msg = n.inbox.front().msg;
+        n.inbox.pop_front();
+        n.election.onPacket(msg.c_str());
+      }
+      n.election.step();
+
+      if (n.election.assigned() != n.lastAssigned || n.election.id() != n.lastId) {
+        n.lastAssigned = n.election.assigned();
+        n.lastId = n.election.id();
+        lastChange = g_now;
+        settleDirty = true;
+      }
+    }
+    if (settleDirty) {
+      for (Node &n : g_nodes) n.txAtSettle = n.tx;
+      settleDirty = false;
+    }
+  }
+
+  int failures = checkMalformed();
+  bool used[DETECT_ID_MAX + 1] = {false};
+  for (const Node &n : g_nodes) {
+    const uint8_t id = n.election.id();
+    if (!n.election.assigned()) {
+      printf("FAIL node %d never settled (id %u)\n", n.index, id);
+      failures++;
+    } else if (id == DETECT_ID_RESERVED) {
+      printf("FAIL node %d took the reserved ID %u\n", n.index, id);
+      failures++;
+    } else if (used[id]) {
+      printf("FAIL node %d shares ID %u\n", n.index, id);
+      failures++;
+    }
+    used[id] = true;
+  }
+
+  uint32_t electMax = 0, electSum = 0, steadySum = 0;
+  uint32_t conflicts = 0;
+  for (const Node &n : g_nodes) {
+    if (n.txAtSettle > electMax) electMax = n.txAtSettle;
+    electSum += n.txAtSettle;
+    steadySum += n.tx - n.txAtSettle;
+    conflicts += n.election.stats().conflicts;
+  }
+  const uint32_t lastBoot = 1000 + spreadMs;
+  const uint32_t steadyMs = endAt - lastChange;
+  const double steadyPerMin = steadyMs ? steadySum * 60000.0 / steadyMs / nodes : 0;
+  printf("nodes=%d spread=%ums loss=%d/1000\n", nodes, (unsigned)spreadMs, g_lossPermille);
+  printf("  converged      %u ms after the last boot window\n",
+         (unsigned)(lastChange > lastBoot ? lastChange - lastBoot : 0));
+  printf("  electing       %.1f packets/node (max %u), %u tie-breaks\n",
+         (double)electSum / nodes, (unsigned)electMax, (unsigned)conflicts);
+  printf("  steady state   %.1f packets/node/min, %.1f packets/s on the LAN\n",
+         steadyPerMin, steadyPerMin * nodes / 60.0);
+  if (endAt - lastChange < 10000) {
+    printf("FAIL IDs still changing %u ms before the end of the run\n", (unsigned)(endAt - lastChange));
+    failures++;
+  }
+  printf("%s\n", failures ? "FAILED" : "OK");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,276 @@
+// i2c_replay.cpp
+//
+// Replays a capture in the SMBusSniff::dumpCapture() format ("# N edges"
+// header, then "<us> <sda> <scl>" per line change) through I2CDecoder, the
+// same way the sniff task feeds it, and checks the decoded transactions.
+//
+// This is a synthetic round trip, not a recording: captures/xbox_smbus_synth.txt
+// is written by --synth from kExpected (100 kHz, console-side timing) and
+// covers the traffic the passive mode has to understand: STOP-only SMC byte
+// reads, a repeated-start Focus word read (LSB first), an SMC write, an EEPROM
+// block read and a NACKed Xcalibur probe. A real 'D' dump from a board can be
+// replayed the same way once kExpected is updated to match it.
+//
+//   i2c_replay captures/xbox_smbus_synth.txt                  decode + check
+//   i2c_replay --throughput 5000 captures/xbox_smbus_synth.txt
+//   i2c_replay --synth > captures/xbox_smbus_synth.txt        regenerate
+
+#include "i2c_decoder.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+enum Shape : uint8_t { STOP_ONLY, REPEATED_START, WRITE };
+
+struct Expected {
+  Shape   shape;
+  uint8_t addr;
+  uint8_t reg;
+  uint8_t len;
+  uint8_t data[8];
+};
+
+// In capture order. The NACKed probe (0x70) is counted, not reported.
+const Expected kExpected[] = {
+  { STOP_ONLY,      0x10, 0x09, 1, { 0x2D } },                     // CPU temp 45 C
+  { STOP_ONLY,      0x10, 0x0A, 1, { 0x21 } },                     // board temp 33 C
+  { REPEATED_START, 0x6A, 0x92, 2, { 0x00, 0x10 } },               // Focus VID_CNTL0, LSB first
+  { WRITE,          0x10, 0x08, 1, { 0xF0 } },                     // SMC LED sequence
+  { STOP_ONLY,      0x54, 0x40, 4, { 0x00, 0x50, 0xF2, 0x12 } },   // EEPROM MAC
+  { STOP_ONLY,      0x10, 0x10, 1, { 0x14 } },                     // fan 40%
+};
+const size_t kExpectedCount = sizeof(kExpected) / sizeof(kExpected[0]);
+const uint8_t kNackAddr = 0x70;
+const uint32_t kExpectedNacks = 1;
+
+struct Sample {
+  uint32_t us;
+  bool sda, scl;
+};
+
+// ---------- Capture file ----------
+bool loadCapture(const char *path, std::vector<Sample> &out) {
+  FILE *f = fopen(path, "r");
+  if (!f) {
+    printf("FAIL cannot open %s\n", path);
+    return false;
+  }
+  char line[64];
+  unsigned long declared = 0;
+  bool haveHeader = false;
+  while (fgets(line, sizeof(line), f)) {
+    if (line[0] == '#') {
+      if (!haveHeader) haveHeader = sscanf(line, "# %lu edges", &declared) == 1;
+      continue;
+    }
+    unsigned long us;
+    unsigned sda, scl;
+    if (sscanf(line, "%lu %u %u", &us, &sda, &scl) != 3 || sda > 1 || scl > 1) continue;
+    out.push_back({ (uint32_t)us, sda == 1, scl == 1 });
+  }
+  fclose(f);
+  if (!haveHeader || declared != out.size()) {
+    printf("FAIL %s: header says %lu edges, read %u\n", path, declared, (unsigned)out.size());
+    return false;
+  }
+  return true;
+}
+
+// ---------- Decode ----------
+struct Decoded {
+  std::vector<I2CTransaction> txns;
+};
+
+void onTxn(const I2CTransaction &t, void *ctx) {
+  static_cast<Decoded *>(ctx)->txns.push_back(t);
+}
+
+int check(const Decoded &got, const I2CDecoder::Stats &st) {
+  int failures = 0;
+  if (got.txns.size() != kExpectedCount) {
+    printf("FAIL decoded %u transactions, want %u\n", (unsigned)got.txns.size(), (unsigned)kExpectedCount);
+    failures++;
+  }
+  for (size_t i = 0; i < got.txns.size() && i < kExpectedCount; ++i) {
+    const I2CTransaction &t = got.txns[i];
+    const Expected &e = kExpected[i];
+    if (t.addr != e.addr || t.reg != e.reg || t.len != e.len || t.write != (e.shape == WRITE) ||
+        memcmp(t.data, e.data, e.len) != 0) {
+      printf("FAIL txn %u: got %02X/%02X %s len %u, want %02X/%02X %s len %u\n", (unsigned)i,
+             t.addr, t.reg, t.write ? "W" : "R", t.len, e.addr, e.reg, e.shape == WRITE ? "W" : "R", e.len);
+      failures++;
+    }
+  }
+  if (st.nacks != kExpectedNacks || st.aborted != 0) {
+    printf("FAIL nacks=%u (want %u) aborted=%u (want 0)\n",
+           (unsigned)st.nacks, (unsigned)kExpectedNacks, (unsigned)st.aborted);
+    failures++;
+  }
+  return failures;
+}
+
+int replay(const std::vector<Sample> &cap) {
+  Decoded got;
+  I2CDecoder dec(onTxn, &got);
+  for (const Sample &s : cap) dec.feed(s.sda, s.scl);
+  const int failures = check(got, dec.stats());
+
+  printf("%u edges over %u us: %u starts, %u frames, %u transactions, %u nacks, %u aborted\n",
+         (unsigned)cap.size(), (unsigned)(cap.back().us - cap.front().us),
+         (unsigned)dec.stats().starts, (unsigned)dec.stats().frames,
+         (unsigned)dec.stats().transactions, (unsigned)dec.stats().nacks,
+         (unsigned)dec.stats().aborted);
+  for (const I2CTransaction &t : got.txns) {
+    printf("  %02X %s %02X:", t.addr, t.write ? "W" : "R", t.reg);
+    for (uint8_t i = 0; i < t.len; ++i) printf(" %02X", t.data[i]);
+    printf("\n");
+  }
+  return failures;
+}
+
+// Replays the capture back to back (one decoder, like a long-running sniff
+// task) and compares the decode rate with the edge rate of the live bus.
+int throughput(const std::vector<Sample> &cap, int passes) {
+  Decoded got;
+  I2CDecoder dec(onTxn, &got);
+  got.txns.reserve(kExpectedCount * passes);
+
+  const auto t0 = std::chrono::steady_clock::now();
+  for (int p = 0; p < passes; ++p) {
+    for (const Sample &s : cap) dec.feed(s.sda, s.scl);
+  }
+  const double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+  int failures = 0;
+  if (got.txns.size() != kExpectedCount * passes || dec.stats().aborted != 0 ||
+      dec.stats().nacks != kExpectedNacks * passes) {
+    printf("FAIL %u passes: %u transactions, %u nacks, %u aborted\n", (unsigned)passes,
+           (unsigned)got.txns.size(), (unsigned)dec.stats().nacks, (unsigned)dec.stats().aborted);
+    failures++;
+  }
+
+  const double edges = (double)cap.size() * passes;
+  const double busUs = (double)(cap.back().us - cap.front().us) * passes;
+  const double edgesPerSec = sec > 0 ? edges / sec : 0;
+  // Busiest the wire gets: a 100 kHz byte stream, 3 edges per bit
+  const double liveEdgesPerSec = 300000.0;
+  printf("%d passes, %.0f edges in %.3f s: %.1f M edges/s, %.1f ns/edge, %.0fx the bus capture time,"
+         " %.0fx a saturated 100 kHz bus\n",
+         passes, edges, sec, edgesPerSec / 1e6, sec * 1e9 / edges,
+         sec > 0 ? busUs / 1e6 / sec : 0, edgesPerSec / liveEdgesPerSec);
+  if (sec > 0 && edgesPerSec < liveEdgesPerSec * 10) {
+    printf("FAIL decoder keeps up with less than 10x a saturated bus\n");
+    failures++;
+  }
+  return failures;
+}
+
+// ---------- Synthetic capture (console-side master, 100 kHz) ----------
+struct Wave {
+  std::vector<Sample> edges;
+  uint32_t us = 1000000;
+  bool sda = true, scl = true;
+
+  void set(bool d, bool c, uint32_t dt) {
+    us += dt;
+    if (d == sda && c == scl) return;
+    sda = d;
+    scl = c;
+    edges.push_back({ us, sda, scl });
+  }
+  void start() {
+    if (!scl) { set(true, false, 2); set(true, true, 3); }   // repeated START
+    set(false, true, 5);
+    set(false, false, 5);
+  }
+  void stop() {
+    set(false, false, 2);
+    set(false, true, 3);
+    set(true, true, 5);
+  }
+  void bit(bool b) {
+    set(b, false, 2);
+    set(b, true, 3);
+    set(b, false, 5);
+  }
+  void byte(uint8_t v, bool ack) {
+    for (int i = 7; i >= 0; --i) bit((v >> i) & 1);
+    bit(!ack);
+  }
+  void gap(uint32_t dt) { us += dt; }
+
+  void pointer(uint8_t addr, uint8_t reg) {
+    start();
+    byte((uint8_t)(addr << 1), true);
+    byte(reg, true);
+  }
+  void readData(uint8_t addr, const uint8_t *data, uint8_t len) {
+    start();
+    byte((uint8_t)((addr << 1) | 1), true);
+    for (uint8_t i = 0; i < len; ++i) byte(data[i], i + 1 < len);   // master NACKs the last
+    stop();
+  }
+};
+
+void synth() {
+  Wave w;
+  for (const Expected &e : kExpected) {
+    switch (e.shape) {
+      case STOP_ONLY:
+        w.pointer(e.addr, e.reg);
+        w.stop();
+        w.gap(300);
+        w.readData(e.addr, e.data, e.len);
+        break;
+      case REPEATED_START:
+        w.pointer(e.addr, e.reg);
+        w.readData(e.addr, e.data, e.len);
+        break;
+      case WRITE:
+        w.pointer(e.addr, e.reg);
+        for (uint8_t i = 0; i < e.len; ++i) w.byte(e.data[i], true);
+        w.stop();
+        break;
+    }
+    if (e.addr == 0x6A) {
+      // Console probing for an Xcalibur that is not there
+      w.gap(2000);
+      w.start();
+      w.byte((uint8_t)(kNackAddr << 1), false);
+      w.stop();
+    }
+    w.gap(2000);
+  }
+
+  printf("# %lu edges (us sda scl)\n", (unsigned long)w.edges.size());
+  for (const Sample &s : w.edges) printf("%lu %u %u\n", (unsigned long)s.us, s.sda ? 1u : 0u, s.scl ? 1u : 0u);
+}
+
+void usage() {
+  fprintf(stderr, "usage: i2c_replay [--throughput PASSES] CAPTURE | i2c_replay --synth\n");
+  exit(2);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  int passes = 0;
+  const char *path = nullptr;
+  for (int i = 1; i < argc; ++i) {
+    if (!strcmp(argv[i], "--synth")) { synth(); return 0; }
+    if (!strcmp(argv[i], "--throughput") && i + 1 < argc) passes = atoi(argv[++i]);
+    else if (argv[i][0] != '-' && !path) path = argv[i];
+    else usage();
+  }
+  if (!path) usage();
+
+  std::vector<Sample> cap;
+  if (!loadCapture(path, cap) || cap.empty()) return 1;
+  const int failures = passes > 0 ? throughput(cap, passes) : replay(cap);
+  printf("%s\n", failures ? "FAILED" : "OK");
+  return failures ? 1 : 0;
+}
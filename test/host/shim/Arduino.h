@@ -0,0 +1,86 @@
+// Arduino.h (host shim)
+//
+// Just enough of the ESP32 Arduino core to build the EXP SMBus stack on
+// Linux. Time is virtual: millis()/micros() only move when the code under
+// test waits (delay, delayMicroseconds) or the bench advances the clock, so
+// runs are deterministic and take no wall time. See host_sim.h.
+#pragma once
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+#define HIGH 1
+#define LOW  0
+#define INPUT 0x01
+#define OUTPUT 0x03
+
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+int digitalRead(uint8_t pin);
+void pinMode(uint8_t pin, uint8_t mode);
+uint32_t esp_random();
+
+#if !defined(__GLIBC__) || (__GLIBC__ == 2 && __GLIBC_MINOR__ < 38)
+// newlib has it; older glibc does not
+inline size_t strlcpy(char *dst, const char *src, size_t size) {
+  const size_t n = strlen(src);
+  if (size) {
+    const size_t c = n < size - 1 ? n : size - 1;
+    memcpy(dst, src, c);
+    dst[c] = '\0';
+  }
+  return n;
+}
+#endif
+
+class String {
+public:
+  String(const char *s = "") : s_(s ? s : "") {}
+  String(const std::string &s) : s_(s) {}
+  String &operator+=(const char *s) { s_ += s; return *this; }
+  String &operator+=(const String &s) { s_ += s.s_; return *this; }
+  friend String operator+(const String &a, const String &b) { return String(a.s_ + b.s_); }
+  friend String operator+(const String &a, const char *b) { return String(a.s_ + b); }
+  bool operator==(const String &o) const { return s_ == o.s_; }
+  unsigned int length() const { return (unsigned int)s_.size(); }
+  const char *c_str() const { return s_.c_str(); }
+
+private:
+  std::string s_;
+};
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(const char *buf, size_t len) = 0;
+  size_t printf(const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+  size_t print(const char *s) { return write(s, strlen(s)); }
+  size_t print(const String &s) { return print(s.c_str()); }
+  size_t println(const char *s = "") { return print(s) + print("\n"); }
+  size_t println(const String &s) { return println(s.c_str()); }
+};
+
+// Serial output is dropped unless HostSim::setVerbose(true)
+class HardwareSerial : public Print {
+public:
+  void begin(unsigned long) {}
+  int available() { return 0; }
+  int read() { return -1; }
+  size_t write(const char *buf, size_t len) override;
+};
+extern HardwareSerial Serial;
+
+class IPAddress {
+public:
+  IPAddress(uint8_t a = 0, uint8_t b = 0, uint8_t c = 0, uint8_t d = 0) : b_{a, b, c, d} {}
+  uint8_t operator[](int i) const { return b_[i]; }
+
+private:
+  uint8_t b_[4];
+};
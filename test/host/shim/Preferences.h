@@ -0,0 +1,22 @@
+// Preferences.h (host shim): NVS kept in memory for the life of the process
+#pragma once
+#include <Arduino.h>
+
+class Preferences {
+public:
+  bool begin(const char *name, bool readOnly = false);
+  void end() { ns_.clear(); }
+  bool remove(const char *key);
+  size_t putBytes(const char *key, const void *value, size_t len);
+  size_t getBytes(const char *key, void *buf, size_t maxLen);
+  size_t putChar(const char *key, int8_t value) { return putBytes(key, &value, 1); }
+  size_t putUChar(const char *key, uint8_t value) { return putBytes(key, &value, 1); }
+  size_t putString(const char *key, const char *value) { return putBytes(key, value, strlen(value) + 1); }
+  int8_t getChar(const char *key, int8_t defaultValue = 0);
+  uint8_t getUChar(const char *key, uint8_t defaultValue = 0);
+  String getString(const char *key, const String &defaultValue = String());
+
+private:
+  std::string ns_;
+  bool readOnly_ = false;
+};
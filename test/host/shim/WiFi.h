@@ -0,0 +1,11 @@
+// WiFi.h (host shim): the network is always up, nothing is sent
+#pragma once
+#include <Arduino.h>
+
+typedef enum { WL_IDLE_STATUS = 0, WL_CONNECTED = 3, WL_DISCONNECTED = 6 } wl_status_t;
+
+class WiFiClass {
+public:
+  wl_status_t status() { return WL_CONNECTED; }
+};
+extern WiFiClass WiFi;
@@ -0,0 +1,20 @@
+// Wire.h (host shim)
+//
+// There is no bus on the host: every transfer NACKs. Benches swap in a
+// SMBusSched::Backend (smbus_virtual.h) before any job runs.
+#pragma once
+#include <Arduino.h>
+
+class TwoWire {
+public:
+  bool begin(int, int) { return true; }
+  bool setClock(uint32_t) { return true; }
+  void setTimeOut(uint16_t) {}
+  void beginTransmission(uint8_t) {}
+  size_t write(uint8_t) { return 1; }
+  uint8_t endTransmission(bool = true) { return 2; }   // address NACK
+  uint8_t requestFrom(int, int, int) { return 0; }
+  int available() { return 0; }
+  int read() { return -1; }
+};
+extern TwoWire Wire;
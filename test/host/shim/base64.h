@@ -0,0 +1,8 @@
+// base64.h (host shim, same API as the ESP32 core)
+#pragma once
+#include <Arduino.h>
+
+class base64 {
+public:
+  static String encode(const uint8_t *data, size_t length);
+};
@@ -0,0 +1,137 @@
+// host_arduino.cpp
+//
+// Implementations behind the host shims: virtual clock, esp_random(),
+// Serial, in-memory Preferences and base64.
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include <WiFi.h>
+#include <Wire.h>
+#include <base64.h>
+#include "freertos/task.h"
+#include "host_sim.h"
+#include <map>
+#include <vector>
+
+HardwareSerial Serial;
+TwoWire Wire;
+WiFiClass WiFi;
+
+namespace {
+uint64_t g_us = 0;
+uint32_t g_rng = 0x2545F491u;
+bool g_verbose = false;
+
+typedef std::map<std::string, std::vector<uint8_t>> Namespace;
+std::map<std::string, Namespace> g_nvs;
+}
+
+// ---- HostSim ----
+namespace HostSim {
+uint64_t nowUs() { return g_us; }
+void advanceUs(uint64_t us) { g_us += us; }
+void seed(uint32_t s) { g_rng = s ? s : 0x2545F491u; }
+void setVerbose(bool on) { g_verbose = on; }
+void clearPrefs() { g_nvs.clear(); }
+}
+
+// ---- Core ----
+uint32_t millis() { return (uint32_t)(g_us / 1000); }
+uint32_t micros() { return (uint32_t)g_us; }
+void delay(uint32_t ms) { g_us += (uint64_t)ms * 1000; }
+void delayMicroseconds(uint32_t us) { g_us += us; }
+int digitalRead(uint8_t) { return HIGH; }   // pulled-up, idle lines
+void pinMode(uint8_t, uint8_t) {}
+
+uint32_t esp_random() {
+  g_rng ^= g_rng << 13;
+  g_rng ^= g_rng >> 17;
+  g_rng ^= g_rng << 5;
+  return g_rng;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t, const char *, uint32_t, void *,
+                                   UBaseType_t, TaskHandle_t *, BaseType_t) {
+  return pdFAIL;
+}
+
+void vTaskDelay(TickType_t ticks) { delay(ticks); }
+
+// ---- Serial ----
+size_t Print::printf(const char *fmt, ...) {
+  char buf[256];
+  va_list ap;
+  va_start(ap, fmt);
+  const int n = vsnprintf(buf, sizeof(buf), fmt, ap);
+  va_end(ap);
+  if (n <= 0) return 0;
+  return write(buf, (size_t)n < sizeof(buf) ? (size_t)n : sizeof(buf) - 1);
+}
+
+size_t HardwareSerial::write(const char *buf, size_t len) {
+  if (g_verbose) fwrite(buf, 1, len, stdout);
+  return len;
+}
+
+// ---- Preferences ----
+bool Preferences::begin(const char *name, bool readOnly) {
+  ns_ = name;
+  readOnly_ = readOnly;
+  return true;
+}
+
+bool Preferences::remove(const char *key) {
+  if (readOnly_) return false;
+  return g_nvs[ns_].erase(key) > 0;
+}
+
+size_t Preferences::putBytes(const char *key, const void *value, size_t len) {
+  if (readOnly_ || ns_.empty()) return 0;
+  const uint8_t *p = static_cast<const uint8_t *>(value);
+  g_nvs[ns_][key].assign(p, p + len);
+  return len;
+}
+
+size_t Preferences::getBytes(const char *key, void *buf, size_t maxLen) {
+  const auto ns = g_nvs.find(ns_);
+  if (ns == g_nvs.end()) return 0;
+  const auto it = ns->second.find(key);
+  if (it == ns->second.end() || it->second.size() > maxLen) return 0;
+  memcpy(buf, it->second.data(), it->second.size());
+  return it->second.size();
+}
+
+int8_t Preferences::getChar(const char *key, int8_t defaultValue) {
+  int8_t v;
+  return getBytes(key, &v, 1) == 1 ? v : defaultValue;
+}
+
+uint8_t Preferences::getUChar(const char *key, uint8_t defaultValue) {
+  uint8_t v;
+  return getBytes(key, &v, 1) == 1 ? v : defaultValue;
+}
+
+String Preferences::getString(const char *key, const String &defaultValue) {
+  char buf[256];
+  const size_t n = getBytes(key, buf, sizeof(buf));
+  if (n == 0 || buf[n - 1] != '\0') return defaultValue;
+  return String(buf);
+}
+
+// ---- base64 ----
+String base64::encode(const uint8_t *data, size_t length) {
+  static const char kAlphabet[] =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string out;
+  for (size_t i = 0; i < length; i += 3) {
+    const uint32_t b0 = data[i];
+    const uint32_t b1 = (i + 1 < length) ? data[i + 1] : 0;
+    const uint32_t b2 = (i + 2 < length) ? data[i + 2] : 0;
+    const uint32_t v = (b0 << 16) | (b1 << 8) | b2;
+    out += kAlphabet[(v >> 18) & 0x3F];
+    out += kAlphabet[(v >> 12) & 0x3F];
+    out += (i + 1 < length) ? kAlphabet[(v >> 6) & 0x3F] : '=';
+    out += (i + 2 < length) ? kAlphabet[v & 0x3F] : '=';
+  }
+  return String(out);
+}
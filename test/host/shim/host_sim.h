@@ -0,0 +1,14 @@
+// host_sim.h
+//
+// Controls for the host shims (virtual clock, esp_random() seed, serial echo,
+// NVS contents). Only the host benches include this.
+#pragma once
+#include <stdint.h>
+
+namespace HostSim {
+  uint64_t nowUs();
+  void advanceUs(uint64_t us);        // same as the firmware waiting that long
+  void seed(uint32_t seed);           // esp_random() sequence
+  void setVerbose(bool on);           // echo Serial to stdout
+  void clearPrefs();                  // wipe every Preferences namespace
+}
@@ -0,0 +1,23 @@
+// mbedtls/md.h (host shim)
+//
+// The HMAC-SHA1 subset eeprom_min and the virtual console use, backed by
+// OpenSSL's libcrypto so the factory-section decrypt runs for real.
+#pragma once
+#include <stddef.h>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+
+typedef enum { MBEDTLS_MD_NONE = 0, MBEDTLS_MD_SHA1 = 4 } mbedtls_md_type_t;
+typedef struct mbedtls_md_info_t { mbedtls_md_type_t type; } mbedtls_md_info_t;
+
+inline const mbedtls_md_info_t *mbedtls_md_info_from_type(mbedtls_md_type_t type) {
+  static const mbedtls_md_info_t kSha1 = { MBEDTLS_MD_SHA1 };
+  return type == MBEDTLS_MD_SHA1 ? &kSha1 : nullptr;
+}
+
+inline int mbedtls_md_hmac(const mbedtls_md_info_t *info, const unsigned char *key, size_t keylen,
+                           const unsigned char *input, size_t ilen, unsigned char *output) {
+  if (!info || info->type != MBEDTLS_MD_SHA1) return -1;
+  unsigned int outLen = 0;
+  return HMAC(EVP_sha1(), key, (int)keylen, input, ilen, output, &outLen) && outLen == 20 ? 0 : -1;
+}
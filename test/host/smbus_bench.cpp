@@ -0,0 +1,304 @@
+// smbus_bench.cpp
+//
+// Runs the EXP SMBus stack (SMBusSched, XboxSMBusPoll, SMBusExt, XboxEEPROM,
+// SMBusHealth) against the virtual console in smbus_virtual.cpp, on the host
+// shims' virtual clock. One pass mirrors the firmware: producers + service()
+// as the SMBus task does, then the loop() side (poll, one-shot EEPROM read,
+// rebroadcast, health report). UDPMux is replaced by a recorder so the test
+// can check what would have gone out.
+//
+// Faults come from the same compile-time macros as the firmware
+// (SMBUS_VIRTUAL_NACK_PERMILLE, _STUCK_EVERY_S/_STUCK_MS, _STRETCH_US); the
+// CMake file builds one binary per fault set and runs it for every profile.
+//
+// Passes when the first valid reading arrives, the extended status names the
+// right encoder/version/resolution for the profile, the EEPROM broadcast
+// carries the virtual console's serial and MAC, the factory section decrypts
+// under the profile's key revision to the sealed HDD key, the bus stays within
+// its duty budget, and the scripted fault actually showed up in the counters.
+//
+//   smbus_bench --profile 1 --run 600000 --seed 7 -v
+
+#include "eeprom_min.h"
+#include "host_sim.h"
+#include "smbus_ext.h"
+#include "smbus_health.h"
+#include "smbus_sched.h"
+#include "smbus_virtual.h"
+#include "udp_mux.h"
+#include "xbox_smbus_poll.h"
+#include <Preferences.h>
+#include <string>
+#include <vector>
+
+// Must match the firmware defaults (smbus_sched.cpp, smbus_virtual.cpp)
+#ifndef SMBUS_DUTY_PERMILLE
+#define SMBUS_DUTY_PERMILLE 10
+#endif
+#ifndef SMBUS_DUTY_BURST_US
+#define SMBUS_DUTY_BURST_US 20000
+#endif
+#ifndef SMBUS_TASK_PERIOD_MS
+#define SMBUS_TASK_PERIOD_MS 2
+#endif
+#ifndef SMBUS_VIRTUAL_NACK_PERMILLE
+#define SMBUS_VIRTUAL_NACK_PERMILLE 0
+#endif
+#ifndef SMBUS_VIRTUAL_STUCK_EVERY_S
+#define SMBUS_VIRTUAL_STUCK_EVERY_S 0
+#endif
+#ifndef SMBUS_VIRTUAL_STUCK_MS
+#define SMBUS_VIRTUAL_STUCK_MS 200
+#endif
+#ifndef SMBUS_VIRTUAL_STRETCH_US
+#define SMBUS_VIRTUAL_STRETCH_US 0
+#endif
+
+// Same as Type_D_exp.ino
+#define XBOX_BOOT_GRACE_MS 8000UL
+
+#define EXT_PORT    50505
+#define EEPROM_PORT 50506
+
+// Longest single job the duty check tolerates past the budget (Focus full probe)
+#define BENCH_JOB_SLACK_US 100000
+
+// ---------- UDPMux recorder (replaces udp_mux.cpp) ----------
+namespace {
+
+struct Datagram {
+  uint32_t at;
+  uint16_t port;
+  std::string data;
+};
+std::vector<Datagram> g_sent;
+
+} // namespace
+
+namespace UDPMux {
+bool on(uint16_t, const char *, Handler, void *) { return true; }
+bool send(uint16_t port, const void *data, size_t len, uint8_t) {
+  g_sent.push_back({ millis(), port, std::string(static_cast<const char *>(data), len) });
+  return true;
+}
+bool send(uint16_t port, const String &text, uint8_t key) {
+  return send(port, text.c_str(), text.length(), key);
+}
+void loop() {}
+Stats getStats() { return Stats{}; }
+} // namespace UDPMux
+
+namespace {
+
+struct Expect {
+  const char *name;
+  int encoder;
+  int xboxVer;
+};
+
+const Expect kExpect[3] = {
+  { "1.0 Conexant", 0x45, 1 },
+  { "1.4 Focus",    0x6A, 4 },
+  { "1.6 Xcalibur", 0x70, 6 },
+};
+
+std::string b64decode(const std::string &in) {
+  std::string out;
+  uint32_t acc = 0;
+  int bits = 0;
+  for (char c : in) {
+    int v;
+    if (c >= 'A' && c <= 'Z') v = c - 'A';
+    else if (c >= 'a' && c <= 'z') v = c - 'a' + 26;
+    else if (c >= '0' && c <= '9') v = c - '0' + 52;
+    else if (c == '+') v = 62;
+    else if (c == '/') v = 63;
+    else break;
+    acc = (acc << 6) | (uint32_t)v;
+    bits += 6;
+    if (bits >= 8) {
+      bits -= 8;
+      out += (char)((acc >> bits) & 0xFF);
+    }
+  }
+  return out;
+}
+
+void usage() {
+  fprintf(stderr, "usage: smbus_bench [--profile 0|1|2] [--run MS] [--seed S] [-v]\n");
+  exit(2);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  int profile = 0;
+  uint32_t runMs = 600000;
+  bool verbose = false;
+  for (int i = 1; i < argc; ++i) {
+    const char *a = argv[i];
+    auto next = [&]() -> long { if (i + 1 >= argc) usage(); return strtol(argv[++i], nullptr, 0); };
+    if (!strcmp(a, "--profile")) profile = (int)next();
+    else if (!strcmp(a, "--run")) runMs = (uint32_t)next();
+    else if (!strcmp(a, "--seed")) HostSim::seed((uint32_t)next());
+    else if (!strcmp(a, "-v")) verbose = true;
+    else usage();
+  }
+  if (profile < 0 || profile > 2) usage();
+  HostSim::setVerbose(verbose);
+
+  // ---- setup(), as in Type_D_exp.ino with SMBUS_VIRTUAL_XBOX=1 ----
+  XboxEEPROM::begin();
+  XboxSMBusPoll::begin();
+  SMBusSched::setBackend(SMBusVirtual::backend((SMBusVirtual::Profile)profile));
+  SMBusExt::begin();
+  const uint32_t appStart = millis();
+
+  XboxSMBusStatus status;
+  bool sawGoodPoll = false, eeSent = false;
+  uint32_t firstReadingMs = 0, allSensorsMs = 0;
+  while (millis() - appStart < runMs) {
+    // SMBus task pass
+    if ((millis() - appStart) >= XBOX_BOOT_GRACE_MS) XboxSMBusPoll::tick();
+    SMBusExt::loop();
+    SMBusSched::service();
+
+    // loop() side
+    if (XboxSMBusPoll::poll(status)) {
+      sawGoodPoll = true;
+      const uint32_t t = millis() - appStart;
+      if (!firstReadingMs && status.cpuTemp >= 0) firstReadingMs = t;
+      if (!allSensorsMs && status.cpuTemp >= 0 && status.boardTemp >= 0 && status.fanSpeed >= 0)
+        allSensorsMs = t;
+    }
+    if ((millis() - appStart) >= XBOX_BOOT_GRACE_MS && !eeSent && sawGoodPoll) {
+      XboxEEPROM::broadcastOnce();
+      eeSent = true;
+    }
+    XboxEEPROM::tick();
+    SMBusHealth::loop();
+
+    vTaskDelay(pdMS_TO_TICKS(SMBUS_TASK_PERIOD_MS));
+  }
+
+  int failures = 0;
+  const Expect &want = kExpect[profile];
+
+  // ---- Extended status: last 50505 datagram ----
+  uint32_t firstExtMs = 0;
+  SMBusExt::Status ext = {};
+  bool haveExt = false;
+  for (const Datagram &d : g_sent) {
+    if (d.port != EXT_PORT || d.data.size() != sizeof(ext)) continue;
+    if (!haveExt) firstExtMs = d.at - appStart;
+    memcpy(&ext, d.data.data(), sizeof(ext));
+    haveExt = true;
+  }
+  if (!haveExt) {
+    printf("FAIL no extended status was sent\n");
+    failures++;
+  } else if (ext.encoderType != want.encoder || ext.xboxVer != want.xboxVer ||
+             ext.videoWidth != 1280 || ext.videoHeight != 720) {
+    printf("FAIL ext status enc=0x%02X ver=%d %dx%d, want enc=0x%02X ver=%d 1280x720\n",
+           ext.encoderType, ext.xboxVer, ext.videoWidth, ext.videoHeight, want.encoder, want.xboxVer);
+    failures++;
+  }
+
+  // ---- EEPROM: RAW broadcast carries the virtual serial + MAC, no read error ----
+  uint32_t firstEeMs = 0;
+  std::string rom, hdd;
+  for (const Datagram &d : g_sent) {
+    if (d.port != EEPROM_PORT) continue;
+    if (d.data.rfind("EE:ERR", 0) == 0) {
+      printf("FAIL EEPROM read failed (%s)\n", d.data.c_str());
+      failures++;
+    } else if (d.data.rfind("EE:RAW=", 0) == 0 && rom.empty()) {
+      firstEeMs = d.at - appStart;
+      rom = b64decode(d.data.substr(7));
+    } else if (d.data.rfind("EE:HDD=", 0) == 0 && hdd.empty()) {
+      hdd = d.data.substr(7);
+    }
+  }
+  static const uint8_t kMac[6] = { 0x00, 0x50, 0xF2, 0x12, 0x34, 0x56 };
+  if (rom.size() != 256 || rom.compare(0x34, 12, "VIRTUAL00001") != 0 ||
+      memcmp(rom.data() + 0x40, kMac, sizeof(kMac)) != 0) {
+    printf("FAIL EEPROM broadcast missing or wrong (%u bytes)\n", (unsigned)rom.size());
+    failures++;
+  }
+
+  // ---- EEPROM: factory section decrypts under the profile's key revision ----
+  char wantHdd[33];
+  for (int i = 0; i < 16; ++i) snprintf(&wantHdd[i * 2], 3, "%02X", SMBusVirtual::HDD_KEY[i]);
+  Preferences ee;
+  ee.begin("xee", true);
+  const int keyRev = ee.getChar("rev", -1);
+  ee.end();
+  if (hdd != wantHdd || keyRev != profile) {
+    printf("FAIL HDD key '%s' rev %d, want '%s' rev %d\n", hdd.c_str(), keyRev, wantHdd, profile);
+    failures++;
+  }
+
+  // ---- Sensors ----
+  if (!firstReadingMs || firstReadingMs > 15000) {
+    printf("FAIL first valid reading at %u ms\n", (unsigned)firstReadingMs);
+    failures++;
+  }
+  // 1.6 board temp is corrected (~10 C lower at these temps); others read raw
+  const int spread = status.cpuTemp - status.boardTemp;
+  if (!allSensorsMs || (profile == 2 ? spread < 17 : spread > 15)) {
+    printf("FAIL sensors cpu=%d board=%d fan=%d for %s\n",
+           status.cpuTemp, status.boardTemp, status.fanSpeed, want.name);
+    failures++;
+  }
+
+  // ---- Bus budget and fault counters ----
+  const SMBusSched::Stats ss = SMBusSched::getStats();
+  const uint32_t up = ss.uptimeMs ? ss.uptimeMs : 1;
+  const uint64_t budgetUs = (uint64_t)up * SMBUS_DUTY_PERMILLE + SMBUS_DUTY_BURST_US + BENCH_JOB_SLACK_US;
+  if (ss.busyUs > budgetUs) {
+    printf("FAIL bus time %u us over the %u us duty budget\n", (unsigned)ss.busyUs, (unsigned)budgetUs);
+    failures++;
+  }
+
+  SMBusHealth::Entry entries[24];
+  uint64_t sumUs = 0;
+  const uint8_t n = SMBusHealth::snapshot(entries, 24, nullptr, &sumUs);
+  uint32_t healthErr = 0;
+  for (uint8_t i = 0; i < n; ++i) healthErr += entries[i].err;
+  const uint32_t meanUs = ss.transactions ? (uint32_t)(sumUs / ss.transactions) : 0;
+
+  if (SMBUS_VIRTUAL_NACK_PERMILLE > 0 && (ss.retries == 0 || healthErr == 0)) {
+    printf("FAIL NACKs enabled but no retries/errors were counted\n");
+    failures++;
+  }
+  if (SMBUS_VIRTUAL_STUCK_EVERY_S > 0 && (ss.busBusySkips == 0 || ss.recoveries == 0)) {
+    printf("FAIL stuck lines enabled but busy skips=%u recoveries=%u\n",
+           (unsigned)ss.busBusySkips, (unsigned)ss.recoveries);
+    failures++;
+  }
+#if SMBUS_VIRTUAL_STRETCH_US > 0
+  if (meanUs < (uint32_t)SMBUS_VIRTUAL_STRETCH_US) {
+    printf("FAIL mean transaction %u us below the %u us clock stretch\n",
+           meanUs, (unsigned)SMBUS_VIRTUAL_STRETCH_US);
+    failures++;
+  }
+#endif
+
+  printf("profile=%d (%s) nack=%d/1000 stuck=%us/%ums stretch=%uus run=%us\n",
+         profile, want.name, SMBUS_VIRTUAL_NACK_PERMILLE, (unsigned)SMBUS_VIRTUAL_STUCK_EVERY_S,
+         (unsigned)SMBUS_VIRTUAL_STUCK_MS, (unsigned)SMBUS_VIRTUAL_STRETCH_US, (unsigned)(runMs / 1000));
+  printf("  first reading  %u ms (all sensors %u ms, ext %u ms, eeprom %u ms)\n",
+         (unsigned)firstReadingMs, (unsigned)allSensorsMs, (unsigned)firstExtMs, (unsigned)firstEeMs);
+  printf("  bus            duty %.2f%%, %.1f tx/min, mean %u us, %u retries, backoff %u ms\n",
+         ss.busyUs / (up * 10.0), ss.transactions * 60000.0 / up, meanUs,
+         (unsigned)ss.retries, (unsigned)ss.backoffMs);
+  printf("  jobs           ok %u, failed %u, expired %u, busy skips %u, recoveries %u\n",
+         (unsigned)ss.jobsOk, (unsigned)ss.jobsFailed, (unsigned)ss.jobsExpired,
+         (unsigned)ss.busBusySkips, (unsigned)ss.recoveries);
+  printf("  status         cpu %d C, board %d C, fan %d%%, enc 0x%02X ver %d %dx%d\n",
+         status.cpuTemp, status.boardTemp, status.fanSpeed,
+         ext.encoderType, ext.xboxVer, ext.videoWidth, ext.videoHeight);
+  if (verbose) SMBusHealth::dump(Serial);
+  printf("%s\n", failures ? "FAILED" : "OK");
+  return failures ? 1 : 0;
+}